@@ -0,0 +1,48 @@
+#include "common/byte_stream.h"
+#include "common/state_wrapper.h"
+#include "gtest/gtest.h"
+#include <array>
+
+TEST(StateWrapper, BulkArrayMatchesPerElementLayout)
+{
+  std::array<u16, 4> values = {{0x1122, 0x3344, 0x5566, 0x7788}};
+
+  GrowableMemoryByteStream stream(nullptr, 0);
+  StateWrapper sw(&stream, StateWrapper::Mode::Write, 1);
+  sw.Do(&values);
+  ASSERT_FALSE(sw.HasError());
+  ASSERT_EQ(stream.GetSize(), sizeof(values));
+
+  ReadOnlyMemoryByteStream rstream(stream.GetMemoryPointer(), static_cast<u32>(stream.GetSize()));
+  StateWrapper rsw(&rstream, StateWrapper::Mode::Read, 1);
+  for (u16 value : values)
+  {
+    u16 read_value = 0;
+    rsw.Do(&read_value);
+    ASSERT_EQ(read_value, value);
+  }
+  ASSERT_FALSE(rsw.HasError());
+}
+
+TEST(StateWrapper, BulkRegionInPlace)
+{
+  const u8 data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ReadOnlyMemoryByteStream stream(data, sizeof(data));
+  StateWrapper sw(&stream, StateWrapper::Mode::Read, 1);
+
+  const void* region = sw.DoBulkRegionInPlace(4);
+  ASSERT_EQ(region, static_cast<const void*>(&data[0]));
+  ASSERT_EQ(stream.GetPosition(), 4u);
+
+  // Too short, nothing should be consumed.
+  ASSERT_EQ(sw.DoBulkRegionInPlace(8), nullptr);
+  ASSERT_EQ(stream.GetPosition(), 4u);
+  ASSERT_FALSE(sw.HasError());
+}
+
+TEST(StateWrapper, BulkRegionInPlaceUnavailableWhenWriting)
+{
+  GrowableMemoryByteStream stream(nullptr, 0);
+  StateWrapper sw(&stream, StateWrapper::Mode::Write, 1);
+  ASSERT_EQ(sw.DoBulkRegionInPlace(4), nullptr);
+}
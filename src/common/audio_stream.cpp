@@ -221,4 +221,7 @@ void AudioStream::EmptyBuffers()
   std::unique_lock<std::mutex> lock(m_buffer_mutex);
   m_buffer.Clear();
   m_underflow_flag.store(false);
+
+  // Release any writer which is waiting for space, since it may not be the thread emptying the buffers.
+  m_buffer_draining_cv.notify_one();
 }
@@ -17,10 +17,23 @@
 #else
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 
 Log_SetChannel(ByteStream);
 
+/// Shared by the memory streams: returns a pointer to the next count bytes and skips past them, or null if there aren't
+/// that many left.
+static const void* ReadMemoryDirect(const u8* memory, u32 size, u32* position, u32 count)
+{
+  if (count > (size - *position))
+    return nullptr;
+
+  const void* ptr = memory + *position;
+  *position += count;
+  return ptr;
+}
+
 class FileByteStream : public ByteStream
 {
 public:
@@ -255,8 +268,8 @@ protected:
 class AtomicUpdatedFileByteStream : public FileByteStream
 {
 public:
-  AtomicUpdatedFileByteStream(FILE* pFile, const char* originalFileName, const char* temporaryFileName)
-    : FileByteStream(pFile), m_committed(false), m_discarded(false), m_originalFileName(originalFileName),
+  AtomicUpdatedFileByteStream(FILE* pFile, const char* originalFileName, const char* temporaryFileName, bool sync)
+    : FileByteStream(pFile), m_committed(false), m_discarded(false), m_sync(sync), m_originalFileName(originalFileName),
       m_temporaryFileName(temporaryFileName)
   {
   }
@@ -308,6 +321,16 @@ public:
 
     fflush(m_pFile);
 
+    // make sure the data hits the disk before the rename does, otherwise a crash can leave an empty file behind
+    if (m_sync)
+    {
+#ifdef WIN32
+      _commit(_fileno(m_pFile));
+#else
+      fsync(fileno(m_pFile));
+#endif
+    }
+
 #ifdef WIN32
     // move the atomic file name to the original file name
     if (!MoveFileExW(StringUtil::UTF8StringToWideString(m_temporaryFileName).c_str(),
@@ -348,6 +371,7 @@ public:
 private:
   bool m_committed;
   bool m_discarded;
+  bool m_sync;
   std::string m_originalFileName;
   std::string m_temporaryFileName;
 };
@@ -515,6 +539,11 @@ bool MemoryByteStream::Write2(const void* pSource, u32 ByteCount, u32* pNumberOf
   return (r == ByteCount);
 }
 
+const void* MemoryByteStream::ReadDirect(u32 ByteCount)
+{
+  return ReadMemoryDirect(m_pMemory, m_iSize, &m_iPosition, ByteCount);
+}
+
 bool MemoryByteStream::SeekAbsolute(u64 Offset)
 {
   u32 Offset32 = (u32)Offset;
@@ -625,6 +654,11 @@ bool ReadOnlyMemoryByteStream::Write2(const void* pSource, u32 ByteCount, u32* p
   return false;
 }
 
+const void* ReadOnlyMemoryByteStream::ReadDirect(u32 ByteCount)
+{
+  return ReadMemoryDirect(m_pMemory, m_iSize, &m_iPosition, ByteCount);
+}
+
 bool ReadOnlyMemoryByteStream::SeekAbsolute(u64 Offset)
 {
   u32 Offset32 = (u32)Offset;
@@ -813,6 +847,11 @@ bool GrowableMemoryByteStream::Write2(const void* pSource, u32 ByteCount, u32* p
   return (r == ByteCount);
 }
 
+const void* GrowableMemoryByteStream::ReadDirect(u32 ByteCount)
+{
+  return ReadMemoryDirect(m_pMemory, m_iSize, &m_iPosition, ByteCount);
+}
+
 bool GrowableMemoryByteStream::SeekAbsolute(u64 Offset)
 {
   u32 Offset32 = (u32)Offset;
@@ -1031,7 +1070,8 @@ std::unique_ptr<ByteStream> ByteStream_OpenFileStream(const char* fileName, u32
 
     // create the stream pointer
     std::unique_ptr<AtomicUpdatedFileByteStream> pStream =
-      std::make_unique<AtomicUpdatedFileByteStream>(pTemporaryFile, fileName, temporaryFileName);
+      std::make_unique<AtomicUpdatedFileByteStream>(pTemporaryFile, fileName, temporaryFileName,
+                                                    (openMode & BYTESTREAM_OPEN_SYNC) != 0);
 
     // do we need to copy the existing file into this one?
     if (!(openMode & BYTESTREAM_OPEN_TRUNCATE))
@@ -1212,7 +1252,8 @@ std::unique_ptr<ByteStream> ByteStream_OpenFileStream(const char* fileName, u32
 
     // create the stream pointer
     std::unique_ptr<AtomicUpdatedFileByteStream> pStream =
-      std::make_unique<AtomicUpdatedFileByteStream>(pTemporaryFile, fileName, temporaryFileName);
+      std::make_unique<AtomicUpdatedFileByteStream>(pTemporaryFile, fileName, temporaryFileName,
+                                                    (openMode & BYTESTREAM_OPEN_SYNC) != 0);
 
     // do we need to copy the existing file into this one?
     if (!(openMode & BYTESTREAM_OPEN_TRUNCATE))
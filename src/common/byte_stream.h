@@ -14,6 +14,7 @@ enum BYTESTREAM_OPEN_MODE
   BYTESTREAM_OPEN_ATOMIC_UPDATE = 64, //
   BYTESTREAM_OPEN_SEEKABLE = 128,
   BYTESTREAM_OPEN_STREAMED = 256,
+  BYTESTREAM_OPEN_SYNC = 512, // atomic updates are flushed to the storage device before replacing the file
 };
 
 // interface class used by readers, writers, etc.
@@ -42,6 +43,11 @@ public:
   // write bytes to this stream, optionally returning the number of bytes written.
   virtual bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten = nullptr) = 0;
 
+  // for memory-backed streams, returns a pointer to the next ByteCount bytes and advances past them, so large regions
+  // can be consumed in place. returns nullptr without moving if the stream has no backing memory or is too short.
+  // the pointer is invalidated by any subsequent write to the stream.
+  virtual const void* ReadDirect(u32 ByteCount) { return nullptr; }
+
   // seeks to the specified position in the stream
   // if seek failed, returns false.
   virtual bool SeekAbsolute(u64 Offset) = 0;
@@ -116,6 +122,7 @@ public:
   virtual bool WriteByte(u8 SourceByte) override;
   virtual u32 Write(const void* pSource, u32 ByteCount) override;
   virtual bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
+  virtual const void* ReadDirect(u32 ByteCount) override;
   virtual bool SeekAbsolute(u64 Offset) override;
   virtual bool SeekRelative(s64 Offset) override;
   virtual bool SeekToEnd() override;
@@ -146,6 +153,7 @@ public:
   virtual bool WriteByte(u8 SourceByte) override;
   virtual u32 Write(const void* pSource, u32 ByteCount) override;
   virtual bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
+  virtual const void* ReadDirect(u32 ByteCount) override;
   virtual bool SeekAbsolute(u64 Offset) override;
   virtual bool SeekRelative(s64 Offset) override;
   virtual bool SeekToEnd() override;
@@ -181,6 +189,7 @@ public:
   virtual bool WriteByte(u8 SourceByte) override;
   virtual u32 Write(const void* pSource, u32 ByteCount) override;
   virtual bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
+  virtual const void* ReadDirect(u32 ByteCount) override;
   virtual bool SeekAbsolute(u64 Offset) override;
   virtual bool SeekRelative(s64 Offset) override;
   virtual bool SeekToEnd() override;
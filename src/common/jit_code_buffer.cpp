@@ -209,6 +209,15 @@ void JitCodeBuffer::Reset()
   }
 }
 
+void JitCodeBuffer::SetFreeCodeOffsets(u32 code_offset, u32 far_code_offset)
+{
+  Assert(code_offset <= m_code_size && far_code_offset <= m_far_code_size);
+  m_free_code_ptr = m_code_ptr + m_guard_size + code_offset;
+  m_code_used = code_offset;
+  m_free_far_code_ptr = m_far_code_ptr + far_code_offset;
+  m_far_code_used = far_code_offset;
+}
+
 void JitCodeBuffer::Align(u32 alignment, u8 padding_value)
 {
   DebugAssert(Common::IsPow2(alignment));
@@ -16,12 +16,20 @@ public:
 
   u8* GetFreeCodePointer() const { return m_free_code_ptr; }
   u32 GetFreeCodeSpace() const { return static_cast<u32>(m_code_size - m_code_used); }
+  u32 GetUsedCodeSpace() const { return m_code_used; }
+  u32 GetTotalCodeSpace() const { return m_code_size; }
   void CommitCode(u32 length);
 
   u8* GetFreeFarCodePointer() const { return m_free_far_code_ptr; }
   u32 GetFreeFarCodeSpace() const { return static_cast<u32>(m_far_code_size - m_far_code_used); }
+  u32 GetUsedFarCodeSpace() const { return m_far_code_used; }
+  u32 GetTotalFarCodeSpace() const { return m_far_code_size; }
   void CommitFarCode(u32 length);
 
+  /// Moves the free code pointers to the specified offsets into the near and far code areas.
+  /// Anything after the new positions will be overwritten, so it must no longer be referenced.
+  void SetFreeCodeOffsets(u32 code_offset, u32 far_code_offset);
+
   /// Adjusts the free code pointer to the specified alignment, padding with bytes.
   /// Assumes alignment is a power-of-two.
   void Align(u32 alignment, u8 padding_value);
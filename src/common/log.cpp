@@ -408,6 +408,11 @@ void SetFilterLevel(LOGLEVEL level)
   s_filter_level = level;
 }
 
+LOGLEVEL GetFilterLevel()
+{
+  return s_filter_level;
+}
+
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
 {
   if (level > s_filter_level)
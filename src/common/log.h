@@ -44,6 +44,9 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps = t
 // Sets global filtering level, messages below this level won't be sent to any of the logging sinks.
 void SetFilterLevel(LOGLEVEL level);
 
+// Returns the global filtering level, so callers can skip gathering data for messages which would be discarded.
+LOGLEVEL GetFilterLevel();
+
 // writes a message to the log
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message);
 void Writef(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, ...);
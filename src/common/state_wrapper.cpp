@@ -26,6 +26,25 @@ void StateWrapper::DoBytes(void* data, size_t length)
   }
 }
 
+const void* StateWrapper::DoBulkRegionInPlace(size_t length)
+{
+  if (m_mode != Mode::Read || m_error)
+    return nullptr;
+
+  return m_stream->ReadDirect(static_cast<u32>(length));
+}
+
+void StateWrapper::DoPagedRegion(void* data, size_t length)
+{
+  if (!m_paged_region_handler || m_error)
+  {
+    DoBytes(data, length);
+    return;
+  }
+
+  m_paged_region_handler->DoPagedRegion(*this, m_paged_region_count++, data, static_cast<u32>(length));
+}
+
 void StateWrapper::Do(bool* value_ptr)
 {
   if (m_mode == Mode::Read)
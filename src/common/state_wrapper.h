@@ -20,18 +20,30 @@ public:
     Write
   };
 
+  /// Receives large page-granular memory regions, so they can be stored incrementally.
+  class PagedRegionHandler
+  {
+  public:
+    virtual ~PagedRegionHandler() = default;
+    virtual void DoPagedRegion(StateWrapper& sw, u32 index, void* data, u32 size) = 0;
+  };
+
   StateWrapper(ByteStream* stream, Mode mode, u32 version);
   StateWrapper(const StateWrapper&) = delete;
   ~StateWrapper();
 
   ByteStream* GetStream() const { return m_stream; }
   bool HasError() const { return m_error; }
+  void SetError() { m_error = true; }
   bool IsReading() const { return (m_mode == Mode::Read); }
   bool IsWriting() const { return (m_mode == Mode::Write); }
   Mode GetMode() const { return m_mode; }
   void SetMode(Mode mode) { m_mode = mode; }
   u32 GetVersion() const { return m_version; }
 
+  PagedRegionHandler* GetPagedRegionHandler() const { return m_paged_region_handler; }
+  void SetPagedRegionHandler(PagedRegionHandler* handler) { m_paged_region_handler = handler; }
+
   /// Overload for integral or floating-point types. Writes bytes as-is.
   template<typename T, std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, int> = 0>
   void Do(T* value_ptr)
@@ -86,22 +98,38 @@ public:
     }
   }
 
+  /// Arrays of integral/floating-point types are written as-is, so they can go through the bulk path.
   template<typename T>
   void DoArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      Do(&values[i]);
+    if constexpr ((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_floating_point_v<T>)
+    {
+      DoBytes(values, sizeof(T) * count);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        Do(&values[i]);
+    }
   }
 
   template<typename T>
   void DoPODArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      DoPOD(&values[i]);
+    static_assert(std::is_pod_v<T>);
+    DoBytes(values, sizeof(T) * count);
   }
 
   void DoBytes(void* data, size_t length);
 
+  /// Returns a pointer to the next length bytes of the stream when reading from memory, skipping over them, so large
+  /// regions can be consumed without an intermediate copy. Returns nullptr if unavailable, in which case nothing is
+  /// consumed and the caller should fall back to DoBytes().
+  const void* DoBulkRegionInPlace(size_t length);
+
+  /// Large memory regions such as RAM. Serialized inline, unless a paged region handler has been set.
+  void DoPagedRegion(void* data, size_t length);
+
   void Do(bool* value_ptr);
   void Do(std::string* value_ptr);
   void Do(String* value_ptr);
@@ -158,11 +186,13 @@ public:
 
     if (m_mode == Mode::Read)
     {
-      T* temp = new T[size];
-      DoArray(temp, size);
       data->Clear();
-      data->PushRange(temp, size);
-      delete[] temp;
+      for (u32 i = 0; i < size; i++)
+      {
+        T temp;
+        Do(&temp);
+        data->Push(temp);
+      }
     }
     else
     {
@@ -192,5 +222,7 @@ private:
   ByteStream* m_stream;
   Mode m_mode;
   u32 m_version;
+  PagedRegionHandler* m_paged_region_handler = nullptr;
+  u32 m_paged_region_count = 0;
   bool m_error = false;
 };
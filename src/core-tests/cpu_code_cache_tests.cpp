@@ -0,0 +1,379 @@
+#include "common/file_system.h"
+#include "common/timer.h"
+#include "core/bus.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/settings.h"
+#include "core/timing_event.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+static constexpr u32 PROGRAM_BASE = UINT32_C(0x80010000);
+
+static constexpr u32 NOP = 0;
+
+/// addiu rt, rs, imm
+static constexpr u32 ADDIU(u32 rt, u32 rs, u16 imm)
+{
+  return (UINT32_C(0x09) << 26) | (rs << 21) | (rt << 16) | imm;
+}
+
+/// j target
+static constexpr u32 J(u32 target)
+{
+  return (UINT32_C(0x02) << 26) | ((target & UINT32_C(0x0FFFFFFF)) >> 2);
+}
+
+/// jal target
+static constexpr u32 JAL(u32 target)
+{
+  return (UINT32_C(0x03) << 26) | ((target & UINT32_C(0x0FFFFFFF)) >> 2);
+}
+
+/// beq rs, rt, target, for a branch at pc
+static constexpr u32 BEQ(u32 rs, u32 rt, u32 pc, u32 target)
+{
+  return (UINT32_C(0x04) << 26) | (rs << 21) | (rt << 16) | (((target - (pc + 4)) >> 2) & UINT32_C(0xFFFF));
+}
+
+/// bne rs, rt, target, for a branch at pc
+static constexpr u32 BNE(u32 rs, u32 rt, u32 pc, u32 target)
+{
+  return (UINT32_C(0x05) << 26) | (rs << 21) | (rt << 16) | (((target - (pc + 4)) >> 2) & UINT32_C(0xFFFF));
+}
+
+/// jr rs
+static constexpr u32 JR(u32 rs)
+{
+  return (rs << 21) | UINT32_C(0x08);
+}
+
+static constexpr u32 ZERO = 0;
+static constexpr u32 T0 = 8;
+static constexpr u32 RA = 31;
+
+static constexpr const char* PROFILE_FILENAME = "code_cache_test.bprf";
+
+class CodeCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_settings.cpu_execution_mode = CPUExecutionMode::CachedInterpreter;
+    g_settings.cpu_recompiler_icache = false;
+    g_settings.cpu_recompiler_compile_threshold = 0;
+    g_settings.cpu_recompiler_superblocks = false;
+    g_settings.cpu_fastmem_mode = CPUFastmemMode::Disabled;
+    g_settings.gpu_pgxp_enable = false;
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    TimingEvents::Initialize();
+    ASSERT_TRUE(Bus::Initialize());
+    CPU::Initialize();
+    CPU::Reset();
+    CPU::CodeCache::Initialize();
+  }
+
+  void TearDown() override
+  {
+    m_frame_event.reset();
+    CPU::CodeCache::Shutdown();
+    CPU::Shutdown();
+    Bus::Shutdown();
+    TimingEvents::Shutdown();
+    CPU::g_state.frame_done = false;
+    FileSystem::DeleteFile(PROFILE_FILENAME);
+  }
+
+  /// Switches execution mode, which throws away all blocks.
+  static void SetExecutionMode(CPUExecutionMode mode)
+  {
+    CPU::CodeCache::Shutdown();
+    g_settings.cpu_execution_mode = mode;
+    CPU::CodeCache::Initialize();
+  }
+
+  static void WriteCode(u32 address, std::initializer_list<u32> words)
+  {
+    for (const u32 word : words)
+    {
+      std::memcpy(&Bus::g_ram[address & Bus::RAM_MASK], &word, sizeof(word));
+      address += sizeof(word);
+    }
+  }
+
+  static void SetPC(u32 pc)
+  {
+    CPU::g_state.regs.pc = pc;
+    CPU::g_state.regs.npc = pc;
+  }
+
+  /// Ends each call to CodeCache::Execute() after the specified number of ticks, like the GPU does with vblank.
+  void SetFrameLength(TickCount ticks)
+  {
+    m_frame_event = TimingEvents::CreateTimingEvent(
+      "Frame Done", ticks, ticks, [](void*, TickCount, TickCount) { CPU::g_state.frame_done = true; }, nullptr, true);
+  }
+
+  /// Returns the address of each instruction in the block which would be compiled at pc.
+  static std::vector<u32> DecodeTrace(u32 pc)
+  {
+    CPU::CodeBlockKey key = {};
+    key.SetPC(pc);
+    CPU::CodeBlock block(key);
+    if (!CPU::CodeCache::DecodeBlock(&block))
+      return {};
+
+    std::vector<u32> pcs;
+    for (const CPU::CodeBlockInstruction& cbi : block.instructions)
+      pcs.push_back(cbi.pc);
+    return pcs;
+  }
+
+  /// Returns the addresses of the count instructions starting at pc.
+  static std::vector<u32> Contiguous(u32 pc, u32 count)
+  {
+    std::vector<u32> pcs;
+    for (u32 i = 0; i < count; i++)
+      pcs.push_back(pc + i * sizeof(u32));
+    return pcs;
+  }
+
+  static std::vector<u32> Concat(std::initializer_list<std::vector<u32>> parts)
+  {
+    std::vector<u32> pcs;
+    for (const std::vector<u32>& part : parts)
+      pcs.insert(pcs.end(), part.begin(), part.end());
+    return pcs;
+  }
+
+  std::unique_ptr<TimingEvent> m_frame_event;
+};
+
+} // namespace
+
+TEST_F(CodeCacheTest, SuperblockFollowsAlwaysTakenBranches)
+{
+  static constexpr u32 A = PROGRAM_BASE;
+  static constexpr u32 B = PROGRAM_BASE + 0x100;
+  static constexpr u32 C = PROGRAM_BASE + 0x80;
+  static constexpr u32 D = PROGRAM_BASE + 0x200;
+  static constexpr u32 E = PROGRAM_BASE + 0x300;
+  WriteCode(A, {ADDIU(T0, T0, 1), J(B), NOP});
+  WriteCode(B, {ADDIU(T0, T0, 1), BEQ(ZERO, ZERO, B + 4, C), NOP});
+  WriteCode(C, {ADDIU(T0, T0, 1), JAL(D), NOP});
+  WriteCode(D, {ADDIU(T0, T0, 1), BNE(T0, ZERO, D + 4, E), NOP});
+  WriteCode(E, {ADDIU(T0, T0, 1), JR(RA), NOP});
+
+  EXPECT_EQ(DecodeTrace(A), Contiguous(A, 3));
+
+  // Conditional branches end the block, even when they're only conditional on the register contents.
+  g_settings.cpu_recompiler_superblocks = true;
+  EXPECT_EQ(DecodeTrace(A), Concat({Contiguous(A, 3), Contiguous(B, 3), Contiguous(C, 3), Contiguous(D, 3)}));
+
+  // So do branches with a target which isn't known when compiling.
+  EXPECT_EQ(DecodeTrace(E), Contiguous(E, 3));
+}
+
+TEST_F(CodeCacheTest, SuperblockBranchLimit)
+{
+  static constexpr u32 STRIDE = 0x10;
+  for (u32 i = 0; i < 20; i++)
+    WriteCode(PROGRAM_BASE + i * STRIDE, {J(PROGRAM_BASE + (i + 1) * STRIDE), NOP});
+
+  g_settings.cpu_recompiler_superblocks = true;
+  std::vector<u32> expected;
+  for (u32 i = 0; i <= 8; i++)
+    expected = Concat({expected, Contiguous(PROGRAM_BASE + i * STRIDE, 2)});
+  EXPECT_EQ(DecodeTrace(PROGRAM_BASE), expected);
+}
+
+TEST_F(CodeCacheTest, SuperblockInstructionLimit)
+{
+  // The limit is checked at each branch, so the block can go past it by the length of the last part followed.
+  static constexpr u32 A = PROGRAM_BASE;
+  static constexpr u32 B = PROGRAM_BASE + 0x400;
+  static constexpr u32 C = PROGRAM_BASE + 0x800;
+  for (u32 i = 0; i < 200; i++)
+    WriteCode(A + i * sizeof(u32), {ADDIU(T0, T0, 1)});
+  WriteCode(A + 200 * sizeof(u32), {J(B), NOP});
+  for (u32 i = 0; i < 100; i++)
+    WriteCode(B + i * sizeof(u32), {ADDIU(T0, T0, 1)});
+  WriteCode(B + 100 * sizeof(u32), {J(C), NOP});
+  WriteCode(C, {ADDIU(T0, T0, 1), JR(RA), NOP});
+
+  g_settings.cpu_recompiler_superblocks = true;
+  EXPECT_EQ(DecodeTrace(A), Concat({Contiguous(A, 202), Contiguous(B, 102)}));
+  EXPECT_EQ(DecodeTrace(B), Concat({Contiguous(B, 102), Contiguous(C, 3)}));
+}
+
+TEST_F(CodeCacheTest, SuperblockPageSpanLimit)
+{
+  // Code pages are 4KB, and a block can touch at most four of them.
+  static constexpr u32 A = PROGRAM_BASE + 0x3000;
+  static constexpr u32 BACKWARD = PROGRAM_BASE + 0x0010;
+  static constexpr u32 FORWARD = PROGRAM_BASE + 0x3800;
+  static constexpr u32 TOO_FAR = PROGRAM_BASE + 0x4000;
+  WriteCode(A, {J(BACKWARD), NOP});
+  WriteCode(BACKWARD, {J(FORWARD), NOP});
+  WriteCode(FORWARD, {J(TOO_FAR), NOP});
+  WriteCode(TOO_FAR, {JR(RA), NOP});
+
+  g_settings.cpu_recompiler_superblocks = true;
+  EXPECT_EQ(DecodeTrace(A), Concat({Contiguous(A, 2), Contiguous(BACKWARD, 2), Contiguous(FORWARD, 2)}));
+  EXPECT_EQ(DecodeTrace(FORWARD), Concat({Contiguous(FORWARD, 2), Contiguous(TOO_FAR, 2)}));
+}
+
+TEST_F(CodeCacheTest, SuperblockDoesNotReenterLoops)
+{
+  static constexpr u32 A = PROGRAM_BASE;
+  static constexpr u32 B = PROGRAM_BASE + 0x100;
+  static constexpr u32 LOOP = PROGRAM_BASE + 0x200;
+  WriteCode(A, {ADDIU(T0, T0, 1), J(B), NOP});
+  WriteCode(B, {ADDIU(T0, T0, 1), J(A + 4), NOP});
+  WriteCode(LOOP, {ADDIU(T0, T0, 1), BEQ(ZERO, ZERO, LOOP + 4, LOOP), NOP});
+
+  g_settings.cpu_recompiler_superblocks = true;
+  EXPECT_EQ(DecodeTrace(A), Concat({Contiguous(A, 3), Contiguous(B, 3)}));
+  EXPECT_EQ(DecodeTrace(LOOP), Contiguous(LOOP, 3));
+}
+
+#ifdef WITH_RECOMPILER
+
+TEST_F(CodeCacheTest, ProfiledSuperblocksCompileAheadOfTime)
+{
+  // A loop made of a superblock which isn't contiguous in memory, and a block with a branch in the delay slot.
+  static constexpr u32 A = PROGRAM_BASE;
+  static constexpr u32 B = PROGRAM_BASE + 0x100;
+  static constexpr u32 C = PROGRAM_BASE + 0x200;
+  static constexpr u32 D = PROGRAM_BASE + 0x300;
+  WriteCode(A, {ADDIU(T0, T0, 1), J(B), NOP});
+  WriteCode(B, {ADDIU(T0, T0, 1), BNE(T0, ZERO, B + 4, C), NOP});
+  WriteCode(C, {ADDIU(T0, T0, 1), J(D), J(A)});
+  WriteCode(D, {ADDIU(T0, T0, 1)});
+
+  g_settings.cpu_recompiler_superblocks = true;
+  SetExecutionMode(CPUExecutionMode::Recompiler);
+  SetPC(A);
+  SetFrameLength(10000);
+  CPU::CodeCache::ExecuteRecompiler();
+  const u32 block_count = CPU::CodeCache::GetCodeBufferStats().live_block_count;
+  EXPECT_EQ(block_count, 2u);
+  ASSERT_TRUE(CPU::CodeCache::SaveBlockProfile(PROFILE_FILENAME));
+
+  SetExecutionMode(CPUExecutionMode::Recompiler);
+  ASSERT_EQ(CPU::CodeCache::GetCodeBufferStats().live_block_count, 0u);
+  ASSERT_TRUE(CPU::CodeCache::LoadBlockProfile(PROFILE_FILENAME));
+  ASSERT_TRUE(CPU::CodeCache::HasPendingProfiledBlocks());
+  CPU::CodeCache::CompileProfiledBlocks(UINT64_C(10000000000));
+  EXPECT_FALSE(CPU::CodeCache::HasPendingProfiledBlocks());
+  EXPECT_EQ(CPU::CodeCache::GetCodeBufferStats().live_block_count, block_count);
+
+  // Changed code is skipped. The second block follows the jump to A, so it's the only one which contains C.
+  SetExecutionMode(CPUExecutionMode::Recompiler);
+  WriteCode(C, {ADDIU(T0, T0, 2)});
+  ASSERT_TRUE(CPU::CodeCache::LoadBlockProfile(PROFILE_FILENAME));
+  CPU::CodeCache::CompileProfiledBlocks(UINT64_C(10000000000));
+  EXPECT_EQ(CPU::CodeCache::GetCodeBufferStats().live_block_count, block_count - 1);
+}
+
+#endif
+
+// Timing only, nothing is checked. Run with --gtest_also_run_disabled_tests.
+TEST(CodeCacheLookup, DISABLED_Benchmark)
+{
+  // The lookup loop the block table replaced: 20,000 blocks spread over RAM, with a hot set of 2,000 of them.
+  static constexpr u32 BLOCK_COUNT = 20000;
+  static constexpr u32 HOT_BLOCK_COUNT = 2000;
+  static constexpr u32 LOOKUP_COUNT = 50000000;
+
+  std::mt19937 rng(1234);
+  std::vector<u32> slots(CPU::FAST_MAP_RAM_SLOT_COUNT);
+  std::iota(slots.begin(), slots.end(), 0u);
+  std::shuffle(slots.begin(), slots.end(), rng);
+  slots.resize(BLOCK_COUNT);
+
+  std::vector<CPU::CodeBlock> blocks;
+  blocks.reserve(BLOCK_COUNT);
+  std::unordered_map<u32, CPU::CodeBlock*> block_map;
+  std::vector<CPU::CodeBlock*> block_table(CPU::FAST_MAP_TOTAL_SLOT_COUNT);
+  for (const u32 slot : slots)
+  {
+    CPU::CodeBlockKey key = {};
+    key.SetPC(UINT32_C(0x80000000) | (slot << 2));
+    blocks.emplace_back(key);
+    block_map.emplace(key.bits, &blocks.back());
+    block_table[slot] = &blocks.back();
+  }
+
+  std::vector<CPU::CodeBlockKey> lookups(65536);
+  for (CPU::CodeBlockKey& key : lookups)
+    key = blocks[rng() % HOT_BLOCK_COUNT].key;
+
+  u32 found = 0;
+  Common::Timer timer;
+  for (u32 i = 0; i < LOOKUP_COUNT; i++)
+  {
+    const CPU::CodeBlockKey key = lookups[i % lookups.size()];
+    const auto iter = block_map.find(key.bits);
+    found += (iter != block_map.end() && iter->second->key == key);
+  }
+  const double map_ns = timer.GetTimeNanoseconds() / LOOKUP_COUNT;
+
+  timer.Reset();
+  for (u32 i = 0; i < LOOKUP_COUNT; i++)
+  {
+    const CPU::CodeBlockKey key = lookups[i % lookups.size()];
+    const CPU::CodeBlock* block = block_table[(key.GetPC() & Bus::RAM_MASK) >> 2];
+    found += (block && block->key == key);
+  }
+  const double table_ns = timer.GetTimeNanoseconds() / LOOKUP_COUNT;
+
+  std::printf("unordered_map find: %.1f ns per lookup\ntable: %.1f ns per lookup\n(%u found)\n", map_ns, table_ns,
+              found);
+}
+
+// Timing only, nothing is checked. Run with --gtest_also_run_disabled_tests.
+TEST_F(CodeCacheTest, DISABLED_CachedInterpreterBenchmark)
+{
+  // 18,000 blocks run once to fill the cache, then a loop through the other 2,000 in a random order.
+  static constexpr u32 BLOCK_COUNT = 20000;
+  static constexpr u32 HOT_BLOCK_COUNT = 2000;
+  static constexpr u32 BLOCK_STRIDE = 16;
+  static constexpr u32 FRAME_TICKS = 33868800 / 60;
+  static constexpr u32 FRAMES = 600;
+
+  std::mt19937 rng(5678);
+  std::vector<u32> order(BLOCK_COUNT);
+  std::iota(order.begin(), order.end(), 0u);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  const auto block_address = [](u32 index) { return PROGRAM_BASE + index * BLOCK_STRIDE; };
+  const u32 cold_count = BLOCK_COUNT - HOT_BLOCK_COUNT;
+  for (u32 i = 0; i < BLOCK_COUNT; i++)
+  {
+    const u32 next = (i == (BLOCK_COUNT - 1)) ? cold_count : (i + 1);
+    WriteCode(block_address(order[i]), {ADDIU(T0, T0, 1), J(block_address(order[next])), NOP});
+  }
+
+  SetPC(block_address(order[0]));
+  SetFrameLength(FRAME_TICKS);
+
+  Common::Timer timer;
+  for (u32 frame = 0; frame < FRAMES; frame++)
+    CPU::CodeCache::Execute();
+  const double elapsed_ms = timer.GetTimeMilliseconds();
+
+  const u32 executed_blocks = CPU::g_state.regs.r[T0];
+  std::printf("%u blocks in %.2f ms, %.1f ns per block\n", executed_blocks, elapsed_ms,
+              (elapsed_ms * 1000000.0) / static_cast<double>(executed_blocks));
+}
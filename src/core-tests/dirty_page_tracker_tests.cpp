@@ -0,0 +1,265 @@
+#include "common/byte_stream.h"
+#include "common/state_wrapper.h"
+#include "core/cpu_core.h"
+#include "core/dirty_page_tracker.h"
+#include "core/dma.h"
+#include "core/gpu.h"
+#include "core/interrupt_controller.h"
+#include "core/save_state_version.h"
+#include "core/settings.h"
+#include "core/timers.h"
+#include "core/timing_event.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+static constexpr u32 PAGE_SIZE = DirtyPageTracker::TRACKING_PAGE_SIZE;
+
+/// Two regions, the second of which doesn't end on a page boundary.
+struct TestRegions
+{
+  std::vector<u8> a = std::vector<u8>(PAGE_SIZE * 8);
+  std::vector<u8> b = std::vector<u8>(PAGE_SIZE * 3 + 100);
+
+  bool operator==(const TestRegions& rhs) const { return (a == rhs.a && b == rhs.b); }
+};
+
+static void Randomize(std::vector<u8>& data, std::mt19937& rng)
+{
+  for (u8& value : data)
+    value = static_cast<u8>(rng());
+}
+
+static std::unique_ptr<GrowableMemoryByteStream> SaveRegions(DirtyPageTracker& tracker, TestRegions& regions)
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  sw.SetPagedRegionHandler(&tracker);
+  sw.DoPagedRegion(regions.a.data(), regions.a.size());
+  sw.DoPagedRegion(regions.b.data(), regions.b.size());
+  EXPECT_FALSE(sw.HasError());
+  return stream;
+}
+
+static bool LoadRegions(DirtyPageTracker& tracker, GrowableMemoryByteStream* stream, TestRegions& regions)
+{
+  stream->SeekAbsolute(0);
+  StateWrapper sw(stream, StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  sw.SetPagedRegionHandler(&tracker);
+  sw.DoPagedRegion(regions.a.data(), regions.a.size());
+  sw.DoPagedRegion(regions.b.data(), regions.b.size());
+  return !sw.HasError();
+}
+
+static u32 CountNonZeroBytes(const GrowableMemoryByteStream* stream)
+{
+  const u8* data = stream->GetMemoryPointer();
+  return static_cast<u32>(std::count_if(data, data + stream->GetPosition(), [](u8 value) { return value != 0; }));
+}
+
+/// Stands in for a hardware renderer: VRAM lives on the "device", and the GPU only sees it through a shadow copy
+/// which is refreshed by ReadVRAM() and uploaded with UpdateVRAM().
+class ShadowVRAMGPU final : public GPU
+{
+public:
+  ShadowVRAMGPU() { m_vram_ptr = m_shadow_vram.data(); }
+
+  bool IsHardwareRenderer() const override { return true; }
+
+  u16* GetDeviceVRAM() { return m_device_vram.data(); }
+  u16* GetShadowVRAM() { return m_shadow_vram.data(); }
+
+protected:
+  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override
+  {
+    for (u32 row = y; row < (y + height); row++)
+      std::copy_n(&m_device_vram[row * VRAM_WIDTH + x], width, &m_shadow_vram[row * VRAM_WIDTH + x]);
+  }
+
+  void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override
+  {
+    const u16* src = static_cast<const u16*>(data);
+    for (u32 row = y; row < (y + height); row++, src += width)
+      std::copy_n(src, width, &m_device_vram[row * VRAM_WIDTH + x]);
+  }
+
+private:
+  std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_shadow_vram{};
+  std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_device_vram{};
+};
+
+class DirtyPageTrackerGPUTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_settings.gpu_use_thread = false;
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    TimingEvents::Initialize();
+    g_interrupt_controller.Initialize();
+    g_dma.Initialize();
+    g_timers.Initialize();
+    m_gpu = std::make_unique<ShadowVRAMGPU>();
+    ASSERT_TRUE(m_gpu->Initialize(nullptr));
+    m_gpu->Reset();
+  }
+
+  void TearDown() override
+  {
+    m_gpu.reset();
+    g_timers.Shutdown();
+    g_dma.Shutdown();
+    g_interrupt_controller.Shutdown();
+    TimingEvents::Shutdown();
+  }
+
+  std::unique_ptr<GrowableMemoryByteStream> SaveGPU(DirtyPageTracker& tracker)
+  {
+    std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    sw.SetPagedRegionHandler(&tracker);
+    EXPECT_TRUE(m_gpu->DoState(sw, false));
+    return stream;
+  }
+
+  bool LoadGPU(DirtyPageTracker& tracker, GrowableMemoryByteStream* stream)
+  {
+    stream->SeekAbsolute(0);
+    StateWrapper sw(stream, StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+    sw.SetPagedRegionHandler(&tracker);
+    return m_gpu->DoState(sw, false);
+  }
+
+  std::vector<u16> GetDeviceVRAM()
+  {
+    const u16* vram = m_gpu->GetDeviceVRAM();
+    return std::vector<u16>(vram, vram + VRAM_WIDTH * VRAM_HEIGHT);
+  }
+
+  std::unique_ptr<ShadowVRAMGPU> m_gpu;
+};
+
+} // namespace
+
+TEST(DirtyPageTracker, IncrementalStatesRoundTrip)
+{
+  std::mt19937 rng(1234);
+  TestRegions regions;
+  Randomize(regions.a, rng);
+  Randomize(regions.b, rng);
+
+  DirtyPageTracker tracker;
+  auto full_stream = SaveRegions(tracker, regions);
+  EXPECT_TRUE(tracker.HasBase());
+  EXPECT_EQ(tracker.GetDirtyPageCount(), 12u);
+  EXPECT_EQ(tracker.GetTotalPageCount(), 12u);
+  const TestRegions full_regions = regions;
+
+  // Touch a byte in two pages of the first region, and the partial last page of the second.
+  tracker.SetIncremental(true);
+  regions.a[PAGE_SIZE * 2 + 17] ^= 0xFF;
+  regions.a[PAGE_SIZE * 5] ^= 0x01;
+  regions.b[PAGE_SIZE * 3 + 99] ^= 0x80;
+  auto incremental_stream = SaveRegions(tracker, regions);
+  EXPECT_EQ(tracker.GetDirtyPageCount(), 3u);
+  EXPECT_EQ(tracker.GetTotalPageCount(), 12u);
+  const TestRegions incremental_regions = regions;
+
+  // Dirty pages are stored XORed against the base, so only the changed bytes (and the page indices) are non-zero.
+  EXPECT_LT(CountNonZeroBytes(incremental_stream.get()), 16u);
+
+  // A second incremental state is still relative to the full one, not the previous incremental state.
+  regions.b[0] ^= 0x55;
+  auto second_incremental_stream = SaveRegions(tracker, regions);
+  EXPECT_EQ(tracker.GetDirtyPageCount(), 4u);
+  const TestRegions second_incremental_regions = regions;
+
+  // Incremental states don't depend on the current contents of the regions.
+  Randomize(regions.a, rng);
+  Randomize(regions.b, rng);
+  ASSERT_TRUE(LoadRegions(tracker, incremental_stream.get(), regions));
+  EXPECT_TRUE(regions == incremental_regions);
+
+  tracker.SetIncremental(false);
+  ASSERT_TRUE(LoadRegions(tracker, full_stream.get(), regions));
+  EXPECT_TRUE(regions == full_regions);
+
+  tracker.SetIncremental(true);
+  ASSERT_TRUE(LoadRegions(tracker, second_incremental_stream.get(), regions));
+  EXPECT_TRUE(regions == second_incremental_regions);
+  ASSERT_TRUE(LoadRegions(tracker, incremental_stream.get(), regions));
+  EXPECT_TRUE(regions == incremental_regions);
+}
+
+TEST(DirtyPageTracker, IncrementalStateWithoutBase)
+{
+  std::mt19937 rng(5678);
+  TestRegions regions;
+  Randomize(regions.a, rng);
+  Randomize(regions.b, rng);
+
+  // With nothing to compare against every page is stored as-is, so another tracker can load it.
+  DirtyPageTracker tracker;
+  tracker.SetIncremental(true);
+  auto stream = SaveRegions(tracker, regions);
+  EXPECT_EQ(tracker.GetDirtyPageCount(), tracker.GetTotalPageCount());
+  const TestRegions saved_regions = regions;
+
+  DirtyPageTracker other_tracker;
+  other_tracker.SetIncremental(true);
+  Randomize(regions.a, rng);
+  ASSERT_TRUE(LoadRegions(other_tracker, stream.get(), regions));
+  EXPECT_TRUE(regions == saved_regions);
+}
+
+TEST(DirtyPageTracker, IncrementalStateNeedsBase)
+{
+  std::mt19937 rng(9012);
+  TestRegions regions;
+  Randomize(regions.a, rng);
+  Randomize(regions.b, rng);
+
+  DirtyPageTracker tracker;
+  SaveRegions(tracker, regions);
+  tracker.SetIncremental(true);
+  regions.a[0] ^= 1;
+  auto stream = SaveRegions(tracker, regions);
+
+  DirtyPageTracker other_tracker;
+  other_tracker.SetIncremental(true);
+  EXPECT_FALSE(LoadRegions(other_tracker, stream.get(), regions));
+}
+
+TEST_F(DirtyPageTrackerGPUTest, HardwareRendererShadowVRAMRoundTrip)
+{
+  std::mt19937 rng(3456);
+  u16* device_vram = m_gpu->GetDeviceVRAM();
+  std::generate_n(device_vram, VRAM_WIDTH * VRAM_HEIGHT, [&rng]() { return static_cast<u16>(rng()); });
+
+  DirtyPageTracker tracker;
+  auto full_stream = SaveGPU(tracker);
+  const std::vector<u16> full_vram = GetDeviceVRAM();
+
+  // Draw over three lines on the device only, the shadow is refreshed from it when saving. Two lines fill a page.
+  tracker.SetIncremental(true);
+  std::fill_n(&device_vram[100 * VRAM_WIDTH], VRAM_WIDTH * 3, static_cast<u16>(0x1234));
+  auto incremental_stream = SaveGPU(tracker);
+  EXPECT_EQ(tracker.GetDirtyPageCount(), 2u);
+  const std::vector<u16> incremental_vram = GetDeviceVRAM();
+
+  // Loading has to upload the clean pages from the base as well, since neither copy can be trusted.
+  std::fill_n(device_vram, VRAM_WIDTH * VRAM_HEIGHT, static_cast<u16>(0));
+  std::fill_n(m_gpu->GetShadowVRAM(), VRAM_WIDTH * VRAM_HEIGHT, static_cast<u16>(0xFFFF));
+  ASSERT_TRUE(LoadGPU(tracker, incremental_stream.get()));
+  EXPECT_TRUE(GetDeviceVRAM() == incremental_vram);
+
+  tracker.SetIncremental(false);
+  ASSERT_TRUE(LoadGPU(tracker, full_stream.get()));
+  EXPECT_TRUE(GetDeviceVRAM() == full_vram);
+}
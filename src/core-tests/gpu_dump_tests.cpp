@@ -0,0 +1,246 @@
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/state_wrapper.h"
+#include "core/cpu_core.h"
+#include "core/dma.h"
+#include "core/gpu.h"
+#include "core/gpu_dump.h"
+#include "core/host_display.h"
+#include "core/interrupt_controller.h"
+#include "core/save_state_version.h"
+#include "core/settings.h"
+#include "core/timers.h"
+#include "core/timing_event.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Accepts frames from the software renderer and discards them.
+class NullHostDisplay final : public HostDisplay
+{
+public:
+  RenderAPI GetRenderAPI() const override { return RenderAPI::None; }
+  void* GetRenderDevice() const override { return nullptr; }
+  void* GetRenderContext() const override { return nullptr; }
+  bool HasRenderDevice() const override { return true; }
+  bool HasRenderSurface() const override { return false; }
+  bool CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device) override
+  {
+    return true;
+  }
+  bool InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device) override { return true; }
+  bool MakeRenderContextCurrent() override { return true; }
+  bool DoneRenderContextCurrent() override { return true; }
+  void DestroyRenderDevice() override {}
+  void DestroyRenderSurface() override {}
+  bool ChangeRenderWindow(const WindowInfo& wi) override { return true; }
+  bool SupportsFullscreen() const override { return false; }
+  bool IsFullscreen() override { return false; }
+  bool SetFullscreen(bool fullscreen, u32 width, u32 height, float refresh_rate) override { return false; }
+  bool CreateResources() override { return true; }
+  void DestroyResources() override {}
+  bool SetPostProcessingChain(const std::string_view& config) override { return false; }
+  void ResizeRenderWindow(s32 new_window_width, s32 new_window_height) override {}
+  std::unique_ptr<HostDisplayTexture> CreateTexture(u32 width, u32 height, const void* data, u32 data_stride,
+                                                    bool dynamic) override
+  {
+    return {};
+  }
+  void UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height, const void* data,
+                     u32 data_stride) override
+  {
+  }
+  bool DownloadTexture(const void* texture_handle, u32 x, u32 y, u32 width, u32 height, void* out_data,
+                       u32 out_data_stride) override
+  {
+    return false;
+  }
+  bool Render() override { return true; }
+  void SetVSync(bool enabled) override {}
+  bool SupportsDisplayPixelFormat(HostDisplayPixelFormat format) const override { return true; }
+  bool BeginSetDisplayPixels(HostDisplayPixelFormat format, u32 width, u32 height, void** out_buffer,
+                             u32* out_pitch) override
+  {
+    m_frame_buffer.resize(width * height);
+    *out_buffer = m_frame_buffer.data();
+    *out_pitch = width * sizeof(u32);
+    return true;
+  }
+  void EndSetDisplayPixels() override {}
+
+private:
+  std::vector<u32> m_frame_buffer;
+};
+
+static constexpr const char* DUMP_FILENAME = "gpu_dump_test.psxgpu";
+
+class GPUDumpTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_settings.gpu_use_thread = false;
+    g_settings.gpu_sw_render_threads = 0;
+    g_settings.runahead_frames = 0;
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    TimingEvents::Initialize();
+    g_interrupt_controller.Initialize();
+    g_dma.Initialize();
+    g_timers.Initialize();
+    g_gpu = GPU::CreateSoftwareRenderer();
+    ASSERT_TRUE(g_gpu->Initialize(&m_host_display));
+    g_gpu->Reset();
+  }
+
+  void TearDown() override
+  {
+    g_gpu.reset();
+    g_timers.Shutdown();
+    g_dma.Shutdown();
+    g_interrupt_controller.Shutdown();
+    TimingEvents::Shutdown();
+    FileSystem::DeleteFile(DUMP_FILENAME);
+
+    // Playback ends on a frame boundary, which would stop the downcount being updated in other tests.
+    CPU::g_state.frame_done = false;
+  }
+
+  static void RunTicks(TickCount ticks)
+  {
+    while (ticks > 0)
+    {
+      const TickCount slice = std::min(ticks, std::max(CPU::g_state.downcount - CPU::GetPendingTicks(), 1));
+      CPU::AddPendingTicks(slice);
+      ticks -= slice;
+      TimingEvents::RunEvents();
+    }
+  }
+
+  static void WriteGP0(std::initializer_list<u32> words)
+  {
+    for (const u32 word : words)
+      g_gpu->WriteRegister(0x00, word);
+  }
+
+  static std::vector<u16> GetVRAM()
+  {
+    const u16* vram = g_gpu->GetVRAM();
+    return std::vector<u16>(vram, vram + VRAM_WIDTH * VRAM_HEIGHT);
+  }
+
+  /// Sends a mix of fills, polygons, uploads, copies and readbacks over a couple of frames, through both GP0 and DMA.
+  static void SendCommands(u32 seed)
+  {
+    std::mt19937 rng(seed);
+    const auto random_xy = [&rng]() {
+      const u32 y = static_cast<u32>(rng()) % VRAM_HEIGHT;
+      return (y << 16) | (static_cast<u32>(rng()) % VRAM_WIDTH);
+    };
+    const auto random_color = [&rng]() { return static_cast<u32>(rng()) & 0xFFFFFFu; };
+
+    // Drawing area covering all of VRAM, and DMA to GP0.
+    WriteGP0({0xE3000000u, 0xE4000000u | (511u << 10) | 1023u, 0xE5000000u, 0xE1000600u});
+    g_gpu->WriteRegister(0x04, 0x04000002u);
+
+    for (u32 i = 0; i < 200; i++)
+    {
+      switch (rng() % 6)
+      {
+        case 0:
+          WriteGP0({0x02000000u | random_color(), random_xy() & 0xFFF0FFF0u, 0x00400040u});
+          break;
+
+        case 1:
+          WriteGP0({0x20000000u | random_color(), random_xy(), random_xy(), random_xy()});
+          break;
+
+        case 2:
+          WriteGP0({0x38000000u | random_color(), random_xy(), random_color(), random_xy(), random_color(),
+                    random_xy(), random_color(), random_xy()});
+          break;
+
+        case 3:
+        {
+          // 16x4 upload through GP0, then 16x8 with DMA.
+          WriteGP0({0xA0000000u, random_xy(), 0x00040010u});
+          for (u32 j = 0; j < 32; j++)
+            g_gpu->WriteRegister(0x00, static_cast<u32>(rng()));
+
+          WriteGP0({0xA0000000u, random_xy(), 0x00080010u});
+          if (g_gpu->BeginDMAWrite())
+          {
+            for (u32 j = 0; j < 64; j++)
+              g_gpu->DMAWrite(0, static_cast<u32>(rng()));
+            g_gpu->EndDMAWrite(64);
+          }
+        }
+        break;
+
+        case 4:
+          WriteGP0({0x80000000u, random_xy(), random_xy(), 0x00200020u});
+          break;
+
+        case 5:
+        {
+          WriteGP0({0xC0000000u, random_xy(), 0x00040008u});
+          for (u32 j = 0; j < 16; j++)
+            g_gpu->ReadRegister(0x00);
+        }
+        break;
+      }
+
+      RunTicks(static_cast<TickCount>(rng() % 10000));
+    }
+  }
+
+  NullHostDisplay m_host_display;
+};
+
+} // namespace
+
+TEST_F(GPUDumpTest, PlaybackMatchesRecording)
+{
+  // Start from something other than a cleared VRAM, so the initial state has to be restored.
+  SendCommands(1234);
+  ASSERT_TRUE(g_gpu->StartDumping(DUMP_FILENAME));
+  SendCommands(5678);
+  ASSERT_TRUE(g_gpu->StopDumping());
+  const std::vector<u16> recorded_vram = GetVRAM();
+
+  std::unique_ptr<GPUDump::Player> player = GPUDump::Player::Open(DUMP_FILENAME);
+  ASSERT_TRUE(player);
+  g_gpu->Reset();
+  ASSERT_TRUE(player->LoadInitialState());
+  ASSERT_FALSE(GetVRAM() == recorded_vram);
+
+  for (u32 frame = 0; !player->IsAtEnd(); frame++)
+  {
+    ASSERT_LT(frame, 10u);
+    ASSERT_TRUE(player->Execute());
+  }
+
+  const std::vector<u16> played_vram = GetVRAM();
+  for (u32 i = 0; i < VRAM_WIDTH * VRAM_HEIGHT; i++)
+    ASSERT_EQ(played_vram[i], recorded_vram[i]) << "x " << (i % VRAM_WIDTH) << " y " << (i / VRAM_WIDTH);
+}
+
+TEST_F(GPUDumpTest, StateLoadStopsRecording)
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+  StateWrapper save_sw(stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  ASSERT_TRUE(g_gpu->DoState(save_sw, false));
+
+  ASSERT_TRUE(g_gpu->StartDumping(DUMP_FILENAME));
+  ASSERT_TRUE(stream->SeekAbsolute(0));
+  StateWrapper load_sw(stream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  ASSERT_TRUE(g_gpu->DoState(load_sw, false));
+  EXPECT_FALSE(g_gpu->IsDumping());
+
+  g_settings.runahead_frames = 1;
+  EXPECT_FALSE(g_gpu->StartDumping(DUMP_FILENAME));
+  EXPECT_FALSE(g_gpu->IsDumping());
+}
@@ -0,0 +1,498 @@
+#include "common/timer.h"
+#include "core/gpu_sw_backend.h"
+#include "core/settings.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BackendDeleter
+{
+  void operator()(GPU_SW_Backend* backend) const
+  {
+    backend->Shutdown();
+    delete backend;
+  }
+};
+
+using BackendPointer = std::unique_ptr<GPU_SW_Backend, BackendDeleter>;
+
+static BackendPointer CreateBackend(bool use_gpu_thread, u32 render_threads)
+{
+  g_settings.gpu_use_thread = use_gpu_thread;
+  g_settings.gpu_sw_render_threads = render_threads;
+
+  BackendPointer backend(new GPU_SW_Backend());
+  EXPECT_TRUE(backend->Initialize());
+  return backend;
+}
+
+/// Generates the same command stream for every backend given the same seed.
+class CommandGenerator
+{
+public:
+  CommandGenerator(GPU_SW_Backend* backend, u32 seed) : m_backend(backend), m_rng(seed) {}
+
+  void UploadRandomVRAM()
+  {
+    static constexpr u32 ROWS_PER_UPLOAD = 64;
+    for (u32 y = 0; y < VRAM_HEIGHT; y += ROWS_PER_UPLOAD)
+    {
+      GPUBackendUpdateVRAMCommand* cmd = m_backend->NewUpdateVRAMCommand(VRAM_WIDTH * ROWS_PER_UPLOAD);
+      cmd->params.bits = 0;
+      cmd->x = 0;
+      cmd->y = static_cast<u16>(y);
+      cmd->width = VRAM_WIDTH;
+      cmd->height = ROWS_PER_UPLOAD;
+      for (u32 i = 0; i < VRAM_WIDTH * ROWS_PER_UPLOAD; i++)
+        cmd->data[i] = static_cast<u16>(m_rng());
+      m_backend->PushCommand(cmd);
+    }
+  }
+
+  void SetDrawingArea(u32 left, u32 top, u32 right, u32 bottom)
+  {
+    GPUBackendSetDrawingAreaCommand* cmd = m_backend->NewSetDrawingAreaCommand();
+    cmd->params.bits = 0;
+    cmd->new_area = Common::Rectangle<u32>(left, top, right, bottom);
+    m_area = cmd->new_area;
+    m_backend->PushCommand(cmd);
+  }
+
+  void SetRandomDrawingArea()
+  {
+    const u32 left = Random(0, VRAM_WIDTH - 1);
+    const u32 top = Random(0, VRAM_HEIGHT - 1);
+    SetDrawingArea(left, top, Random(left, VRAM_WIDTH - 1), Random(top, VRAM_HEIGHT - 1));
+  }
+
+  /// Textures and palettes are kept in the right half of VRAM and the bottom rows, away from the drawing area, like
+  /// most games do. Otherwise they can land anywhere, including in the drawing area.
+  void DrawRandomPrimitive(bool separate_textures)
+  {
+    const u32 type = Random(0, 9);
+    if (type < 6)
+      DrawRandomPolygon(separate_textures);
+    else if (type < 9)
+      DrawRandomRectangle(separate_textures);
+    else
+      DrawRandomLine();
+  }
+
+  /// Draws a rectangle which samples the pixel to the left of the one being written, so each pixel depends on the
+  /// previous one.
+  void DrawFeedbackRectangle()
+  {
+    GPUBackendDrawRectangleCommand* cmd = m_backend->NewDrawRectangleCommand();
+    FillDrawCommand(cmd, GPUPrimitive::Rectangle, false);
+    cmd->rc.texture_enable = true;
+    cmd->draw_mode.texture_mode = GPUTextureMode::Direct16Bit;
+    cmd->window = {0xFF, 0xFF, 0x00, 0x00};
+    cmd->x = static_cast<s32>(Random(m_area.left, m_area.right));
+    cmd->y = static_cast<s32>(Random(m_area.top, m_area.bottom));
+    cmd->width = static_cast<u16>(Random(1, 64));
+    cmd->height = static_cast<u16>(Random(1, 16));
+    cmd->color = m_rng() & 0xFFFFFFu;
+
+    // Texture pages start every 64 pixels horizontally and 256 lines vertically.
+    cmd->draw_mode.texture_page_x_base = static_cast<u8>(cmd->x / 64);
+    cmd->draw_mode.texture_page_y_base = static_cast<u8>(cmd->y / 256);
+    const u32 texcoord_x = static_cast<u32>(cmd->x) - cmd->draw_mode.GetTexturePageBaseX() - 1;
+    const u32 texcoord_y = static_cast<u32>(cmd->y) - cmd->draw_mode.GetTexturePageBaseY();
+    cmd->texcoord = static_cast<u16>((texcoord_x & 0xFFu) | (texcoord_y << 8));
+    m_backend->PushCommand(cmd);
+  }
+
+  /// Draws a 64x64 rectangle from a paletted texture in the top half of VRAM, with the palette at 0,480.
+  void DrawPalettedRectangle(s32 x, s32 y, GPUTextureMode mode, u32 page_x)
+  {
+    GPUBackendDrawRectangleCommand* cmd = m_backend->NewDrawRectangleCommand();
+    cmd->params.bits = 0;
+    cmd->rc.bits = 0;
+    cmd->rc.primitive = GPUPrimitive::Rectangle;
+    cmd->rc.texture_enable = true;
+    cmd->rc.raw_texture_enable = true;
+    cmd->draw_mode.bits = 0;
+    cmd->draw_mode.texture_mode = mode;
+    cmd->draw_mode.texture_page_x_base = static_cast<u8>(page_x / 64);
+    cmd->palette.bits = 0;
+    cmd->palette.y = 480;
+    cmd->window = {0xFF, 0xFF, 0x00, 0x00};
+    cmd->x = x;
+    cmd->y = y;
+    cmd->width = 64;
+    cmd->height = 64;
+    cmd->texcoord = 0;
+    cmd->color = 0;
+    m_backend->PushCommand(cmd);
+  }
+
+  void FillVRAM(u32 x, u32 y, u32 width, u32 height)
+  {
+    GPUBackendFillVRAMCommand* cmd = m_backend->NewFillVRAMCommand();
+    cmd->params.bits = 0;
+    cmd->x = static_cast<u16>(x);
+    cmd->y = static_cast<u16>(y);
+    cmd->width = static_cast<u16>(width);
+    cmd->height = static_cast<u16>(height);
+    cmd->color = m_rng();
+    m_backend->PushCommand(cmd);
+  }
+
+  void DoRandomTransfer()
+  {
+    switch (Random(0, 2))
+    {
+      case 0:
+      {
+        GPUBackendFillVRAMCommand* cmd = m_backend->NewFillVRAMCommand();
+        cmd->params.bits = static_cast<u8>(Random(0, 3));
+        cmd->x = static_cast<u16>(Random(0, VRAM_WIDTH - 1));
+        cmd->y = static_cast<u16>(Random(0, VRAM_HEIGHT - 1));
+        cmd->width = static_cast<u16>(Random(1, 128));
+        cmd->height = static_cast<u16>(Random(1, 128));
+        cmd->color = m_rng();
+        m_backend->PushCommand(cmd);
+      }
+      break;
+
+      case 1:
+      {
+        const u32 width = Random(1, 32);
+        const u32 height = Random(1, 32);
+        GPUBackendUpdateVRAMCommand* cmd = m_backend->NewUpdateVRAMCommand(width * height);
+        cmd->params.bits = static_cast<u8>(Random(0, 15) & 12u);
+        cmd->x = static_cast<u16>(Random(0, VRAM_WIDTH - 1));
+        cmd->y = static_cast<u16>(Random(0, VRAM_HEIGHT - 1));
+        cmd->width = static_cast<u16>(width);
+        cmd->height = static_cast<u16>(height);
+        for (u32 i = 0; i < width * height; i++)
+          cmd->data[i] = static_cast<u16>(m_rng());
+        m_backend->PushCommand(cmd);
+      }
+      break;
+
+      case 2:
+      {
+        GPUBackendCopyVRAMCommand* cmd = m_backend->NewCopyVRAMCommand();
+        cmd->params.bits = static_cast<u8>(Random(0, 15) & 12u);
+        cmd->src_x = static_cast<u16>(Random(0, VRAM_WIDTH - 1));
+        cmd->src_y = static_cast<u16>(Random(0, VRAM_HEIGHT - 1));
+        cmd->dst_x = static_cast<u16>(Random(0, VRAM_WIDTH - 1));
+        cmd->dst_y = static_cast<u16>(Random(0, VRAM_HEIGHT - 1));
+        cmd->width = static_cast<u16>(Random(1, 128));
+        cmd->height = static_cast<u16>(Random(1, 128));
+        m_backend->PushCommand(cmd);
+      }
+      break;
+    }
+  }
+
+private:
+  u32 Random(u32 min, u32 max) { return min + (m_rng() % (max - min + 1)); }
+
+  s32 RandomX(s32 margin)
+  {
+    return static_cast<s32>(Random(0, m_area.right - m_area.left + margin * 2)) + static_cast<s32>(m_area.left) -
+           margin;
+  }
+
+  s32 RandomY(s32 margin)
+  {
+    return static_cast<s32>(Random(0, m_area.bottom - m_area.top + margin * 2)) + static_cast<s32>(m_area.top) -
+           margin;
+  }
+
+  void FillDrawCommand(GPUBackendDrawCommand* cmd, GPUPrimitive primitive, bool separate_textures)
+  {
+    cmd->params.bits = static_cast<u8>(Random(0, 15));
+    cmd->rc.bits = m_rng() & 0x1FFFFFFFu;
+    cmd->rc.primitive = primitive;
+    cmd->draw_mode.bits = static_cast<u16>(m_rng() & 0x3FFu);
+    cmd->palette.bits = static_cast<u16>(m_rng() & GPUTexturePaletteReg::MASK);
+    if (separate_textures)
+    {
+      cmd->draw_mode.texture_page_x_base = static_cast<u8>(Random(8, 15));
+      cmd->palette.x = static_cast<u16>(Random(0, 63));
+      cmd->palette.y = static_cast<u16>(Random(480, 511));
+    }
+
+    if (Random(0, 3) == 0)
+      cmd->window = {static_cast<u8>(m_rng()), static_cast<u8>(m_rng()), static_cast<u8>(m_rng()),
+                     static_cast<u8>(m_rng())};
+    else
+      cmd->window = {0xFF, 0xFF, 0x00, 0x00};
+  }
+
+  void DrawRandomPolygon(bool separate_textures)
+  {
+    const bool quad = (Random(0, 1) != 0);
+    const u32 num_vertices = quad ? 4 : 3;
+    GPUBackendDrawPolygonCommand* cmd = m_backend->NewDrawPolygonCommand(num_vertices);
+    FillDrawCommand(cmd, GPUPrimitive::Polygon, separate_textures);
+    cmd->rc.quad_polygon = quad;
+
+    const s32 center_x = RandomX(16);
+    const s32 center_y = RandomY(16);
+    const s32 extent = static_cast<s32>(Random(1, 96));
+    for (u32 i = 0; i < num_vertices; i++)
+    {
+      GPUBackendDrawPolygonCommand::Vertex& vert = cmd->vertices[i];
+      vert.x = center_x + static_cast<s32>(Random(0, extent * 2)) - extent;
+      vert.y = center_y + static_cast<s32>(Random(0, extent * 2)) - extent;
+      vert.color = m_rng() & 0xFFFFFFu;
+      vert.texcoord = static_cast<u16>(m_rng());
+    }
+
+    m_backend->PushCommand(cmd);
+  }
+
+  void DrawRandomRectangle(bool separate_textures)
+  {
+    GPUBackendDrawRectangleCommand* cmd = m_backend->NewDrawRectangleCommand();
+    FillDrawCommand(cmd, GPUPrimitive::Rectangle, separate_textures);
+    cmd->x = RandomX(16);
+    cmd->y = RandomY(16);
+    cmd->width = static_cast<u16>(Random(1, 64));
+    cmd->height = static_cast<u16>(Random(1, 64));
+    cmd->texcoord = static_cast<u16>(m_rng());
+    cmd->color = m_rng() & 0xFFFFFFu;
+    m_backend->PushCommand(cmd);
+  }
+
+  void DrawRandomLine()
+  {
+    const u32 num_vertices = Random(2, 5);
+    GPUBackendDrawLineCommand* cmd = m_backend->NewDrawLineCommand(num_vertices);
+    FillDrawCommand(cmd, GPUPrimitive::Line, false);
+    for (u32 i = 0; i < num_vertices; i++)
+    {
+      GPUBackendDrawLineCommand::Vertex& vert = cmd->vertices[i];
+      vert.x = RandomX(16);
+      vert.y = RandomY(16);
+      vert.color = m_rng() & 0xFFFFFFu;
+    }
+
+    m_backend->PushCommand(cmd);
+  }
+
+  GPU_SW_Backend* m_backend;
+  std::mt19937 m_rng;
+  Common::Rectangle<u32> m_area{};
+};
+
+/// Draws frames of primitives into a 320x240 framebuffer. With hazards, the drawing area moves around VRAM, textures
+/// are taken from anywhere, and VRAM transfers are mixed in.
+static void DrawFrames(GPU_SW_Backend* backend, u32 seed, u32 num_frames, u32 draws_per_frame, bool hazards)
+{
+  CommandGenerator gen(backend, seed);
+  gen.UploadRandomVRAM();
+
+  for (u32 frame = 0; frame < num_frames; frame++)
+  {
+    gen.SetDrawingArea(0, 0, 319, 239);
+    for (u32 i = 0; i < draws_per_frame; i++)
+    {
+      if (hazards && (i % 64) == 0)
+        gen.SetRandomDrawingArea();
+      if (hazards && (i % 16) == 0)
+        gen.DoRandomTransfer();
+
+      if (hazards && (i % 8) == 0)
+        gen.DrawFeedbackRectangle();
+      else
+        gen.DrawRandomPrimitive(!hazards);
+    }
+
+    backend->Sync();
+  }
+}
+
+/// Draws the same textures repeatedly, writing to the texture page and palette in between.
+static void DrawReusedTextures(GPU_SW_Backend* backend)
+{
+  CommandGenerator gen(backend, 42);
+  gen.UploadRandomVRAM();
+
+  s32 y = 0;
+  for (const GPUTextureMode mode : {GPUTextureMode::Palette4Bit, GPUTextureMode::Palette8Bit})
+  {
+    gen.SetDrawingArea(0, 0, 319, 239);
+    gen.DrawPalettedRectangle(0, y, mode, 512);
+    gen.DrawPalettedRectangle(64, y, mode, 512);
+    gen.FillVRAM(520, 8, 4, 4);
+    gen.DrawPalettedRectangle(128, y, mode, 512);
+    gen.FillVRAM(4, 480, 4, 1);
+    gen.DrawPalettedRectangle(192, y, mode, 512);
+
+    // Draw over the texture page.
+    gen.SetDrawingArea(512, 0, 575, 63);
+    gen.DrawPalettedRectangle(512, 0, mode, 768);
+    gen.SetDrawingArea(0, 0, 319, 239);
+    gen.DrawPalettedRectangle(256, y, mode, 512);
+    y += 64;
+  }
+
+  backend->Sync();
+}
+
+static void ExpectVRAMEqual(const GPU_SW_Backend* expected, const GPU_SW_Backend* actual)
+{
+  const u16* expected_vram = expected->GetVRAM();
+  const u16* actual_vram = actual->GetVRAM();
+  const auto mismatch = std::mismatch(expected_vram, expected_vram + VRAM_WIDTH * VRAM_HEIGHT, actual_vram);
+  if (mismatch.first == expected_vram + VRAM_WIDTH * VRAM_HEIGHT)
+    return;
+
+  const size_t index = static_cast<size_t>(mismatch.first - expected_vram);
+  ADD_FAILURE() << "VRAM differs at " << (index % VRAM_WIDTH) << "," << (index / VRAM_WIDTH) << ": expected "
+                << *mismatch.first << ", got " << *mismatch.second;
+}
+
+class GPUSWBackendTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_saved_settings = g_settings; }
+  void TearDown() override
+  {
+    g_settings = m_saved_settings;
+    GPU_SW_Backend::SetSIMDEnabled(true);
+    GPU_SW_Backend::SetTextureCacheEnabled(true);
+  }
+
+  Settings m_saved_settings;
+};
+
+} // namespace
+
+TEST_F(GPUSWBackendTest, RenderThreadsMatchSingleThread)
+{
+  static constexpr u32 SEED = 1234;
+  static constexpr u32 FRAMES = 16;
+  static constexpr u32 DRAWS_PER_FRAME = 256;
+
+  BackendPointer reference = CreateBackend(false, 0);
+  DrawFrames(reference.get(), SEED, FRAMES, DRAWS_PER_FRAME, false);
+
+  for (const u32 render_threads : {1u, 3u, 4u})
+  {
+    for (const bool use_gpu_thread : {false, true})
+    {
+      SCOPED_TRACE(testing::Message() << render_threads << " render threads, GPU thread " << use_gpu_thread);
+      BackendPointer backend = CreateBackend(use_gpu_thread, render_threads);
+      DrawFrames(backend.get(), SEED, FRAMES, DRAWS_PER_FRAME, false);
+      ExpectVRAMEqual(reference.get(), backend.get());
+    }
+  }
+}
+
+TEST_F(GPUSWBackendTest, RenderThreadsHandleVRAMHazards)
+{
+  static constexpr u32 SEED = 5678;
+  static constexpr u32 FRAMES = 16;
+  static constexpr u32 DRAWS_PER_FRAME = 256;
+
+  BackendPointer reference = CreateBackend(false, 0);
+  DrawFrames(reference.get(), SEED, FRAMES, DRAWS_PER_FRAME, true);
+
+  for (const bool use_gpu_thread : {false, true})
+  {
+    SCOPED_TRACE(testing::Message() << "GPU thread " << use_gpu_thread);
+    BackendPointer backend = CreateBackend(use_gpu_thread, 4);
+    DrawFrames(backend.get(), SEED, FRAMES, DRAWS_PER_FRAME, true);
+    ExpectVRAMEqual(reference.get(), backend.get());
+  }
+}
+
+TEST_F(GPUSWBackendTest, SIMDMatchesScalar)
+{
+  static constexpr u32 SEED = 4321;
+  static constexpr u32 FRAMES = 16;
+  static constexpr u32 DRAWS_PER_FRAME = 256;
+
+  for (const bool hazards : {false, true})
+  {
+    SCOPED_TRACE(testing::Message() << "hazards " << hazards);
+
+    GPU_SW_Backend::SetSIMDEnabled(false);
+    BackendPointer reference = CreateBackend(false, 0);
+    DrawFrames(reference.get(), SEED, FRAMES, DRAWS_PER_FRAME, hazards);
+
+    GPU_SW_Backend::SetSIMDEnabled(true);
+    BackendPointer backend = CreateBackend(false, 0);
+    DrawFrames(backend.get(), SEED, FRAMES, DRAWS_PER_FRAME, hazards);
+    ExpectVRAMEqual(reference.get(), backend.get());
+  }
+}
+
+TEST_F(GPUSWBackendTest, TextureCacheMatchesDirectReads)
+{
+  static constexpr u32 SEED = 8765;
+  static constexpr u32 FRAMES = 16;
+  static constexpr u32 DRAWS_PER_FRAME = 256;
+
+  for (const bool hazards : {false, true})
+  {
+    SCOPED_TRACE(testing::Message() << "hazards " << hazards);
+
+    GPU_SW_Backend::SetTextureCacheEnabled(false);
+    BackendPointer reference = CreateBackend(false, 0);
+    DrawFrames(reference.get(), SEED, FRAMES, DRAWS_PER_FRAME, hazards);
+
+    GPU_SW_Backend::SetTextureCacheEnabled(true);
+    BackendPointer backend = CreateBackend(false, 4);
+    DrawFrames(backend.get(), SEED, FRAMES, DRAWS_PER_FRAME, hazards);
+    ExpectVRAMEqual(reference.get(), backend.get());
+  }
+}
+
+TEST_F(GPUSWBackendTest, TextureCacheInvalidatedByVRAMWrites)
+{
+  GPU_SW_Backend::SetTextureCacheEnabled(false);
+  BackendPointer reference = CreateBackend(false, 0);
+  DrawReusedTextures(reference.get());
+
+  GPU_SW_Backend::SetTextureCacheEnabled(true);
+  BackendPointer backend = CreateBackend(false, 0);
+  DrawReusedTextures(backend.get());
+  ExpectVRAMEqual(reference.get(), backend.get());
+
+  // Per mode, the page misses on the first draw, the other page, and after the fill and the draw over it. The palette
+  // only misses on the first draw and after its fill.
+  const GPU_SW_Backend::TextureCacheStats stats = backend->GetTextureCacheStats();
+  EXPECT_EQ(stats.page_hits, 4u);
+  EXPECT_EQ(stats.page_misses, 8u);
+  EXPECT_EQ(stats.palette_hits, 8u);
+  EXPECT_EQ(stats.palette_misses, 4u);
+
+  backend->ResetTextureCacheStats();
+  EXPECT_EQ(backend->GetTextureCacheStats().page_hits, 0u);
+}
+
+// Timing only, nothing is checked. Run with --gtest_also_run_disabled_tests.
+TEST_F(GPUSWBackendTest, DISABLED_ExecuteBenchmark)
+{
+  static constexpr u32 FRAMES = 30;
+  static constexpr u32 DRAWS_PER_FRAME = 1000;
+
+  const u32 max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+  for (const bool simd : {false, true})
+  {
+    GPU_SW_Backend::SetSIMDEnabled(simd);
+    for (u32 render_threads = 0; render_threads <= max_threads; render_threads = std::max(render_threads * 2, 2u))
+    {
+      BackendPointer backend = CreateBackend(true, render_threads);
+      Common::Timer timer;
+      DrawFrames(backend.get(), 1, FRAMES, DRAWS_PER_FRAME, false);
+      const double elapsed_ms = timer.GetTimeMilliseconds();
+
+      std::printf("SIMD %s, %u render threads: %u frames in %.2f ms, %.2f frames/second\n", simd ? "on" : "off",
+                  render_threads, FRAMES, elapsed_ms, static_cast<double>(FRAMES) / (elapsed_ms / 1000.0));
+    }
+  }
+}
@@ -0,0 +1,332 @@
+#include "core/bus.h"
+#include "core/cpu_core.h"
+#include "core/gte.h"
+#include "core/settings.h"
+#include "gtest/gtest.h"
+#include <array>
+#include <random>
+
+#ifdef WITH_RECOMPILER
+#include "common/jit_code_buffer.h"
+#include "core/cpu_recompiler_code_generator.h"
+#endif
+
+namespace {
+
+using GTERegisters = std::array<u32, 64>;
+
+static void RandomizeGTERegisters(std::mt19937& rng)
+{
+  // Mix in extreme values so the saturation and overflow paths get hit.
+  static constexpr std::array<u16, 6> extremes = {{0x0000, 0x0001, 0x7FFF, 0x8000, 0xFFFF, 0x1000}};
+  std::uniform_int_distribution<u32> dist;
+  for (u32 i = 0; i < 63; i++)
+  {
+    u32 value = dist(rng);
+    if ((dist(rng) & 3) == 0)
+      value = (value & 0xFFFF0000u) | extremes[dist(rng) % extremes.size()];
+    if ((dist(rng) & 3) == 0)
+      value = (value & 0x0000FFFFu) | (ZeroExtend32(extremes[dist(rng) % extremes.size()]) << 16);
+    CPU::g_state.gte_regs.r32[i] = value;
+  }
+
+  // FLAG is reset by every command, but make sure stale bits don't leak through.
+  CPU::g_state.gte_regs.r32[63] = dist(rng);
+}
+
+static GTERegisters SaveGTERegisters()
+{
+  GTERegisters regs;
+  std::copy(std::begin(CPU::g_state.gte_regs.r32), std::end(CPU::g_state.gte_regs.r32), regs.begin());
+  return regs;
+}
+
+static void LoadGTERegisters(const GTERegisters& regs)
+{
+  std::copy(regs.begin(), regs.end(), std::begin(CPU::g_state.gte_regs.r32));
+}
+
+static void CheckSIMDMatchesScalar(u32 gte_bits, u32 iterations)
+{
+  std::mt19937 rng(gte_bits);
+  for (u32 i = 0; i < iterations; i++)
+  {
+    RandomizeGTERegisters(rng);
+
+    // Large translation vectors take the scalar path, so keep TR/BK/FC in range for half of the iterations.
+    if (i & 1)
+    {
+      for (u32 reg : {37, 38, 39, 45, 46, 47, 53, 54, 55})
+      {
+        const s32 value = static_cast<s32>(CPU::g_state.gte_regs.r32[reg]);
+        CPU::g_state.gte_regs.r32[reg] = static_cast<u32>(value >> (2 + (rng() % 16)));
+      }
+    }
+
+    const GTERegisters input = SaveGTERegisters();
+
+    GTE::SetSIMDEnabled(false);
+    GTE::ExecuteInstruction(gte_bits);
+    const GTERegisters expected = SaveGTERegisters();
+
+    LoadGTERegisters(input);
+    GTE::SetSIMDEnabled(true);
+    GTE::ExecuteInstruction(gte_bits);
+    const GTERegisters actual = SaveGTERegisters();
+
+    for (u32 reg = 0; reg < 64; reg++)
+    {
+      ASSERT_EQ(actual[reg], expected[reg])
+        << "command 0x" << std::hex << gte_bits << " register " << std::dec << reg << " iteration " << i;
+    }
+  }
+}
+
+} // namespace
+
+TEST(GTESIMD, LightingCommandsMatchScalar)
+{
+  if (!GTE::IsSIMDSupported())
+    GTEST_SKIP();
+
+  // RTPS, DPCS, INTPL, NCDS, CDP, NCDT, NCCS, CC, NCS, NCT, DCPL, DPCT, RTPT, NCCT
+  static constexpr u32 commands[] = {0x01, 0x10, 0x11, 0x13, 0x14, 0x16, 0x1B, 0x1C,
+                                     0x1E, 0x20, 0x29, 0x2A, 0x30, 0x3F};
+  for (const u32 command : commands)
+  {
+    for (u32 sf = 0; sf < 2; sf++)
+    {
+      for (u32 lm = 0; lm < 2; lm++)
+        CheckSIMDMatchesScalar(command | (sf << 19) | (lm << 10), 2000);
+    }
+  }
+}
+
+TEST(GTESIMD, MVMVAMatchesScalar)
+{
+  if (!GTE::IsSIMDSupported())
+    GTEST_SKIP();
+
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 mx = 0; mx < 4; mx++)
+    {
+      for (u32 v = 0; v < 4; v++)
+      {
+        for (u32 cv = 0; cv < 4; cv++)
+        {
+          for (u32 lm = 0; lm < 2; lm++)
+            CheckSIMDMatchesScalar(0x0000012 | (sf << 19) | (mx << 17) | (v << 15) | (cv << 13) | (lm << 10), 250);
+        }
+      }
+    }
+  }
+}
+
+#ifdef WITH_RECOMPILER
+
+class RecompilerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { ASSERT_TRUE(m_code_buffer.Allocate(1024 * 1024, 1024 * 1024)); }
+
+  CPU::CodeCache::SingleBlockDispatcherFunction GetDispatcher()
+  {
+    if (!m_dispatcher)
+    {
+      CPU::Recompiler::CodeGenerator cg(&m_code_buffer);
+      m_dispatcher = cg.CompileSingleBlockDispatcher();
+    }
+    return m_dispatcher;
+  }
+
+  /// Compiles straight-line code, without any branches.
+  CPU::CodeBlock::HostCodePointer CompileBlock(std::initializer_list<u32> words, bool user_mode = false)
+  {
+    CPU::CodeBlockKey key = {};
+    key.SetPC(UINT32_C(0x80010000));
+    key.user_mode = user_mode;
+    CPU::CodeBlock block(key);
+
+    u32 pc = key.GetPC();
+    for (const u32 word : words)
+    {
+      CPU::CodeBlockInstruction cbi = {};
+      cbi.instruction.bits = word;
+      cbi.pc = pc;
+      cbi.is_load_instruction = CPU::IsMemoryLoadInstruction(cbi.instruction);
+      cbi.is_store_instruction = CPU::IsMemoryStoreInstruction(cbi.instruction);
+      cbi.has_load_delay = CPU::InstructionHasLoadDelay(cbi.instruction);
+      cbi.can_trap = CPU::CanInstructionTrap(cbi.instruction, user_mode);
+      block.instructions.push_back(cbi);
+      block.contains_loadstore_instructions |= (cbi.is_load_instruction || cbi.is_store_instruction);
+      pc += sizeof(u32);
+    }
+    block.instructions.back().is_last_instruction = true;
+
+    CPU::CodeBlock::HostCodePointer host_code = nullptr;
+    u32 host_code_size = 0;
+    CPU::Recompiler::CodeGenerator cg(&m_code_buffer);
+    if (!cg.CompileBlock(&block, &host_code, &host_code_size))
+      return nullptr;
+
+    return host_code;
+  }
+
+  JitCodeBuffer m_code_buffer;
+  CPU::CodeCache::SingleBlockDispatcherFunction m_dispatcher = nullptr;
+};
+
+class GTERecompilerTest : public RecompilerTest
+{
+protected:
+  CPU::CodeBlock::HostCodePointer CompileGTEInstruction(u32 gte_bits)
+  {
+    return CompileBlock({(UINT32_C(0x12) << 26) | (UINT32_C(1) << 25) | (gte_bits & UINT32_C(0x01FFFFFF))});
+  }
+
+  using AdjustRegistersFunction = void (*)(std::mt19937& rng, u32 iteration);
+
+  void CheckCommand(u32 gte_bits, u32 iterations = 2000, AdjustRegistersFunction adjust_registers = nullptr)
+  {
+    const CPU::CodeBlock::HostCodePointer host_code = CompileGTEInstruction(gte_bits);
+    ASSERT_NE(host_code, nullptr);
+
+    const CPU::CodeCache::SingleBlockDispatcherFunction dispatcher = GetDispatcher();
+    std::mt19937 rng(gte_bits);
+    for (u32 i = 0; i < iterations; i++)
+    {
+      RandomizeGTERegisters(rng);
+      if (adjust_registers)
+        adjust_registers(rng, i);
+
+      const GTERegisters input = SaveGTERegisters();
+
+      GTE::ExecuteInstruction(gte_bits);
+      const GTERegisters expected = SaveGTERegisters();
+
+      LoadGTERegisters(input);
+      dispatcher(host_code);
+      const GTERegisters actual = SaveGTERegisters();
+
+      for (u32 reg = 0; reg < 64; reg++)
+      {
+        ASSERT_EQ(actual[reg], expected[reg])
+          << "command 0x" << std::hex << gte_bits << " register " << std::dec << reg << " iteration " << i;
+      }
+    }
+  }
+};
+
+TEST_F(GTERecompilerTest, NCLIP)
+{
+  CheckCommand(0x0000006);
+}
+
+TEST_F(GTERecompilerTest, AVSZ)
+{
+  CheckCommand(0x000002D);
+  CheckCommand(0x000002E);
+  CheckCommand(0x008002D);
+  CheckCommand(0x008002E);
+}
+
+TEST_F(GTERecompilerTest, SQR)
+{
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 lm = 0; lm < 2; lm++)
+      CheckCommand(0x0000028 | (sf << 19) | (lm << 10));
+  }
+}
+
+TEST_F(GTERecompilerTest, MVMVA)
+{
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 mx = 0; mx < 4; mx++)
+    {
+      for (u32 v = 0; v < 4; v++)
+      {
+        for (u32 cv = 0; cv < 4; cv++)
+        {
+          for (u32 lm = 0; lm < 2; lm++)
+            CheckCommand(0x0000012 | (sf << 19) | (mx << 17) | (v << 15) | (cv << 13) | (lm << 10), 250);
+        }
+      }
+    }
+  }
+}
+
+static void AdjustRTPSRegisters(std::mt19937& rng, u32 iteration)
+{
+  // Random registers almost always overflow the division, so for most iterations zero the third row of RT so SZ3
+  // comes straight from TRZ, and keep TRZ and H in a range where they can be divided.
+  if ((iteration % 4) == 0)
+    return;
+
+  CPU::g_state.gte_regs.r32[35] = 0;
+  CPU::g_state.gte_regs.r32[36] &= UINT32_C(0xFFFF0000);
+  CPU::g_state.gte_regs.r32[39] = rng() % 0x10000;
+  CPU::g_state.gte_regs.r32[58] = rng() % 0x10000;
+}
+
+TEST_F(GTERecompilerTest, RTPS)
+{
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 lm = 0; lm < 2; lm++)
+    {
+      CheckCommand(0x0000001 | (sf << 19) | (lm << 10), 4000, AdjustRTPSRegisters);
+      CheckCommand(0x0000030 | (sf << 19) | (lm << 10), 4000, AdjustRTPSRegisters);
+    }
+  }
+}
+
+TEST_F(GTERecompilerTest, NCDS)
+{
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 lm = 0; lm < 2; lm++)
+    {
+      CheckCommand(0x0000013 | (sf << 19) | (lm << 10));
+      CheckCommand(0x0000016 | (sf << 19) | (lm << 10));
+    }
+  }
+}
+
+TEST_F(RecompilerTest, FallbackSeesClearedCurrentInstructionFlags)
+{
+  // The interpreter leaves the flags set after running a delay slot, and the block doesn't know what ran before it.
+  // mfc0 of a register without a native path is interpreted, and raises an exception in user mode without CU0.
+  static constexpr u32 ADDIU_T0 = (UINT32_C(0x09) << 26) | (UINT32_C(8) << 21) | (UINT32_C(8) << 16) | 1;
+  static constexpr u32 MFC0_T1_R1 = (UINT32_C(0x10) << 26) | (UINT32_C(9) << 16) | (UINT32_C(1) << 11);
+  const bool old_memory_exceptions = g_settings.cpu_recompiler_memory_exceptions;
+  g_settings.cpu_recompiler_memory_exceptions = false;
+  const CPU::CodeBlock::HostCodePointer host_code = CompileBlock({MFC0_T1_R1, ADDIU_T0}, true);
+  g_settings.cpu_recompiler_memory_exceptions = old_memory_exceptions;
+  ASSERT_NE(host_code, nullptr);
+
+  // Raising the exception fetches the first instruction of the handler.
+  ASSERT_TRUE(Bus::Initialize());
+  CPU::g_state.regs.pc = UINT32_C(0x80010000);
+  CPU::g_state.regs.npc = UINT32_C(0x80010004);
+  CPU::g_state.current_instruction_pc = UINT32_C(0x80010000);
+  CPU::g_state.load_delay_reg = CPU::Reg::count;
+  CPU::g_state.next_load_delay_reg = CPU::Reg::count;
+  CPU::g_state.cop0_regs.sr.bits = 0;
+  CPU::g_state.cop0_regs.sr.KUc = true;
+  CPU::g_state.cop0_regs.cause.bits = 0;
+  CPU::g_state.current_instruction_in_branch_delay_slot = true;
+  CPU::g_state.current_instruction_was_branch_taken = true;
+  CPU::g_state.branch_was_taken = false;
+  GetDispatcher()(host_code);
+
+  EXPECT_EQ(CPU::g_state.cop0_regs.cause.Excode, CPU::Exception::CpU);
+  EXPECT_FALSE(CPU::g_state.cop0_regs.cause.BD);
+  EXPECT_FALSE(CPU::g_state.cop0_regs.cause.BT);
+  EXPECT_EQ(CPU::g_state.cop0_regs.EPC, UINT32_C(0x80010000));
+  Bus::Shutdown();
+}
+
+#endif
@@ -0,0 +1,364 @@
+#include "common/audio_stream.h"
+#include "common/byte_stream.h"
+#include "common/state_wrapper.h"
+#include "common/timer.h"
+#include "core/cpu_core.h"
+#include "core/host_interface.h"
+#include "core/save_state_version.h"
+#include "core/settings.h"
+#include "core/spu.h"
+#include "core/timing_event.h"
+#include "gtest/gtest.h"
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// A register write, after advancing the given number of CPU ticks. Offsets are relative to the SPU base. ENDX is
+/// read-only, so entries for it are replayed as reads instead, which games poll anyway.
+struct SPURegisterWrite
+{
+  TickCount delay;
+  u16 offset;
+  u16 value;
+};
+
+using SPURegisterTrace = std::vector<SPURegisterWrite>;
+
+class RecordingAudioStream final : public AudioStream
+{
+public:
+  std::vector<s16> frames;
+  bool recording = false;
+
+protected:
+  bool OpenDevice() override { return true; }
+  void PauseDevice(bool paused) override {}
+  void CloseDevice() override {}
+  void FramesAvailable() override
+  {
+    const u32 num_frames = GetSamplesAvailable();
+    const size_t start = frames.size();
+    frames.resize(start + num_frames * 2);
+    ReadFrames(&frames[start], num_frames, false);
+    if (!recording)
+      frames.clear();
+  }
+};
+
+class TestHostInterface final : public HostInterface
+{
+public:
+  TestHostInterface()
+  {
+    m_audio_stream = std::make_unique<RecordingAudioStream>();
+    m_audio_stream->Reconfigure(AUDIO_SAMPLE_RATE, AUDIO_CHANNELS, DEFAULT_AUDIO_BUFFER_SIZE);
+    m_audio_stream->SetSync(false);
+  }
+
+  ~TestHostInterface() override { m_audio_stream.reset(); }
+
+  RecordingAudioStream* GetRecordingStream() const { return static_cast<RecordingAudioStream*>(m_audio_stream.get()); }
+
+  std::string GetStringSettingValue(const char* section, const char* key, const char* default_value = "") override
+  {
+    return default_value;
+  }
+  std::unique_ptr<ByteStream> OpenPackageFile(const char* path, u32 flags) override { return {}; }
+  bool AcquireHostDisplay() override { return false; }
+  void ReleaseHostDisplay() override {}
+  std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend) override { return {}; }
+  void LoadSettings() override {}
+};
+
+static constexpr u16 SPURegister(u32 address)
+{
+  return static_cast<u16>(address - 0x1F801C00);
+}
+
+static constexpr TickCount TICKS_PER_VIDEO_FRAME = 33868800 / 60;
+static constexpr u32 NUM_INSTRUMENTS = 8;
+static constexpr u32 BLOCKS_PER_INSTRUMENT = 32;
+static constexpr u16 SAMPLE_BASE_ADDRESS = 0x200; // in 8-byte units
+
+/// Builds a trace which looks like a game's sequencer: sample data is uploaded, reverb is set up, then voices are keyed
+/// on and off with varying pitch, volume and envelopes every video frame.
+static SPURegisterTrace BuildSequencerTrace(u32 seed, u32 seconds)
+{
+  std::mt19937 rng(seed);
+  SPURegisterTrace trace;
+
+  // Upload the instruments through the manual transfer FIFO, letting it drain every 32 halfwords.
+  trace.push_back({0, SPURegister(0x1F801DAA), 0xC010});
+  trace.push_back({0, SPURegister(0x1F801DA6), SAMPLE_BASE_ADDRESS});
+  u32 halfwords_written = 0;
+  for (u32 instrument = 0; instrument < NUM_INSTRUMENTS; instrument++)
+  {
+    for (u32 block = 0; block < BLOCKS_PER_INSTRUMENT; block++)
+    {
+      const u8 filter = static_cast<u8>(rng() % 5);
+      const u8 shift = static_cast<u8>(rng() % 13);
+      const u8 flags = (block == 0) ? 0x04 : ((block == BLOCKS_PER_INSTRUMENT - 1) ? 0x03 : 0x00);
+      trace.push_back({0, SPURegister(0x1F801DA8), static_cast<u16>((filter << 4) | shift | (flags << 8))});
+      for (u32 i = 0; i < 7; i++)
+        trace.push_back({0, SPURegister(0x1F801DA8), static_cast<u16>(rng())});
+
+      halfwords_written += 8;
+      if ((halfwords_written % 32) == 0)
+        trace.push_back({32 * 40, SPURegister(0x1F801D9C), 0});
+    }
+  }
+
+  // "Room" reverb preset.
+  static constexpr std::array<u16, 32> reverb_room = {
+    {0x007D, 0x005B, 0x6D80, 0x54B8, 0xBED0, 0x0000, 0x0000, 0xBA80, 0x5800, 0x5300, 0x04D6,
+     0x0333, 0x03F0, 0x0227, 0x0374, 0x01EF, 0x0334, 0x01B5, 0x0000, 0x0000, 0x0000, 0x0000,
+     0x0000, 0x0000, 0x0000, 0x0000, 0x01B4, 0x0136, 0x00B8, 0x005C, 0x8000, 0x8000}};
+  trace.push_back({0, SPURegister(0x1F801DAA), 0xC080});
+  trace.push_back({0, SPURegister(0x1F801DA2), 0xFB28});
+  for (u32 i = 0; i < reverb_room.size(); i++)
+    trace.push_back({0, static_cast<u16>(SPURegister(0x1F801DC0) + i * 2), reverb_room[i]});
+  trace.push_back({0, SPURegister(0x1F801D80), 0x3FFF});
+  trace.push_back({0, SPURegister(0x1F801D82), 0x3FFF});
+  trace.push_back({0, SPURegister(0x1F801D84), 0x2000});
+  trace.push_back({0, SPURegister(0x1F801D86), 0x2000});
+  trace.push_back({0, SPURegister(0x1F801D98), 0xFFFF});
+  trace.push_back({0, SPURegister(0x1F801D9A), 0x00FF});
+
+  for (u32 frame = 0; frame < seconds * 60; frame++)
+  {
+    u32 key_on = 0;
+    u32 key_off = 0;
+    for (u32 voice = 0; voice < 24; voice++)
+    {
+      const u32 event = rng() % 32;
+      if (event == 0)
+      {
+        key_off |= (1u << voice);
+      }
+      else if (event == 1)
+      {
+        const u16 base = static_cast<u16>(voice * 0x10);
+        const u16 instrument_address =
+          static_cast<u16>(SAMPLE_BASE_ADDRESS + (rng() % NUM_INSTRUMENTS) * BLOCKS_PER_INSTRUMENT * 2);
+        const bool sweep = (rng() % 4) == 0;
+        trace.push_back({0, static_cast<u16>(base + 0x0), static_cast<u16>(sweep ? (0x8000 | (rng() & 0x7F)) :
+                                                                                   (rng() & 0x3FFF))});
+        trace.push_back({0, static_cast<u16>(base + 0x2), static_cast<u16>(rng() & 0x3FFF)});
+        trace.push_back({0, static_cast<u16>(base + 0x4), static_cast<u16>(0x400 + rng() % 0x1C00)});
+        trace.push_back({0, static_cast<u16>(base + 0x6), instrument_address});
+        trace.push_back({0, static_cast<u16>(base + 0x8), static_cast<u16>(rng())});
+        trace.push_back({0, static_cast<u16>(base + 0xA), static_cast<u16>(rng())});
+        key_on |= (1u << voice);
+      }
+    }
+
+    // Noise and pitch modulation get used now and then too.
+    if ((frame % 60) == 0)
+    {
+      trace.push_back({0, SPURegister(0x1F801D94), static_cast<u16>(1u << (rng() % 16))});
+      trace.push_back({0, SPURegister(0x1F801D90), static_cast<u16>(rng() & 0xFFFE)});
+    }
+
+    trace.push_back({0, SPURegister(0x1F801D8C), static_cast<u16>(key_off)});
+    trace.push_back({0, SPURegister(0x1F801D8E), static_cast<u16>(key_off >> 16)});
+    trace.push_back({0, SPURegister(0x1F801D88), static_cast<u16>(key_on)});
+    trace.push_back({0, SPURegister(0x1F801D8A), static_cast<u16>(key_on >> 16)});
+    trace.push_back({TICKS_PER_VIDEO_FRAME, SPURegister(0x1F801D9C), 0});
+  }
+
+  return trace;
+}
+
+/// Adds a new reverb configuration every half second on top of the sequencer trace. Work areas are placed anywhere,
+/// including over the sample data and capture buffers, and the coefficients are random with the special cases mixed
+/// in, so every wraparound and saturation path gets hit.
+static SPURegisterTrace BuildReverbTrace(u32 seed, u32 seconds)
+{
+  const SPURegisterTrace sequencer_trace = BuildSequencerTrace(seed, seconds);
+  std::mt19937 rng(seed + 1);
+
+  static constexpr u32 IIR_ALPHA = 2;
+  static constexpr u32 FB_ALPHA = 8;
+  static constexpr u32 FB_X = 9;
+
+  SPURegisterTrace trace;
+  u32 frame = 0;
+  for (const SPURegisterWrite& write : sequencer_trace)
+  {
+    trace.push_back(write);
+    if (write.delay != TICKS_PER_VIDEO_FRAME || (++frame % 30) != 0)
+      continue;
+
+    trace.push_back({0, SPURegister(0x1F801DAA), static_cast<u16>((rng() % 4) ? 0xC080 : 0xC000)});
+    trace.push_back({0, SPURegister(0x1F801DA2), static_cast<u16>((rng() % 2) ? (0xFF00 | (rng() & 0xFF)) : rng())});
+    for (u32 i = 0; i < 32; i++)
+    {
+      const bool special = (i == IIR_ALPHA || i == FB_ALPHA || i == FB_X) && (rng() % 4) == 0;
+      const u16 value = special ? 0x8000 : static_cast<u16>(rng());
+      trace.push_back({0, static_cast<u16>(SPURegister(0x1F801DC0) + i * 2), value});
+    }
+    trace.push_back({0, SPURegister(0x1F801D84), static_cast<u16>(rng())});
+    trace.push_back({0, SPURegister(0x1F801D86), static_cast<u16>(rng())});
+  }
+
+  return trace;
+}
+
+class SPUTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_host_interface = std::make_unique<TestHostInterface>();
+    g_settings.audio_use_thread = false;
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    TimingEvents::Initialize();
+    g_spu.Initialize();
+  }
+
+  void TearDown() override
+  {
+    SPU::SetSIMDEnabled(true);
+    SPU::SetOptimizedReverbEnabled(true);
+    g_spu.Shutdown();
+    TimingEvents::Shutdown();
+    m_host_interface.reset();
+  }
+
+  static void RunTicks(TickCount ticks)
+  {
+    while (ticks > 0)
+    {
+      const TickCount slice = std::min(ticks, CPU::g_state.downcount);
+      CPU::AddPendingTicks(slice);
+      ticks -= slice;
+      TimingEvents::RunEvents();
+    }
+  }
+
+  /// Replays the trace from a reset SPU, returning the generated frames if recording.
+  std::vector<s16> ReplayTrace(const SPURegisterTrace& trace, bool record)
+  {
+    g_spu.Reset();
+
+    RecordingAudioStream* stream = m_host_interface->GetRecordingStream();
+    stream->frames.clear();
+    stream->recording = record;
+
+    for (const SPURegisterWrite& write : trace)
+    {
+      RunTicks(write.delay);
+      if (write.offset == SPURegister(0x1F801D9C))
+        g_spu.ReadRegister(write.offset);
+      else
+        g_spu.WriteRegister(write.offset, write.value);
+    }
+
+    g_spu.GeneratePendingSamples();
+    g_spu.Sync();
+    return std::move(stream->frames);
+  }
+
+  /// Serializes the SPU, including RAM, so the state after a replay can be compared.
+  static std::vector<u8> SaveState()
+  {
+    std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    EXPECT_TRUE(g_spu.DoState(sw));
+
+    const u8* data = stream->GetMemoryPointer();
+    return std::vector<u8>(data, data + stream->GetPosition());
+  }
+
+  std::unique_ptr<TestHostInterface> m_host_interface;
+};
+
+} // namespace
+
+TEST_F(SPUTest, SIMDMatchesScalar)
+{
+  const SPURegisterTrace trace = BuildSequencerTrace(1234, 5);
+
+  SPU::SetSIMDEnabled(false);
+  const std::vector<s16> scalar_frames = ReplayTrace(trace, true);
+  SPU::SetSIMDEnabled(true);
+  const std::vector<s16> simd_frames = ReplayTrace(trace, true);
+
+  ASSERT_GT(scalar_frames.size(), 5u * 44100u * 2u - 2048u);
+  ASSERT_TRUE(std::any_of(scalar_frames.begin(), scalar_frames.end(), [](s16 value) { return value != 0; }));
+  ASSERT_EQ(scalar_frames.size(), simd_frames.size());
+  for (size_t i = 0; i < scalar_frames.size(); i++)
+    ASSERT_EQ(scalar_frames[i], simd_frames[i]) << "sample " << i;
+}
+
+TEST_F(SPUTest, OptimizedReverbMatchesReference)
+{
+  const SPURegisterTrace trace = BuildReverbTrace(4321, 5);
+
+  SPU::SetOptimizedReverbEnabled(false);
+  const std::vector<s16> reference_frames = ReplayTrace(trace, true);
+  const std::vector<u8> reference_state = SaveState();
+  SPU::SetOptimizedReverbEnabled(true);
+  const std::vector<s16> optimized_frames = ReplayTrace(trace, true);
+  const std::vector<u8> optimized_state = SaveState();
+
+  ASSERT_EQ(reference_frames.size(), optimized_frames.size());
+  for (size_t i = 0; i < reference_frames.size(); i++)
+    ASSERT_EQ(reference_frames[i], optimized_frames[i]) << "sample " << i;
+
+  ASSERT_EQ(reference_state.size(), optimized_state.size());
+  ASSERT_TRUE(reference_state == optimized_state);
+}
+
+TEST_F(SPUTest, ThreadMatchesSynchronous)
+{
+  // The sample upload at the start is interleaved with mixing, so the RAM writes are queued on the thread too.
+  const SPURegisterTrace trace = BuildReverbTrace(8765, 5);
+
+  const std::vector<s16> synchronous_frames = ReplayTrace(trace, true);
+  const std::vector<u8> synchronous_state = SaveState();
+  g_spu.SetUseThread(true);
+  const std::vector<s16> thread_frames = ReplayTrace(trace, true);
+  const std::vector<u8> thread_state = SaveState();
+  g_spu.SetUseThread(false);
+
+  ASSERT_EQ(synchronous_frames.size(), thread_frames.size());
+  for (size_t i = 0; i < synchronous_frames.size(); i++)
+    ASSERT_EQ(synchronous_frames[i], thread_frames[i]) << "sample " << i;
+
+  ASSERT_EQ(synchronous_state.size(), thread_state.size());
+  ASSERT_TRUE(synchronous_state == thread_state);
+}
+
+// Timing only, nothing is checked. Run with --gtest_also_run_disabled_tests.
+TEST_F(SPUTest, DISABLED_ExecuteBenchmark)
+{
+  static constexpr u32 SECONDS = 10;
+  const SPURegisterTrace trace = BuildSequencerTrace(5678, SECONDS);
+
+  struct Configuration
+  {
+    const char* name;
+    bool simd;
+    bool optimized_reverb;
+  };
+  static constexpr Configuration configurations[] = {
+    {"Scalar, reference reverb", false, false}, {"SIMD, reference reverb", true, false}, {"SIMD", true, true}};
+
+  for (const Configuration& config : configurations)
+  {
+    SPU::SetSIMDEnabled(config.simd);
+    SPU::SetOptimizedReverbEnabled(config.optimized_reverb);
+    Common::Timer timer;
+    ReplayTrace(trace, false);
+    const double elapsed_ms = timer.GetTimeMilliseconds();
+
+    std::printf("%s: %u emulated seconds in %.2f ms, %.0f frames/second\n", config.name, SECONDS, elapsed_ms,
+                static_cast<double>(SECONDS * 44100) / (elapsed_ms / 1000.0));
+  }
+}
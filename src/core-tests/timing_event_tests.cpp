@@ -0,0 +1,235 @@
+#include "common/timer.h"
+#include "core/cpu_core.h"
+#include "core/timing_event.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct EventRecord
+{
+  u32 fire_count = 0;
+  TickCount total_ticks = 0;
+  bool out_of_order = false;
+};
+
+static u32 s_last_fire_time = 0;
+
+static void RecordEvent(void* param, TickCount ticks, TickCount ticks_late)
+{
+  EventRecord* record = static_cast<EventRecord*>(param);
+  const u32 now = TimingEvents::GetGlobalTickCounter();
+  record->out_of_order |= (now < s_last_fire_time);
+  record->fire_count++;
+  record->total_ticks += ticks;
+  s_last_fire_time = now;
+}
+
+class TimingEventsTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    CPU::g_state.frame_done = false;
+    s_last_fire_time = 0;
+    TimingEvents::Initialize();
+  }
+
+  void TearDown() override { TimingEvents::Shutdown(); }
+
+  /// Mimics the CPU execution loop: run until the downcount is hit, then service events.
+  static void RunTicks(TickCount ticks)
+  {
+    while (ticks > 0)
+    {
+      const TickCount slice = std::min(ticks, CPU::g_state.downcount);
+      CPU::AddPendingTicks(slice);
+      ticks -= slice;
+      TimingEvents::RunEvents();
+    }
+  }
+};
+
+} // namespace
+
+TEST_F(TimingEventsTest, FiresAtInterval)
+{
+  static constexpr std::array<TickCount, 6> intervals = {{7, 13, 100, 768, 2172, 9999}};
+  static constexpr TickCount total_ticks = 100000;
+
+  std::array<EventRecord, intervals.size()> records;
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (size_t i = 0; i < intervals.size(); i++)
+  {
+    events.push_back(
+      TimingEvents::CreateTimingEvent("Test Event", intervals[i], intervals[i], &RecordEvent, &records[i], true));
+  }
+
+  RunTicks(total_ticks);
+
+  for (size_t i = 0; i < intervals.size(); i++)
+  {
+    EXPECT_EQ(records[i].fire_count, static_cast<u32>(total_ticks / intervals[i])) << "interval " << intervals[i];
+    EXPECT_EQ(records[i].total_ticks, static_cast<TickCount>(records[i].fire_count) * intervals[i])
+      << "interval " << intervals[i];
+    EXPECT_FALSE(records[i].out_of_order) << "interval " << intervals[i];
+  }
+}
+
+TEST_F(TimingEventsTest, RescheduleAndDeactivate)
+{
+  static constexpr u32 NUM_EVENTS = 12;
+  std::array<EventRecord, NUM_EVENTS> records;
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (u32 i = 0; i < NUM_EVENTS; i++)
+    events.push_back(TimingEvents::CreateTimingEvent("Test Event", 100, 100, &RecordEvent, &records[i], true));
+
+  // Shuffle the events around like IO handlers do between event runs, and check every active event still fires
+  // at the time it was scheduled for.
+  std::mt19937 rng(1234);
+  std::array<u32, NUM_EVENTS> expected_fire_time;
+  expected_fire_time.fill(100);
+  u32 now = 0;
+  for (u32 round = 0; round < 1000; round++)
+  {
+    for (u32 i = 0; i < NUM_EVENTS; i++)
+    {
+      switch (rng() % 4)
+      {
+        case 0:
+          events[i]->Deactivate();
+          break;
+
+        case 1:
+          events[i]->SetIntervalAndSchedule(static_cast<TickCount>(1 + rng() % 500));
+          expected_fire_time[i] = now + static_cast<u32>(events[i]->GetInterval());
+          break;
+
+        default:
+          if (!events[i]->IsActive())
+          {
+            events[i]->SetIntervalAndSchedule(static_cast<TickCount>(1 + rng() % 500));
+            expected_fire_time[i] = now + static_cast<u32>(events[i]->GetInterval());
+          }
+          break;
+      }
+    }
+
+    // Run up to the earliest event, which must fire exactly when expected.
+    u32 next_fire_time = std::numeric_limits<u32>::max();
+    for (u32 i = 0; i < NUM_EVENTS; i++)
+    {
+      if (events[i]->IsActive())
+        next_fire_time = std::min(next_fire_time, expected_fire_time[i]);
+    }
+    if (next_fire_time == std::numeric_limits<u32>::max())
+      continue;
+
+    std::array<u32, NUM_EVENTS> fire_counts;
+    for (u32 i = 0; i < NUM_EVENTS; i++)
+      fire_counts[i] = records[i].fire_count;
+
+    ASSERT_EQ(CPU::g_state.downcount, static_cast<TickCount>(next_fire_time - now));
+    RunTicks(static_cast<TickCount>(next_fire_time - now));
+    now = next_fire_time;
+    ASSERT_EQ(TimingEvents::GetGlobalTickCounter(), now);
+
+    for (u32 i = 0; i < NUM_EVENTS; i++)
+    {
+      const bool should_fire = events[i]->IsActive() && expected_fire_time[i] == now;
+      EXPECT_EQ(records[i].fire_count, fire_counts[i] + (should_fire ? 1u : 0u)) << "event " << i;
+      if (should_fire)
+        expected_fire_time[i] = now + static_cast<u32>(events[i]->GetInterval());
+    }
+  }
+
+  for (u32 i = 0; i < NUM_EVENTS; i++)
+    EXPECT_FALSE(records[i].out_of_order);
+}
+
+TEST_F(TimingEventsTest, RunEventsManyIntervals)
+{
+  // Roughly the events active while a game is streaming from the disc.
+  static constexpr std::array<std::pair<const char*, TickCount>, 9> event_intervals = {{
+    {"GPU CRTC Tick", 2172},
+    {"GPU Command Tick", 128},
+    {"CDROM Drive Event", 225792},
+    {"CDROM Command Event", 25000},
+    {"SPU Sample", 768},
+    {"Timer SysClk Interrupt", 4000},
+    {"DMA Transfer Unhalt", 500},
+    {"Pad Serial Transfer", 1088},
+    {"MDEC Block Copy Out", 448},
+  }};
+
+  std::array<EventRecord, event_intervals.size()> records;
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (size_t i = 0; i < event_intervals.size(); i++)
+  {
+    events.push_back(TimingEvents::CreateTimingEvent(event_intervals[i].first, event_intervals[i].second,
+                                                     event_intervals[i].second, &RecordEvent, &records[i], true));
+  }
+
+  // One emulated second.
+  static constexpr TickCount total_ticks = 33868800;
+  for (TickCount ticks = total_ticks; ticks > 0;)
+  {
+    const TickCount slice = std::min(ticks, CPU::g_state.downcount);
+    CPU::AddPendingTicks(slice);
+    ticks -= slice;
+    TimingEvents::RunEvents();
+  }
+
+  for (size_t i = 0; i < event_intervals.size(); i++)
+    EXPECT_EQ(records[i].fire_count, static_cast<u32>(total_ticks / event_intervals[i].second));
+}
+
+// Timing only, nothing is checked. Run with --gtest_also_run_disabled_tests.
+TEST_F(TimingEventsTest, DISABLED_RunEventsBenchmark)
+{
+  // Roughly the events active while a game is streaming from the disc.
+  static constexpr std::array<std::pair<const char*, TickCount>, 9> event_intervals = {{
+    {"GPU CRTC Tick", 2172},
+    {"GPU Command Tick", 128},
+    {"CDROM Drive Event", 225792},
+    {"CDROM Command Event", 25000},
+    {"SPU Sample", 768},
+    {"Timer SysClk Interrupt", 4000},
+    {"DMA Transfer Unhalt", 500},
+    {"Pad Serial Transfer", 1088},
+    {"MDEC Block Copy Out", 448},
+  }};
+
+  std::array<EventRecord, event_intervals.size()> records;
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (size_t i = 0; i < event_intervals.size(); i++)
+  {
+    events.push_back(TimingEvents::CreateTimingEvent(event_intervals[i].first, event_intervals[i].second,
+                                                     event_intervals[i].second, &RecordEvent, &records[i], true));
+  }
+
+  // One emulated second.
+  static constexpr TickCount total_ticks = 33868800;
+  u32 run_count = 0;
+  Common::Timer timer;
+  for (TickCount ticks = total_ticks; ticks > 0;)
+  {
+    const TickCount slice = std::min(ticks, CPU::g_state.downcount);
+    CPU::AddPendingTicks(slice);
+    ticks -= slice;
+    TimingEvents::RunEvents();
+    run_count++;
+  }
+  const double elapsed_ns = timer.GetTimeNanoseconds();
+
+  std::printf("%u RunEvents calls for %zu events in %.2f ms, %.1f ns per call\n", run_count, event_intervals.size(),
+              elapsed_ns / 1000000.0, elapsed_ns / static_cast<double>(run_count));
+}
@@ -10,6 +10,7 @@
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "dma.h"
+#include "frame_profiler.h"
 #include "gpu.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
@@ -179,8 +180,8 @@ bool DoState(StateWrapper& sw)
   sw.Do(&m_bios_access_time);
   sw.Do(&m_cdrom_access_time);
   sw.Do(&m_spu_access_time);
-  sw.DoBytes(g_ram, RAM_SIZE);
-  sw.DoBytes(g_bios, BIOS_SIZE);
+  sw.DoPagedRegion(g_ram, RAM_SIZE);
+  sw.DoPagedRegion(g_bios, BIOS_SIZE);
   sw.DoArray(m_MEMCTRL.regs, countof(m_MEMCTRL.regs));
   sw.Do(&m_ram_size_reg);
   sw.Do(&m_tty_line_buffer);
@@ -619,7 +620,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
   {
     const u32 page_index = offset / HOST_PAGE_SIZE;
     if (m_ram_code_bits[page_index])
-      CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+      CPU::CodeCache::InvalidateBlocksInRAMRange(offset, offset + 1);
 
     if constexpr (size == MemoryAccessSize::Byte)
     {
@@ -908,6 +909,8 @@ ALWAYS_INLINE static TickCount DoSIOAccess(u32 offset, u32& value)
 template<MemoryAccessType type, MemoryAccessSize size>
 ALWAYS_INLINE static TickCount DoCDROMAccess(u32 offset, u32& value)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::CDROM);
+
   if constexpr (type == MemoryAccessType::Read)
   {
     switch (size)
@@ -968,6 +971,8 @@ ALWAYS_INLINE static TickCount DoCDROMAccess(u32 offset, u32& value)
 template<MemoryAccessType type, MemoryAccessSize size>
 ALWAYS_INLINE static TickCount DoGPUAccess(u32 offset, u32& value)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::GPU);
+
   if constexpr (type == MemoryAccessType::Read)
   {
     value = g_gpu->ReadRegister(offset);
@@ -1036,6 +1041,8 @@ ALWAYS_INLINE static TickCount DoAccessTimers(u32 offset, u32& value)
 template<MemoryAccessType type, MemoryAccessSize size>
 ALWAYS_INLINE static TickCount DoAccessSPU(u32 offset, u32& value)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::SPU);
+
   if constexpr (type == MemoryAccessType::Read)
   {
     switch (size)
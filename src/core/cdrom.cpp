@@ -5,6 +5,7 @@
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
+#include "frame_profiler.h"
 #include "interrupt_controller.h"
 #include "settings.h"
 #include "spu.h"
@@ -79,9 +80,16 @@ CDROM::~CDROM() = default;
 void CDROM::Initialize()
 {
   m_command_event =
-    TimingEvents::CreateTimingEvent("CDROM Command Event", 1, 1, std::bind(&CDROM::ExecuteCommand, this), false);
+    TimingEvents::CreateTimingEvent("CDROM Command Event", 1, 1,
+                                    [](void* param, TickCount ticks, TickCount ticks_late) {
+                                      static_cast<CDROM*>(param)->ExecuteCommand();
+                                    },
+                                    this, false);
   m_drive_event = TimingEvents::CreateTimingEvent("CDROM Drive Event", 1, 1,
-                                                  std::bind(&CDROM::ExecuteDrive, this, std::placeholders::_2), false);
+                                                  [](void* param, TickCount ticks, TickCount ticks_late) {
+                                                    static_cast<CDROM*>(param)->ExecuteDrive(ticks_late);
+                                                  },
+                                                  this, false);
 
   if (g_settings.cdrom_read_thread)
     m_reader.StartThread();
@@ -746,6 +754,8 @@ void CDROM::AbortCommand()
 
 void CDROM::ExecuteCommand()
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::CDROM);
+
   const CommandInfo& ci = s_command_info[static_cast<u8>(m_command)];
   Log_DevPrintf("CDROM executing command 0x%02X (%s)", static_cast<u8>(m_command), ci.name);
   if (m_param_fifo.GetSize() < ci.expected_parameters)
@@ -1354,6 +1364,8 @@ void CDROM::UpdateCommandEvent()
 
 void CDROM::ExecuteDrive(TickCount ticks_late)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::CDROM);
+
   switch (m_drive_state)
   {
     case DriveState::Resetting:
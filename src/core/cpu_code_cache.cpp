@@ -1,13 +1,21 @@
 #include "cpu_code_cache.h"
 #include "bus.h"
 #include "common/assert.h"
+#include "common/file_system.h"
 #include "common/log.h"
+#include "common/timer.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "settings.h"
 #include "system.h"
 #include "timing_event.h"
+#include <algorithm>
+#include <bitset>
+#include <zlib.h>
+#ifdef WITH_IMGUI
+#include "imgui.h"
+#endif
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -18,6 +26,25 @@ namespace CPU::CodeCache {
 
 constexpr bool USE_BLOCK_LINKING = true;
 
+/// Number of blocks allocated at once when the block pool is empty.
+static constexpr u32 BLOCK_POOL_CHUNK_SIZE = 1024;
+
+/// Code pages are split into lines, so that writes to data sharing a page with code don't invalidate blocks.
+static constexpr u32 CODE_LINE_SIZE = 256;
+static constexpr u32 RAM_CODE_LINE_COUNT = Bus::RAM_SIZE / CODE_LINE_SIZE;
+
+/// Limits for following branches when building superblocks.
+static constexpr u32 MAX_TRACE_BRANCHES = 8;
+static constexpr u32 MAX_TRACE_INSTRUCTIONS = 256;
+static constexpr u32 MAX_TRACE_SPAN_PAGES = 4;
+
+ALWAYS_INLINE static u32 GetFastMapIndex(u32 pc)
+{
+  return ((pc & PHYSICAL_MEMORY_ADDRESS_MASK) >= Bus::BIOS_BASE) ?
+           (FAST_MAP_RAM_SLOT_COUNT + ((pc & Bus::BIOS_MASK) >> 2)) :
+           ((pc & Bus::RAM_MASK) >> 2);
+}
+
 #ifdef WITH_RECOMPILER
 
 // Currently remapping the code buffer doesn't work in macOS or Haiku.
@@ -35,6 +62,10 @@ static constexpr u32 RECOMPILER_FAR_CODE_CACHE_SIZE = 16 * 1024 * 1024;
 #endif
 static constexpr u32 CODE_WRITE_FAULT_THRESHOLD_FOR_SLOWMEM = 10;
 
+/// The code buffer is split into regions which are filled in order. When the buffer is full, the oldest region is
+/// evicted, instead of flushing every block.
+static constexpr u32 CODE_REGION_COUNT = 8;
+
 #ifdef USE_STATIC_CODE_BUFFER
 static constexpr u32 RECOMPILER_GUARD_SIZE = 4096;
 alignas(Recompiler::CODE_STORAGE_ALIGNMENT) static u8
@@ -47,16 +78,36 @@ std::array<CodeBlock::HostCodePointer, FAST_MAP_TOTAL_SLOT_COUNT> s_fast_map;
 DispatcherFunction s_asm_dispatcher;
 SingleBlockDispatcherFunction s_single_block_asm_dispatcher;
 
-ALWAYS_INLINE static u32 GetFastMapIndex(u32 pc)
-{
-  return ((pc & PHYSICAL_MEMORY_ADDRESS_MASK) >= Bus::BIOS_BASE) ?
-           (FAST_MAP_RAM_SLOT_COUNT + ((pc & Bus::BIOS_MASK) >> 2)) :
-           ((pc & Bus::RAM_MASK) >> 2);
-}
-
 static void CompileDispatcher();
 static void FastCompileBlockFunction();
 
+/// Splits the code buffer space after the dispatchers into regions.
+static void ResetCodeRegions();
+
+/// Discards the host code for all blocks in the next region, and starts allocating from it.
+static void EvictNextCodeRegion();
+
+static u32 s_code_region_start = 0;
+static u32 s_far_code_region_start = 0;
+static u32 s_code_region_size = 0;
+static u32 s_far_code_region_size = 0;
+static u32 s_current_code_region = 0;
+static bool s_code_regions_wrapped = false; // regions past the current one hold code
+
+static u32 s_code_buffer_flush_count = 0;
+static u32 s_evicted_code_region_count = 0;
+static u32 s_evicted_block_count = 0;
+static u32 s_live_code_bytes = 0;
+
+/// Returns true if there's enough space in the code buffer to compile the block without flushing.
+static bool HasCodeSpaceForBlock(const CodeBlock* block);
+
+/// Generates host code for an already-decoded block, and makes it visible to the dispatcher.
+static bool CompileBlockHostCode(CodeBlock* block);
+
+/// Executes a block which hasn't reached the compile threshold yet.
+static void InterpretColdBlock(CodeBlock* block);
+
 static void ResetFastMap()
 {
   s_fast_map.fill(FastCompileBlockFunction);
@@ -80,14 +131,32 @@ static CodeBlockKey GetNextBlockKey();
 /// Looks up the block in the cache if it's already been compiled.
 static CodeBlock* LookupBlock(CodeBlockKey key);
 
+/// Compiles a new block and adds it to the cache. Returns nullptr if the block could not be compiled.
+static CodeBlock* CreateBlock(CodeBlockKey key);
+
 /// Can the current block execute? This will re-validate the block if necessary.
 /// The block can also be flushed if recompilation failed, so ignore the pointer if false is returned.
 static bool RevalidateBlock(CodeBlock* block);
 
 static bool CompileBlock(CodeBlock* block);
+
+/// Returns true if decoding can continue at the target of the branch, instead of ending the block.
+static bool CanFollowBranchInTrace(const CodeBlock* block, const CodeBlockInstruction& branch_cbi, u32 target);
 static void FlushBlock(CodeBlock* block);
 static void AddBlockToPageMap(CodeBlock* block);
-static void RemoveBlockFromPageMap(CodeBlock* block);
+static void RemoveBlockFromPageMap(CodeBlock* block, bool update_code_lines = true);
+
+/// Rebuilds the code line bits for a page from the blocks which are still on it.
+static void UpdateCodeLinesForPage(u32 page_index);
+
+/// Returns true if any code line in the specified RAM range contains code.
+static bool HasCodeLinesInRange(u32 start_offset, u32 end_offset);
+
+/// Returns true if the block has any instructions in the specified RAM range.
+static bool BlockHasCodeInRange(const CodeBlock* block, u32 start_offset, u32 end_offset);
+
+/// Invalidates blocks on the page with code in the specified RAM range, leaving the rest of the page's blocks alone.
+static void InvalidateBlocksInPageRange(u32 page_index, u32 start_offset, u32 end_offset);
 
 /// Link block from to to.
 static void LinkBlock(CodeBlock* from, CodeBlock* to);
@@ -99,6 +168,52 @@ static void ClearState();
 
 static BlockMap s_blocks;
 static std::array<std::vector<CodeBlock*>, Bus::RAM_CODE_PAGE_COUNT> m_ram_block_map;
+static std::bitset<RAM_CODE_LINE_COUNT> s_ram_code_lines;
+
+struct CodePageStats
+{
+  u32 invalidations;
+  u32 invalidated_blocks;
+  u32 ignored_writes;
+};
+
+static std::array<CodePageStats, Bus::RAM_CODE_PAGE_COUNT> s_code_page_stats;
+
+/// Direct-mapped cache of s_blocks, indexed by physical PC. Entries must be checked against the key, since
+/// mirrored segments and user/kernel mode blocks share a slot. s_blocks remains the owner of all blocks.
+static std::array<CodeBlock*, FAST_MAP_TOTAL_SLOT_COUNT> s_block_table;
+
+static std::vector<std::unique_ptr<CodeBlock[]>> s_block_pool_chunks;
+static std::vector<CodeBlock*> s_free_blocks;
+
+static CodeBlock* AllocateBlock(CodeBlockKey key);
+static void FreeBlock(CodeBlock* block);
+
+struct BlockProfileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 entry_count;
+};
+
+struct BlockProfileEntry
+{
+  u32 key;
+  u32 instruction_count;
+  u32 code_hash;
+};
+
+static constexpr u32 BLOCK_PROFILE_MAGIC = 0x46525042; // BPRF
+static constexpr u32 BLOCK_PROFILE_VERSION = 1;
+static constexpr u32 MAX_PROFILED_BLOCKS = FAST_MAP_TOTAL_SLOT_COUNT;
+
+static u32 GetBlockCodeHash(const CodeBlock* block);
+
+/// Returns true if the block in memory at the profiled address is the one which was profiled.
+static bool DoesProfiledBlockMatchMemory(const BlockProfileEntry& entry, CodeBlock* scratch_block);
+
+static std::vector<BlockProfileEntry> s_block_profile;
+static size_t s_block_profile_position = 0;
 
 #ifdef WITH_RECOMPILER
 static HostCodeMap s_host_code_map;
@@ -148,13 +263,19 @@ void ClearState()
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  s_ram_code_lines.reset();
 
   for (const auto& it : s_blocks)
-    delete it.second;
+  {
+    if (it.second)
+      FreeBlock(it.second);
+  }
 
   s_blocks.clear();
+  s_block_table.fill(nullptr);
 #ifdef WITH_RECOMPILER
   s_host_code_map.clear();
+  s_live_code_bytes = 0;
   s_code_buffer.Reset();
   ResetFastMap();
 #endif
@@ -162,7 +283,23 @@ void ClearState()
 
 void Shutdown()
 {
+#ifdef WITH_RECOMPILER
+  if (g_settings.IsUsingRecompiler())
+  {
+    Log_InfoPrintf("Code buffer: %u flushes, %u regions evicted (%u blocks), %u bytes of code live",
+                   s_code_buffer_flush_count, s_evicted_code_region_count, s_evicted_block_count, s_live_code_bytes);
+  }
+  s_code_buffer_flush_count = 0;
+  s_evicted_code_region_count = 0;
+  s_evicted_block_count = 0;
+#endif
+
   ClearState();
+  s_code_page_stats = {};
+  s_free_blocks.clear();
+  s_block_pool_chunks.clear();
+  s_block_profile.clear();
+  s_block_profile_position = 0;
 #ifdef WITH_RECOMPILER
   ShutdownFastmem();
   s_code_buffer.Destroy();
@@ -292,6 +429,71 @@ void CompileDispatcher()
     Recompiler::CodeGenerator cg(&s_code_buffer);
     s_single_block_asm_dispatcher = cg.CompileSingleBlockDispatcher();
   }
+
+  // Blocks go after the dispatchers.
+  ResetCodeRegions();
+}
+
+void ResetCodeRegions()
+{
+  s_code_region_start = s_code_buffer.GetUsedCodeSpace();
+  s_far_code_region_start = s_code_buffer.GetUsedFarCodeSpace();
+  s_code_region_size = (s_code_buffer.GetTotalCodeSpace() - s_code_region_start) / CODE_REGION_COUNT;
+  s_far_code_region_size = (s_code_buffer.GetTotalFarCodeSpace() - s_far_code_region_start) / CODE_REGION_COUNT;
+  s_current_code_region = 0;
+  s_code_regions_wrapped = false;
+}
+
+void EvictNextCodeRegion()
+{
+  const u32 region = (s_current_code_region + 1) % CODE_REGION_COUNT;
+  s_code_buffer.SetFreeCodeOffsets(s_code_region_start + (region * s_code_region_size),
+                                   s_far_code_region_start + (region * s_far_code_region_size));
+  s_current_code_region = region;
+  s_code_regions_wrapped |= (region == 0);
+
+  // Far code is allocated from the matching far region, so it goes away with the near code.
+  const CodeBlock::HostCodePointer region_begin =
+    reinterpret_cast<CodeBlock::HostCodePointer>(s_code_buffer.GetFreeCodePointer());
+  const CodeBlock::HostCodePointer region_end =
+    reinterpret_cast<CodeBlock::HostCodePointer>(s_code_buffer.GetFreeCodePointer() + s_code_region_size);
+
+  u32 evicted_blocks = 0;
+  HostCodeMap::iterator iter = s_host_code_map.lower_bound(region_begin);
+  while (iter != s_host_code_map.end() && iter->first < region_end)
+  {
+    // The block itself stays in the cache, it'll be compiled again if it's executed.
+    CodeBlock* block = iter->second;
+    SetFastMap(block->GetPC(), FastCompileBlockFunction);
+    s_live_code_bytes -= block->host_code_size;
+    block->host_code = nullptr;
+    block->host_code_size = 0;
+    block->interpreted_count = 0;
+    block->loadstore_backpatch_info.clear();
+    iter = s_host_code_map.erase(iter);
+    evicted_blocks++;
+  }
+
+  // Until the buffer wraps, we're moving into space which has never been used, so there's nothing to evict.
+  if (!s_code_regions_wrapped && evicted_blocks == 0)
+    return;
+
+  s_evicted_code_region_count++;
+  s_evicted_block_count += evicted_blocks;
+  Log_ProfilePrintf("Evicted code region %u with %u blocks, %u blocks and %u bytes of code live", region,
+                    evicted_blocks, static_cast<u32>(s_host_code_map.size()), s_live_code_bytes);
+}
+
+CodeBufferStats GetCodeBufferStats()
+{
+  CodeBufferStats stats = {};
+  stats.flush_count = s_code_buffer_flush_count;
+  stats.evicted_region_count = s_evicted_code_region_count;
+  stats.evicted_block_count = s_evicted_block_count;
+  stats.live_block_count = static_cast<u32>(s_host_code_map.size());
+  stats.live_code_bytes = s_live_code_bytes;
+  stats.code_region_size = s_code_region_size;
+  return stats;
 }
 
 CodeBlock::HostCodePointer* GetFastMapPointer()
@@ -366,6 +568,7 @@ void Reinitialize()
 
 void Flush()
 {
+  s_code_buffer_flush_count++;
   ClearState();
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
@@ -398,43 +601,67 @@ CodeBlockKey GetNextBlockKey()
 
 CodeBlock* LookupBlock(CodeBlockKey key)
 {
-  BlockMap::iterator iter = s_blocks.find(key.bits);
-  if (iter != s_blocks.end())
+  CodeBlock*& table_entry = s_block_table[GetFastMapIndex(key.GetPC())];
+  CodeBlock* existing_block = table_entry;
+  if (!existing_block || existing_block->key != key)
   {
-    // ensure it hasn't been invalidated
-    CodeBlock* existing_block = iter->second;
-    if (!existing_block || !existing_block->invalidated || RevalidateBlock(existing_block))
-      return existing_block;
+    BlockMap::iterator iter = s_blocks.find(key.bits);
+    existing_block = (iter != s_blocks.end()) ? iter->second : nullptr;
+    if (!existing_block)
+      return (iter != s_blocks.end()) ? nullptr : CreateBlock(key);
+
+    table_entry = existing_block;
   }
 
-  CodeBlock* block = new CodeBlock(key);
+  // ensure it hasn't been invalidated
+  if (!existing_block->invalidated || RevalidateBlock(existing_block))
+    return existing_block;
+
+  return CreateBlock(key);
+}
+
+CodeBlock* CreateBlock(CodeBlockKey key)
+{
+  CodeBlock* block = AllocateBlock(key);
   if (CompileBlock(block))
   {
     // add it to the page map if it's in ram
     AddBlockToPageMap(block);
 
 #ifdef WITH_RECOMPILER
-    SetFastMap(block->GetPC(), block->host_code);
-    AddBlockToHostCodeMap(block);
+    if (block->host_code)
+    {
+      SetFastMap(block->GetPC(), block->host_code);
+      AddBlockToHostCodeMap(block);
+    }
 #endif
   }
   else
   {
     Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
-    delete block;
+    FreeBlock(block);
     block = nullptr;
   }
 
   s_blocks.emplace(key.bits, block);
+  if (block)
+    s_block_table[GetFastMapIndex(key.GetPC())] = block;
+
   return block;
 }
 
 bool RevalidateBlock(CodeBlock* block)
 {
+  // RAM blocks never leave RAM, so we can skip the memory map lookup for every instruction.
+  const bool in_ram = block->IsInRAM();
   for (const CodeBlockInstruction& cbi : block->instructions)
   {
     u32 new_code = 0;
-    SafeReadInstruction(cbi.pc, &new_code);
+    if (in_ram)
+      std::memcpy(&new_code, &Bus::g_ram[cbi.pc & Bus::RAM_MASK], sizeof(new_code));
+    else
+      SafeReadInstruction(cbi.pc, &new_code);
+
     if (cbi.instruction.bits != new_code)
     {
       Log_DebugPrintf("Block 0x%08X changed at PC 0x%08X - %08X to %08X - recompiling.", block->GetPC(), cbi.pc,
@@ -447,7 +674,8 @@ bool RevalidateBlock(CodeBlock* block)
   block->invalidated = false;
   AddBlockToPageMap(block);
 #ifdef WITH_RECOMPILER
-  SetFastMap(block->GetPC(), block->host_code);
+  if (block->host_code)
+    SetFastMap(block->GetPC(), block->host_code);
 #endif
   return true;
 
@@ -474,7 +702,7 @@ recompile:
   return true;
 }
 
-bool CompileBlock(CodeBlock* block)
+bool DecodeBlock(CodeBlock* block)
 {
   u32 pc = block->GetPC();
   bool is_branch_delay_slot = false;
@@ -487,6 +715,7 @@ bool CompileBlock(CodeBlock* block)
 #endif
 
   u32 last_cache_line = ICACHE_LINES;
+  u32 trace_branch_count = 0;
 
   for (;;)
   {
@@ -539,8 +768,21 @@ bool CompileBlock(CodeBlock* block)
 
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
+    // or we're building a superblock, and the branch is always taken to a known target.
     if (is_branch_delay_slot && !cbi.is_branch_instruction)
-      break;
+    {
+      const CodeBlockInstruction& branch_cbi = block->instructions[block->instructions.size() - 2];
+      const u32 target = GetBranchInstructionTarget(branch_cbi.instruction, branch_cbi.pc);
+      if (!g_settings.cpu_recompiler_superblocks || trace_branch_count == MAX_TRACE_BRANCHES ||
+          !CanFollowBranchInTrace(block, branch_cbi, target))
+      {
+        break;
+      }
+
+      Log_DebugPrintf("Following branch at %08X to %08X in block %08X", branch_cbi.pc, target, block->GetPC());
+      trace_branch_count++;
+      pc = target;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = cbi.is_branch_instruction;
@@ -575,40 +817,153 @@ bool CompileBlock(CodeBlock* block)
     return false;
   }
 
+  return true;
+}
+
+bool CompileBlock(CodeBlock* block)
+{
+  if (!DecodeBlock(block))
+    return false;
+
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
   {
-    // Ensure we're not going to run out of space while compiling this block.
-    if (s_code_buffer.GetFreeCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
-        s_code_buffer.GetFreeFarCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
+    // With a compile threshold, blocks are interpreted until they're hot. Any old code is abandoned.
+    if (g_settings.cpu_recompiler_compile_threshold > 0)
     {
-      Log_WarningPrintf("Out of code space, flushing all blocks.");
-      Flush();
+      block->host_code = nullptr;
+      block->host_code_size = 0;
+      block->interpreted_count = 0;
+      return true;
     }
 
-    Recompiler::CodeGenerator codegen(&s_code_buffer);
-    if (!codegen.CompileBlock(block, &block->host_code, &block->host_code_size))
-    {
-      Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
+    // Ensure we're not going to run out of space while compiling this block.
+    if (!HasCodeSpaceForBlock(block))
+      EvictNextCodeRegion();
+
+    if (!CompileBlockHostCode(block))
       return false;
-    }
   }
 #endif
 
   return true;
 }
 
+bool CanFollowBranchInTrace(const CodeBlock* block, const CodeBlockInstruction& branch_cbi, u32 target)
+{
+  // Only branches which are always taken, and have a target known at compile time.
+  const Instruction branch = branch_cbi.instruction;
+  if (branch.op != InstructionOp::j && branch.op != InstructionOp::jal &&
+      (branch.op != InstructionOp::beq || branch.i.rs != Reg::zero || branch.i.rt != Reg::zero))
+  {
+    return false;
+  }
+
+  if (block->instructions.size() >= MAX_TRACE_INSTRUCTIONS)
+    return false;
+
+  // Stay within RAM or BIOS, so the code page tracking still works.
+  const PhysicalMemoryAddress target_address = target & PHYSICAL_MEMORY_ADDRESS_MASK;
+  const PhysicalMemoryAddress block_address = block->key.GetPCPhysicalAddress();
+  if ((target_address >= Bus::BIOS_BASE) != (block_address >= Bus::BIOS_BASE) ||
+      (!block->IsInRAM() && target_address < Bus::BIOS_BASE) ||
+      (block->IsInRAM() && target_address >= Bus::RAM_SIZE))
+  {
+    return false;
+  }
+
+  // Don't unroll loops, and keep the number of code pages the block depends on small.
+  const u32 target_page = target_address / HOST_PAGE_SIZE;
+  const u32 start_page = std::min(block->GetStartPageIndex(), target_page);
+  const u32 end_page = std::max(block->GetEndPageIndex(), target_page);
+  if ((end_page - start_page) >= MAX_TRACE_SPAN_PAGES)
+    return false;
+
+  return std::none_of(block->instructions.begin(), block->instructions.end(),
+                      [target](const CodeBlockInstruction& cbi) { return cbi.pc == target; });
+}
+
 #ifdef WITH_RECOMPILER
 
+bool HasCodeSpaceForBlock(const CodeBlock* block)
+{
+  // Code can't cross into the next region, otherwise it would be overwritten when that region is evicted.
+  const u32 region_code_end = s_code_region_start + ((s_current_code_region + 1) * s_code_region_size);
+  const u32 region_far_code_end = s_far_code_region_start + ((s_current_code_region + 1) * s_far_code_region_size);
+  return ((region_code_end - s_code_buffer.GetUsedCodeSpace()) >=
+            (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) &&
+          (region_far_code_end - s_code_buffer.GetUsedFarCodeSpace()) >=
+            (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION));
+}
+
+bool CompileBlockHostCode(CodeBlock* block)
+{
+  Recompiler::CodeGenerator codegen(&s_code_buffer);
+  if (!codegen.CompileBlock(block, &block->host_code, &block->host_code_size))
+  {
+    Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
+    block->host_code = nullptr;
+    block->host_code_size = 0;
+    return false;
+  }
+
+  return true;
+}
+
+void InterpretColdBlock(CodeBlock* block)
+{
+  if (g_settings.cpu_recompiler_icache)
+    CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
+
+  switch (g_settings.GetPGXPMode())
+  {
+    case PGXPMode::CPU:
+      InterpretCachedBlock<PGXPMode::CPU>(*block);
+      break;
+
+    case PGXPMode::Memory:
+      InterpretCachedBlock<PGXPMode::Memory>(*block);
+      break;
+
+    default:
+      InterpretCachedBlock<PGXPMode::Disabled>(*block);
+      break;
+  }
+}
+
 void FastCompileBlockFunction()
 {
   CodeBlock* block = LookupBlock(GetNextBlockKey());
-  if (block)
-    s_single_block_asm_dispatcher(block->host_code);
-  else
+  if (!block)
+  {
     InterpretUncachedBlock();
+    return;
+  }
+
+  if (!block->host_code)
+  {
+    // Blocks which only run a few times (e.g. during boot or loading) aren't worth compiling.
+    if (++block->interpreted_count <= g_settings.cpu_recompiler_compile_threshold)
+    {
+      InterpretColdBlock(block);
+      return;
+    }
+
+    if (!HasCodeSpaceForBlock(block))
+      EvictNextCodeRegion();
+
+    if (!CompileBlockHostCode(block))
+    {
+      InterpretColdBlock(block);
+      return;
+    }
+
+    Log_DebugPrintf("Compiled block at 0x%08X after %u executions", block->GetPC(), block->interpreted_count);
+    SetFastMap(block->GetPC(), block->host_code);
+    AddBlockToHostCodeMap(block);
+  }
+
+  s_single_block_asm_dispatcher(block->host_code);
 }
 
 #endif
@@ -616,20 +971,93 @@ void FastCompileBlockFunction()
 void InvalidateBlocksWithPageIndex(u32 page_index)
 {
   DebugAssert(page_index < Bus::RAM_CODE_PAGE_COUNT);
+  InvalidateBlocksInPageRange(page_index, page_index * HOST_PAGE_SIZE, (page_index + 1) * HOST_PAGE_SIZE);
+}
+
+void InvalidateBlocksInRAMRange(u32 start_offset, u32 end_offset)
+{
+  const u32 start_page = start_offset / HOST_PAGE_SIZE;
+  const u32 end_page = (end_offset - 1) / HOST_PAGE_SIZE;
+  for (u32 page = start_page; page <= end_page; page++)
+  {
+    if (!Bus::m_ram_code_bits[page])
+      continue;
+
+    const u32 page_start_offset = std::max<u32>(start_offset, page * HOST_PAGE_SIZE);
+    const u32 page_end_offset = std::min<u32>(end_offset, (page + 1) * HOST_PAGE_SIZE);
+    if (!HasCodeLinesInRange(page_start_offset, page_end_offset))
+    {
+      s_code_page_stats[page].ignored_writes++;
+      continue;
+    }
+
+    InvalidateBlocksInPageRange(page, page_start_offset, page_end_offset);
+  }
+}
+
+bool IsCodeAddress(u32 ram_offset)
+{
+  return s_ram_code_lines[(ram_offset & Bus::RAM_MASK) / CODE_LINE_SIZE];
+}
+
+void InvalidateBlocksInPageRange(u32 page_index, u32 start_offset, u32 end_offset)
+{
+  CodePageStats& stats = s_code_page_stats[page_index];
+  stats.invalidations++;
+
+  // Code lines are recomputed once for all the pages the invalidated blocks were on, not after every block.
+  u32 first_updated_page = page_index;
+  u32 last_updated_page = page_index;
+
   auto& blocks = m_ram_block_map[page_index];
-  for (CodeBlock* block : blocks)
+  for (size_t i = 0; i < blocks.size();)
   {
-    // Invalidate forces the block to be checked again.
+    CodeBlock* block = blocks[i];
+    if (!BlockHasCodeInRange(block, start_offset, end_offset))
+    {
+      i++;
+      continue;
+    }
+
+    // Invalidate forces the block to be checked again. It's removed from every page it's on, and will be re-added
+    // next execution. This also removes it from the current page's list.
     Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
+    first_updated_page = std::min(first_updated_page, block->GetStartPageIndex());
+    last_updated_page = std::max(last_updated_page, block->GetEndPageIndex());
+    RemoveBlockFromPageMap(block, false);
+    block->invalidated = true;
+    stats.invalidated_blocks++;
+#ifdef WITH_RECOMPILER
+    SetFastMap(block->GetPC(), FastCompileBlockFunction);
+#endif
+  }
+
+  for (u32 page = first_updated_page; page <= last_updated_page; page++)
+    UpdateCodeLinesForPage(page);
+
+  if (blocks.empty())
+    Bus::ClearRAMCodePage(page_index);
+}
+
+void InvalidateAll()
+{
+  for (const auto& it : s_blocks)
+  {
+    CodeBlock* block = it.second;
+    if (!block || block->invalidated)
+      continue;
+
     block->invalidated = true;
 #ifdef WITH_RECOMPILER
     SetFastMap(block->GetPC(), FastCompileBlockFunction);
 #endif
   }
 
-  // Block will be re-added next execution.
-  blocks.clear();
-  Bus::ClearRAMCodePage(page_index);
+  // Blocks will be re-added to the page map when they're revalidated.
+  for (auto& it : m_ram_block_map)
+    it.clear();
+  s_ram_code_lines.reset();
+  Bus::ClearRAMCodePageFlags();
 }
 
 void FlushBlock(CodeBlock* block)
@@ -643,7 +1071,7 @@ void FlushBlock(CodeBlock* block)
 #endif
 
   // if it's been invalidated it won't be in the page map
-  if (block->invalidated)
+  if (!block->invalidated)
     RemoveBlockFromPageMap(block);
 
   UnlinkBlock(block);
@@ -651,8 +1079,194 @@ void FlushBlock(CodeBlock* block)
   RemoveBlockFromHostCodeMap(block);
 #endif
 
+  CodeBlock*& table_entry = s_block_table[GetFastMapIndex(block->GetPC())];
+  if (table_entry == block)
+    table_entry = nullptr;
+
   s_blocks.erase(iter);
-  delete block;
+  FreeBlock(block);
+}
+
+CodeBlock* AllocateBlock(CodeBlockKey key)
+{
+  if (s_free_blocks.empty())
+  {
+    std::unique_ptr<CodeBlock[]> chunk = std::make_unique<CodeBlock[]>(BLOCK_POOL_CHUNK_SIZE);
+    s_free_blocks.reserve(s_free_blocks.size() + BLOCK_POOL_CHUNK_SIZE);
+    for (u32 i = 0; i < BLOCK_POOL_CHUNK_SIZE; i++)
+      s_free_blocks.push_back(&chunk[BLOCK_POOL_CHUNK_SIZE - 1 - i]);
+    s_block_pool_chunks.push_back(std::move(chunk));
+  }
+
+  CodeBlock* block = s_free_blocks.back();
+  s_free_blocks.pop_back();
+  block->key = key;
+  return block;
+}
+
+void FreeBlock(CodeBlock* block)
+{
+  block->Reset();
+  s_free_blocks.push_back(block);
+}
+
+u32 GetBlockCodeHash(const CodeBlock* block)
+{
+  uLong hash = crc32(0L, Z_NULL, 0);
+  for (const CodeBlockInstruction& cbi : block->instructions)
+    hash = crc32(hash, reinterpret_cast<const Bytef*>(&cbi.instruction.bits), sizeof(cbi.instruction.bits));
+
+  return static_cast<u32>(hash);
+}
+
+bool DoesProfiledBlockMatchMemory(const BlockProfileEntry& entry, CodeBlock* scratch_block)
+{
+  // Blocks aren't necessarily contiguous, due to branches in delay slots and superblocks, so decode it the same way
+  // it would be compiled.
+  scratch_block->Reset();
+  scratch_block->key.bits = entry.key;
+  return (DecodeBlock(scratch_block) && scratch_block->instructions.size() == entry.instruction_count &&
+          GetBlockCodeHash(scratch_block) == entry.code_hash);
+}
+
+bool LoadBlockProfile(const char* path)
+{
+  s_block_profile.clear();
+  s_block_profile_position = 0;
+
+  auto fp = FileSystem::OpenManagedCFile(path, "rb");
+  if (!fp)
+    return false;
+
+  BlockProfileHeader header;
+  if (std::fread(&header, sizeof(header), 1, fp.get()) != 1 || header.magic != BLOCK_PROFILE_MAGIC ||
+      header.version != BLOCK_PROFILE_VERSION || header.entry_count > MAX_PROFILED_BLOCKS)
+  {
+    Log_WarningPrintf("Block profile '%s' is invalid or from an older version, ignoring.", path);
+    return false;
+  }
+
+  s_block_profile.resize(header.entry_count);
+  if (header.entry_count > 0 &&
+      std::fread(s_block_profile.data(), sizeof(BlockProfileEntry), header.entry_count, fp.get()) !=
+        header.entry_count)
+  {
+    Log_WarningPrintf("Failed to read block profile '%s'", path);
+    s_block_profile.clear();
+    return false;
+  }
+
+  Log_InfoPrintf("Loaded %u profiled blocks from '%s'", header.entry_count, path);
+  return true;
+}
+
+bool SaveBlockProfile(const char* path)
+{
+  std::vector<BlockProfileEntry> entries;
+  entries.reserve(s_blocks.size() + s_block_profile.size());
+  for (const auto& it : s_blocks)
+  {
+    // Blocks which were never compiled didn't reach the compile threshold, so they're not worth keeping.
+    const CodeBlock* block = it.second;
+    if (!block || block->invalidated || (g_settings.IsUsingRecompiler() && !block->host_code))
+      continue;
+
+    entries.push_back(
+      BlockProfileEntry{block->key.bits, static_cast<u32>(block->instructions.size()), GetBlockCodeHash(block)});
+  }
+
+  // Keep blocks from previous sessions which weren't executed this time, e.g. later levels.
+  for (const BlockProfileEntry& entry : s_block_profile)
+  {
+    if (s_blocks.find(entry.key) == s_blocks.end())
+      entries.push_back(entry);
+  }
+
+  if (entries.empty())
+    return true;
+
+  if (entries.size() > MAX_PROFILED_BLOCKS)
+    entries.resize(MAX_PROFILED_BLOCKS);
+
+  std::sort(entries.begin(), entries.end(),
+            [](const BlockProfileEntry& lhs, const BlockProfileEntry& rhs) { return lhs.key < rhs.key; });
+
+  auto fp = FileSystem::OpenManagedCFile(path, "wb");
+  if (!fp)
+  {
+    Log_WarningPrintf("Failed to open block profile '%s' for writing", path);
+    return false;
+  }
+
+  const BlockProfileHeader header = {BLOCK_PROFILE_MAGIC, BLOCK_PROFILE_VERSION, static_cast<u32>(entries.size())};
+  if (std::fwrite(&header, sizeof(header), 1, fp.get()) != 1 ||
+      std::fwrite(entries.data(), sizeof(BlockProfileEntry), entries.size(), fp.get()) != entries.size())
+  {
+    Log_WarningPrintf("Failed to write block profile '%s'", path);
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote %zu profiled blocks to '%s'", entries.size(), path);
+  return true;
+}
+
+bool HasPendingProfiledBlocks()
+{
+#ifdef WITH_RECOMPILER
+  return (g_settings.IsUsingRecompiler() && s_block_profile_position < s_block_profile.size());
+#else
+  return false;
+#endif
+}
+
+void CompileProfiledBlocks(u64 max_time_ns)
+{
+#ifdef WITH_RECOMPILER
+  if (!g_settings.IsUsingRecompiler())
+    return;
+
+  Common::Timer timer;
+  const bool user_mode = InUserMode();
+  u32 compiled_blocks = 0;
+  CodeBlock scratch_block;
+  while (s_block_profile_position < s_block_profile.size())
+  {
+    // Don't fill the code buffer with blocks which may never run, they'd push out blocks which are.
+    if (s_evicted_code_region_count > 0 || s_current_code_region >= (CODE_REGION_COUNT * 3 / 4))
+    {
+      Log_DevPrintf("Code buffer is getting full, stopping ahead-of-time compilation");
+      s_block_profile_position = s_block_profile.size();
+      break;
+    }
+
+    const BlockProfileEntry& entry = s_block_profile[s_block_profile_position++];
+    CodeBlockKey key;
+    key.bits = entry.key;
+
+    // Trap checks depend on the current mode, so only compile blocks for the mode we're in.
+    if (key.user_mode != user_mode || s_blocks.find(key.bits) != s_blocks.end() ||
+        !DoesProfiledBlockMatchMemory(entry, &scratch_block))
+    {
+      continue;
+    }
+
+    // These blocks were hot last time, so don't wait for the compile threshold.
+    CodeBlock* block = CreateBlock(key);
+    if (block && !block->host_code && CompileBlockHostCode(block))
+    {
+      SetFastMap(block->GetPC(), block->host_code);
+      AddBlockToHostCodeMap(block);
+    }
+    if (block)
+      compiled_blocks++;
+
+    if (static_cast<u64>(timer.GetTimeNanoseconds()) >= max_time_ns)
+      break;
+  }
+
+  Log_DevPrintf("Compiled %u profiled blocks in %.3f ms, %zu remaining", compiled_blocks, timer.GetTimeMilliseconds(),
+                s_block_profile.size() - s_block_profile_position);
+#endif
 }
 
 void AddBlockToPageMap(CodeBlock* block)
@@ -667,9 +1281,12 @@ void AddBlockToPageMap(CodeBlock* block)
     m_ram_block_map[page].push_back(block);
     Bus::SetRAMCodePage(page);
   }
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
+    s_ram_code_lines[(cbi.pc & Bus::RAM_MASK) / CODE_LINE_SIZE] = true;
 }
 
-void RemoveBlockFromPageMap(CodeBlock* block)
+void RemoveBlockFromPageMap(CodeBlock* block, bool update_code_lines)
 {
   if (!block->IsInRAM())
     return;
@@ -682,9 +1299,126 @@ void RemoveBlockFromPageMap(CodeBlock* block)
     auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
     Assert(page_block_iter != page_blocks.end());
     page_blocks.erase(page_block_iter);
+    if (update_code_lines)
+      UpdateCodeLinesForPage(page);
   }
 }
 
+void UpdateCodeLinesForPage(u32 page_index)
+{
+  const u32 page_start_offset = page_index * HOST_PAGE_SIZE;
+  const u32 page_end_offset = std::min<u32>(page_start_offset + HOST_PAGE_SIZE, Bus::RAM_SIZE);
+  for (u32 offset = page_start_offset; offset < page_end_offset; offset += CODE_LINE_SIZE)
+    s_ram_code_lines[offset / CODE_LINE_SIZE] = false;
+
+  for (const CodeBlock* block : m_ram_block_map[page_index])
+  {
+    for (const CodeBlockInstruction& cbi : block->instructions)
+    {
+      const u32 offset = cbi.pc & Bus::RAM_MASK;
+      if (offset >= page_start_offset && offset < page_end_offset)
+        s_ram_code_lines[offset / CODE_LINE_SIZE] = true;
+    }
+  }
+}
+
+bool HasCodeLinesInRange(u32 start_offset, u32 end_offset)
+{
+  end_offset = std::min<u32>(end_offset, Bus::RAM_SIZE);
+  for (u32 line = start_offset / CODE_LINE_SIZE; line < ((end_offset + CODE_LINE_SIZE - 1) / CODE_LINE_SIZE); line++)
+  {
+    if (s_ram_code_lines[line])
+      return true;
+  }
+
+  return false;
+}
+
+bool BlockHasCodeInRange(const CodeBlock* block, u32 start_offset, u32 end_offset)
+{
+  // Compare whole lines, a write next to an instruction is likely to be followed by one to the instruction.
+  start_offset &= ~(CODE_LINE_SIZE - 1);
+  end_offset = (end_offset + (CODE_LINE_SIZE - 1)) & ~(CODE_LINE_SIZE - 1);
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const u32 offset = cbi.pc & Bus::RAM_MASK;
+    if (offset >= start_offset && offset < end_offset)
+      return true;
+  }
+
+  return false;
+}
+
+void DrawDebugStateWindow()
+{
+#ifdef WITH_IMGUI
+  static constexpr u32 NUM_COLUMNS = 5;
+  static constexpr u32 MAX_PAGES_SHOWN = 32;
+  static constexpr std::array<const char*, NUM_COLUMNS> column_names = {
+    {"Page", "Blocks", "Invalidations", "Blocks Invalidated", "Ignored Writes"}};
+
+  const float framebuffer_scale = ImGui::GetIO().DisplayFramebufferScale.x;
+
+  ImGui::SetNextWindowSize(ImVec2(600.0f * framebuffer_scale, 500.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Code Cache State", &g_settings.debugging.show_code_cache_state))
+  {
+    ImGui::End();
+    return;
+  }
+
+  ImGui::Text("Blocks: %zu", s_blocks.size());
+  ImGui::Text("Code Pages: %zu", Bus::m_ram_code_bits.count());
+  ImGui::Text("Code Lines: %zu (%u bytes each)", s_ram_code_lines.count(), CODE_LINE_SIZE);
+#ifdef WITH_RECOMPILER
+  if (g_settings.IsUsingRecompiler())
+  {
+    const CodeBufferStats stats = GetCodeBufferStats();
+    ImGui::Text("Compiled Blocks: %u (%u bytes)", stats.live_block_count, stats.live_code_bytes);
+    ImGui::Text("Evictions: %u regions, %u blocks", stats.evicted_region_count, stats.evicted_block_count);
+    ImGui::Text("Flushes: %u", stats.flush_count);
+  }
+#endif
+
+  std::vector<u32> pages;
+  for (u32 i = 0; i < Bus::RAM_CODE_PAGE_COUNT; i++)
+  {
+    if (s_code_page_stats[i].invalidations > 0 || s_code_page_stats[i].ignored_writes > 0)
+      pages.push_back(i);
+  }
+  std::sort(pages.begin(), pages.end(), [](u32 lhs, u32 rhs) {
+    return s_code_page_stats[lhs].invalidations > s_code_page_stats[rhs].invalidations;
+  });
+  if (pages.size() > MAX_PAGES_SHOWN)
+    pages.resize(MAX_PAGES_SHOWN);
+
+  ImGui::Separator();
+  ImGui::Columns(NUM_COLUMNS);
+  for (const char* title : column_names)
+  {
+    ImGui::TextUnformatted(title);
+    ImGui::NextColumn();
+  }
+
+  for (const u32 page : pages)
+  {
+    const CodePageStats& stats = s_code_page_stats[page];
+    ImGui::Text("%08X", static_cast<u32>(page * HOST_PAGE_SIZE));
+    ImGui::NextColumn();
+    ImGui::Text("%zu", m_ram_block_map[page].size());
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.invalidations);
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.invalidated_blocks);
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.ignored_writes);
+    ImGui::NextColumn();
+  }
+
+  ImGui::Columns(1);
+  ImGui::End();
+#endif
+}
+
 void LinkBlock(CodeBlock* from, CodeBlock* to)
 {
   Log_DebugPrintf("Linking block %p(%08x) to %p(%08x)", from, from->GetPC(), to, to->GetPC());
@@ -715,21 +1449,23 @@ void UnlinkBlock(CodeBlock* block)
 
 void AddBlockToHostCodeMap(CodeBlock* block)
 {
-  if (!g_settings.IsUsingRecompiler())
+  if (!g_settings.IsUsingRecompiler() || !block->host_code)
     return;
 
   auto ir = s_host_code_map.emplace(block->host_code, block);
   Assert(ir.second);
+  s_live_code_bytes += block->host_code_size;
 }
 
 void RemoveBlockFromHostCodeMap(CodeBlock* block)
 {
-  if (!g_settings.IsUsingRecompiler())
+  if (!g_settings.IsUsingRecompiler() || !block->host_code)
     return;
 
   HostCodeMap::iterator hc_iter = s_host_code_map.find(block->host_code);
   Assert(hc_iter != s_host_code_map.end());
   s_host_code_map.erase(hc_iter);
+  s_live_code_bytes -= block->host_code_size;
 }
 
 bool InitializeFastmem()
@@ -799,6 +1535,10 @@ Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc,
         const u32 code_page_index = Bus::GetRAMCodePageIndex(fastmem_address);
         if (Bus::IsRAMCodePage(code_page_index))
         {
+          // The page stays protected while it still has code on it, so the write can only be retried once every
+          // block on the page is invalidated. Stores which rarely hit code pages invalidate the whole page and stay
+          // on fastmem, the blocks are revalidated when they next run. Stores which keep hitting them go through
+          // slowmem instead, which only invalidates the blocks on the code lines written.
           if (++lbi.fault_count < CODE_WRITE_FAULT_THRESHOLD_FOR_SLOWMEM)
           {
             InvalidateBlocksWithPageIndex(code_page_index);
@@ -4,6 +4,7 @@
 #include "common/jit_code_buffer.h"
 #include "common/page_fault_handler.h"
 #include "cpu_types.h"
+#include <algorithm>
 #include <array>
 #include <map>
 #include <memory>
@@ -66,9 +67,10 @@ struct CodeBlock
 {
   using HostCodePointer = void (*)();
 
+  CodeBlock() = default;
   CodeBlock(const CodeBlockKey key_) : key(key_) {}
 
-  CodeBlockKey key;
+  CodeBlockKey key = {};
   u32 host_code_size = 0;
   HostCodePointer host_code = nullptr;
 
@@ -79,6 +81,9 @@ struct CodeBlock
   TickCount uncached_fetch_ticks = 0;
   u32 icache_line_count = 0;
 
+  /// Number of times the block has been interpreted while waiting to be compiled.
+  u32 interpreted_count = 0;
+
 #ifdef WITH_RECOMPILER
   std::vector<Recompiler::LoadStoreBackpatchInfo> loadstore_backpatch_info;
 #endif
@@ -89,16 +94,46 @@ struct CodeBlock
 
   const u32 GetPC() const { return key.GetPC(); }
   const u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
-  const u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE); }
+  const u32 GetStartPageIndex() const
+  {
+    // Blocks aren't necessarily contiguous, due to branches in delay slots and superblocks.
+    u32 start_address = key.GetPCPhysicalAddress();
+    for (const CodeBlockInstruction& cbi : instructions)
+      start_address = std::min(start_address, cbi.pc & PHYSICAL_MEMORY_ADDRESS_MASK);
+    return (start_address / HOST_PAGE_SIZE);
+  }
   const u32 GetEndPageIndex() const
   {
-    return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / HOST_PAGE_SIZE);
+    u32 end_address = key.GetPCPhysicalAddress() + GetSizeInBytes();
+    for (const CodeBlockInstruction& cbi : instructions)
+      end_address = std::max<u32>(end_address, (cbi.pc & PHYSICAL_MEMORY_ADDRESS_MASK) + sizeof(Instruction));
+    return (end_address / HOST_PAGE_SIZE);
   }
   bool IsInRAM() const
   {
     // TODO: Constant
     return key.GetPCPhysicalAddress() < 0x200000;
   }
+
+  /// Clears the block for reuse, keeping the storage of the vectors.
+  void Reset()
+  {
+    key.bits = 0;
+    host_code_size = 0;
+    host_code = nullptr;
+    instructions.clear();
+    link_predecessors.clear();
+    link_successors.clear();
+    uncached_fetch_ticks = 0;
+    icache_line_count = 0;
+    interpreted_count = 0;
+#ifdef WITH_RECOMPILER
+    loadstore_backpatch_info.clear();
+#endif
+    contains_loadstore_instructions = false;
+    contains_double_branches = false;
+    invalidated = false;
+  }
 };
 
 namespace CodeCache {
@@ -111,24 +146,65 @@ void Execute();
 using DispatcherFunction = void (*)();
 using SingleBlockDispatcherFunction = void(*)(const CodeBlock::HostCodePointer);
 
+struct CodeBufferStats
+{
+  u32 flush_count;
+  u32 evicted_region_count;
+  u32 evicted_block_count;
+  u32 live_block_count;
+  u32 live_code_bytes;
+  u32 code_region_size;
+};
+
 CodeBlock::HostCodePointer* GetFastMapPointer();
 void ExecuteRecompiler();
+
+/// Returns counters for the recompiler code buffer, for tuning its size.
+CodeBufferStats GetCodeBufferStats();
 #endif
 
+/// Reads the instructions for the block at the key's address, following branches when superblocks are enabled.
+/// The block isn't compiled or added to the cache.
+bool DecodeBlock(CodeBlock* block);
+
 /// Flushes the code cache, forcing all blocks to be recompiled.
 void Flush();
 
 /// Changes whether the recompiler is enabled.
 void Reinitialize();
 
+/// Invalidates all blocks, forcing them to be checked for changes before next execution.
+void InvalidateAll();
+
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates blocks with code in the specified range of RAM. Writes to parts of code pages without code are ignored.
+void InvalidateBlocksInRAMRange(u32 start_offset, u32 end_offset);
+
+/// Returns true if the code line containing the RAM offset has any code in it.
+bool IsCodeAddress(u32 ram_offset);
+
+/// Draws the code cache page statistics window.
+void DrawDebugStateWindow();
+
+/// Loads the list of blocks which were compiled in a previous session, so they can be compiled ahead of time.
+bool LoadBlockProfile(const char* path);
+
+/// Writes the list of blocks compiled in this session, and any profiled blocks which weren't reached.
+bool SaveBlockProfile(const char* path);
+
+/// Returns true if there are profiled blocks remaining which can be compiled ahead of time.
+bool HasPendingProfiledBlocks();
+
+/// Compiles profiled blocks whose code is present in memory, until the time limit is reached.
+void CompileProfiledBlocks(u64 max_time_ns);
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block);
 void InterpretUncachedBlock();
 
-/// Invalidates any code pages which overlap the specified range.
+/// Invalidates any code which overlaps the specified range.
 ALWAYS_INLINE void InvalidateCodePages(PhysicalMemoryAddress address, u32 word_count)
 {
   const u32 start_page = address / HOST_PAGE_SIZE;
@@ -136,7 +212,10 @@ ALWAYS_INLINE void InvalidateCodePages(PhysicalMemoryAddress address, u32 word_c
   for (u32 page = start_page; page <= end_page; page++)
   {
     if (Bus::m_ram_code_bits[page])
-      CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
+    {
+      CPU::CodeCache::InvalidateBlocksInRAMRange(address, address + word_count * sizeof(u32));
+      return;
+    }
   }
 }
 
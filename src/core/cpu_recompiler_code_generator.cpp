@@ -27,6 +27,7 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
   m_block_start = block->instructions.data();
   m_block_end = block->instructions.data() + block->instructions.size();
 
+  AnalyzeBlock();
   EmitBeginBlock();
   BlockPrologue();
 
@@ -39,8 +40,12 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
     Log_DebugPrintf("Compiling instruction '%s'", disasm.GetCharArray());
 #endif
 
+    // Following a superblock branch, current_instruction_pc is now relative to the branch target.
+    if (cbi != m_block_start && (cbi - 1)->is_branch_delay_slot && !(cbi - 1)->is_branch_instruction)
+      EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(cbi->pc));
+
     m_current_instruction = cbi;
-    if (!CompileInstruction(*cbi))
+    if (!(IsCurrentInstructionResultUnused() ? Compile_UnusedResult(*cbi) : CompileInstruction(*cbi)))
     {
       m_current_instruction = nullptr;
       m_block_end = nullptr;
@@ -68,6 +73,272 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
   return true;
 }
 
+/// Returns the registers read and written by an instruction, and the destination if writing it is the only effect.
+/// Delayed writes aren't included, because the old value is still visible to the next instruction. Returns false
+/// if the instruction isn't compiled natively, so the interpreter could access any register or flag.
+static bool GetInstructionRegisterUsage(const Instruction& instruction, u64* reads, u64* writes, Reg* pure_dest)
+{
+  const auto RB = [](Reg reg) { return (reg == Reg::zero) ? UINT64_C(0) : (UINT64_C(1) << static_cast<u8>(reg)); };
+  *reads = 0;
+  *writes = 0;
+  *pure_dest = Reg::count;
+
+  switch (instruction.op)
+  {
+    case InstructionOp::lui:
+      *writes = RB(instruction.i.rt);
+      *pure_dest = instruction.i.rt;
+      return true;
+
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+      *reads = RB(instruction.i.rs);
+      *writes = RB(instruction.i.rt);
+      *pure_dest = instruction.i.rt;
+      return true;
+
+    case InstructionOp::addi:
+      *reads = RB(instruction.i.rs);
+      *writes = RB(instruction.i.rt);
+      return true;
+
+    case InstructionOp::lb:
+    case InstructionOp::lbu:
+    case InstructionOp::lh:
+    case InstructionOp::lhu:
+    case InstructionOp::lw:
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      *reads = RB(instruction.i.rs);
+      return true;
+
+    case InstructionOp::lwl:
+    case InstructionOp::lwr:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    case InstructionOp::swl:
+    case InstructionOp::swr:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+      *reads = RB(instruction.i.rs) | RB(instruction.i.rt);
+      return true;
+
+    case InstructionOp::b:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      // The link for bltzal/bgezal is left out, which is conservative.
+      *reads = RB(instruction.i.rs);
+      return true;
+
+    case InstructionOp::j:
+      return true;
+
+    case InstructionOp::jal:
+      *writes = RB(Reg::ra);
+      return true;
+
+    case InstructionOp::cop2:
+    {
+      if (!instruction.cop.IsCommonInstruction())
+        return true;
+
+      switch (instruction.cop.CommonOp())
+      {
+        case CopCommonInstruction::mfcn:
+        case CopCommonInstruction::cfcn:
+          return true;
+
+        case CopCommonInstruction::mtcn:
+        case CopCommonInstruction::ctcn:
+          *reads = RB(instruction.r.rt);
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          *reads = RB(instruction.r.rt);
+          *writes = RB(instruction.r.rd);
+          *pure_dest = instruction.r.rd;
+          return true;
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          *reads = RB(instruction.r.rs) | RB(instruction.r.rt);
+          *writes = RB(instruction.r.rd);
+          *pure_dest = instruction.r.rd;
+          return true;
+
+        case InstructionFunct::add:
+        case InstructionFunct::sub:
+          *reads = RB(instruction.r.rs) | RB(instruction.r.rt);
+          *writes = RB(instruction.r.rd);
+          return true;
+
+        case InstructionFunct::mfhi:
+          *reads = RB(Reg::hi);
+          *writes = RB(instruction.r.rd);
+          *pure_dest = instruction.r.rd;
+          return true;
+
+        case InstructionFunct::mflo:
+          *reads = RB(Reg::lo);
+          *writes = RB(instruction.r.rd);
+          *pure_dest = instruction.r.rd;
+          return true;
+
+        case InstructionFunct::mthi:
+          *reads = RB(instruction.r.rs);
+          *writes = RB(Reg::hi);
+          *pure_dest = Reg::hi;
+          return true;
+
+        case InstructionFunct::mtlo:
+          *reads = RB(instruction.r.rs);
+          *writes = RB(Reg::lo);
+          *pure_dest = Reg::lo;
+          return true;
+
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::div:
+        case InstructionFunct::divu:
+          *reads = RB(instruction.r.rs) | RB(instruction.r.rt);
+          *writes = RB(Reg::hi) | RB(Reg::lo);
+          return true;
+
+        case InstructionFunct::jr:
+          *reads = RB(instruction.r.rs);
+          return true;
+
+        case InstructionFunct::jalr:
+          *reads = RB(instruction.r.rs);
+          *writes = RB(instruction.r.rd);
+          return true;
+
+        case InstructionFunct::syscall:
+        case InstructionFunct::break_:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    default:
+      return false;
+  }
+}
+
+void CodeGenerator::AnalyzeBlock()
+{
+  // Registers which can be tracked. $zero never changes, and the pc is always needed.
+  static constexpr u64 TRACKED_REGS =
+    ((UINT64_C(1) << static_cast<u8>(Reg::pc)) - 1) & ~(UINT64_C(1) << static_cast<u8>(Reg::zero));
+
+  // Walk the block backwards. Everything is live at the end of the block, since the next block could read it.
+  const u32 count = static_cast<u32>(m_block->instructions.size());
+  m_liveness.resize(count + 1);
+  m_liveness[count] = {};
+
+  u64 live_regs = TRACKED_REGS;
+  bool flags_live = false;
+  u32 unused_results = 0;
+  for (u32 i = count; i > 0; i--)
+  {
+    const CodeBlockInstruction& cbi = m_block->instructions[i - 1];
+    InstructionLiveness& il = m_liveness[i - 1];
+
+    u64 reads, writes;
+    Reg pure_dest;
+    const bool native = GetInstructionRegisterUsage(cbi.instruction, &reads, &writes, &pure_dest);
+
+    // Memory exceptions use the register file, and so do exceptions raised by the instruction itself.
+    bool can_raise_exception;
+    if (cbi.is_load_instruction || cbi.is_store_instruction)
+    {
+      can_raise_exception =
+        g_settings.cpu_recompiler_memory_exceptions || (cbi.instruction.IsCop2Instruction() && cbi.can_trap);
+    }
+    else if (cbi.instruction.op == InstructionOp::funct &&
+             (cbi.instruction.r.funct == InstructionFunct::jr || cbi.instruction.r.funct == InstructionFunct::jalr))
+    {
+      can_raise_exception = g_settings.cpu_recompiler_memory_exceptions;
+    }
+    else
+    {
+      can_raise_exception = cbi.can_trap;
+    }
+
+    il.result_unused = false;
+    if (!native || can_raise_exception)
+    {
+      live_regs = TRACKED_REGS;
+    }
+    else if (pure_dest != Reg::count && pure_dest != Reg::zero &&
+             (live_regs & (UINT64_C(1) << static_cast<u8>(pure_dest))) == 0)
+    {
+      // Nothing reads the result, so the instruction's reads don't count either.
+      il.result_unused = true;
+      unused_results++;
+    }
+    else
+    {
+      live_regs = (live_regs & ~writes) | reads;
+    }
+
+    flags_live |= !native;
+    il.dead_regs = ~live_regs & TRACKED_REGS;
+    il.flags_live = flags_live;
+  }
+
+  if (unused_results > 0)
+    Log_ProfilePrintf("Skipping %u instructions with unused results in block 0x%08X", unused_results, m_block->GetPC());
+}
+
+bool CodeGenerator::IsGuestRegisterDead(Reg reg) const
+{
+  if (!m_current_instruction)
+    return false;
+
+  // The register has to be dead both before and after the instruction, since it could've just been written.
+  const size_t index = static_cast<size_t>(m_current_instruction - m_block_start);
+  const u64 bit = UINT64_C(1) << static_cast<u8>(reg);
+  return ((m_liveness[index].dead_regs & m_liveness[index + 1].dead_regs & bit) != 0);
+}
+
+bool CodeGenerator::IsCurrentInstructionResultUnused() const
+{
+  return m_liveness[static_cast<size_t>(m_current_instruction - m_block_start)].result_unused;
+}
+
+bool CodeGenerator::AreBranchFlagsLive() const
+{
+  return m_liveness[static_cast<size_t>(m_current_instruction - m_block_start)].flags_live;
+}
+
 bool CodeGenerator::CompileInstruction(const CodeBlockInstruction& cbi)
 {
   bool result;
@@ -910,11 +1181,14 @@ void CodeGenerator::BlockPrologue()
 
   // we don't know the state of the last block, so assume load delays might be in progress
   // TODO: Pull load delay into register cache
-  m_current_instruction_in_branch_delay_slot_dirty = g_settings.cpu_recompiler_memory_exceptions;
   m_branch_was_taken_dirty = g_settings.cpu_recompiler_memory_exceptions;
-  m_current_instruction_was_branch_taken_dirty = false;
   m_load_delay_dirty = true;
 
+  // the interpreter sets the current instruction flags for every instruction, and blocks only reset them where a
+  // fallback could read them, so they can be left set by whatever ran before
+  m_current_instruction_in_branch_delay_slot_dirty = true;
+  m_current_instruction_was_branch_taken_dirty = true;
+
   m_pc_offset = 0;
   m_current_instruction_pc_offset = 0;
   m_next_pc_offset = 4;
@@ -945,23 +1219,28 @@ void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCou
   m_pc_offset = m_next_pc_offset;
   m_next_pc_offset += 4;
 
-  // reset dirty flags
+  // reset dirty flags, the current instruction flags are only read by the interpreter so they can be left stale
+  // when there's no fallback in the rest of the block
+  const bool flags_live = AreBranchFlagsLive();
   if (m_branch_was_taken_dirty)
   {
-    Value temp = m_register_cache.AllocateScratch(RegSize_8);
-    EmitLoadCPUStructField(temp.host_reg, RegSize_8, offsetof(State, branch_was_taken));
-    EmitStoreCPUStructField(offsetof(State, current_instruction_was_branch_taken), temp);
+    if (flags_live)
+    {
+      Value temp = m_register_cache.AllocateScratch(RegSize_8);
+      EmitLoadCPUStructField(temp.host_reg, RegSize_8, offsetof(State, branch_was_taken));
+      EmitStoreCPUStructField(offsetof(State, current_instruction_was_branch_taken), temp);
+      m_current_instruction_was_branch_taken_dirty = true;
+    }
     EmitStoreCPUStructField(offsetof(State, branch_was_taken), Value::FromConstantU8(0));
-    m_current_instruction_was_branch_taken_dirty = true;
     m_branch_was_taken_dirty = false;
   }
-  else if (m_current_instruction_was_branch_taken_dirty)
+  else if (m_current_instruction_was_branch_taken_dirty && flags_live)
   {
     EmitStoreCPUStructField(offsetof(State, current_instruction_was_branch_taken), Value::FromConstantU8(0));
     m_current_instruction_was_branch_taken_dirty = false;
   }
 
-  if (m_current_instruction_in_branch_delay_slot_dirty && !cbi.is_branch_delay_slot)
+  if (m_current_instruction_in_branch_delay_slot_dirty && !cbi.is_branch_delay_slot && flags_live)
   {
     EmitStoreCPUStructField(offsetof(State, current_instruction_in_branch_delay_slot), Value::FromConstantU8(0));
     m_current_instruction_in_branch_delay_slot_dirty = false;
@@ -974,7 +1253,7 @@ void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCou
     return;
   }
 
-  if (cbi.is_branch_delay_slot && g_settings.cpu_recompiler_memory_exceptions)
+  if (cbi.is_branch_delay_slot && g_settings.cpu_recompiler_memory_exceptions && flags_live)
   {
     // m_current_instruction_in_branch_delay_slot = true
     EmitStoreCPUStructField(offsetof(State, current_instruction_in_branch_delay_slot), Value::FromConstantU8(1));
@@ -1100,6 +1379,20 @@ bool CodeGenerator::Compile_Fallback(const CodeBlockInstruction& cbi)
   return true;
 }
 
+bool CodeGenerator::Compile_UnusedResult(const CodeBlockInstruction& cbi)
+{
+  InstructionPrologue(cbi, 1);
+
+  // The destination is overwritten before it's read, so only the speculative value needs updating.
+  u64 reads, writes;
+  Reg dest;
+  GetInstructionRegisterUsage(cbi.instruction, &reads, &writes, &dest);
+  SpeculativeWriteReg(dest, std::nullopt);
+
+  InstructionEpilogue(cbi);
+  return true;
+}
+
 bool CodeGenerator::Compile_Bitwise(const CodeBlockInstruction& cbi)
 {
   InstructionPrologue(cbi, 1);
@@ -2377,7 +2670,7 @@ Value CodeGenerator::DoGTERegisterRead(u32 index)
 
     default:
     {
-      EmitLoadCPUStructField(value.host_reg, RegSize_32, offsetof(State, gte_regs.r32[index]));
+      EmitLoadCPUStructField(value.host_reg, RegSize_32, offsetof(State, gte_regs.r32[0]) + (index * sizeof(u32)));
     }
     break;
   }
@@ -2406,7 +2699,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // sign-extend z component of vector registers
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, true);
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), temp);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (index * sizeof(u32)), temp);
       return;
     }
     break;
@@ -2419,7 +2712,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // zero-extend unsigned values
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, false);
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), temp);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (index * sizeof(u32)), temp);
       return;
     }
     break;
@@ -2461,7 +2754,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     default:
     {
       // written as-is, 2x16 or 1x32 bits
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), value);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (index * sizeof(u32)), value);
       return;
     }
   }
@@ -2564,11 +2857,14 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
   }
   else
   {
-    // forward everything to the GTE.
+    // forward everything to the GTE, unless the backend can do it inline.
     InstructionPrologue(cbi, 1);
 
-    Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
-    EmitFunctionCall(nullptr, GTE::GetInstructionImpl(cbi.instruction.bits), instruction_bits);
+    if (!EmitGTEInstruction(cbi.instruction.bits))
+    {
+      Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
+      EmitFunctionCall(nullptr, GTE::GetInstructionImpl(cbi.instruction.bits), instruction_bits);
+    }
 
     InstructionEpilogue(cbi);
     return true;
@@ -29,6 +29,9 @@ public:
 
   bool CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
 
+  /// Returns true if the guest register's current value is never read again, so it can be dropped without a store.
+  bool IsGuestRegisterDead(Reg reg) const;
+
   CodeCache::DispatcherFunction CompileDispatcher();
   CodeCache::SingleBlockDispatcherFunction CompileSingleBlockDispatcher();
 
@@ -72,6 +75,9 @@ public:
   void EmitMoveNextInterpreterLoadDelay();
   void EmitCancelInterpreterLoadDelayForReg(Reg reg);
   void EmitICacheCheckAndUpdate();
+
+  /// Emits native code for a GTE command. Returns false if it has to be forwarded to the GTE instead.
+  bool EmitGTEInstruction(u32 instruction_bits);
   void EmitLoadCPUStructField(HostReg host_reg, RegSize size, u32 offset);
   void EmitStoreCPUStructField(u32 offset, const Value& value);
   void EmitAddCPUStructField(u32 offset, const Value& value);
@@ -228,6 +234,26 @@ private:
   bool Compile_lui(const CodeBlockInstruction& cbi);
   bool Compile_cop0(const CodeBlockInstruction& cbi);
   bool Compile_cop2(const CodeBlockInstruction& cbi);
+  bool Compile_UnusedResult(const CodeBlockInstruction& cbi);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Block Analysis
+  //////////////////////////////////////////////////////////////////////////
+  struct InstructionLiveness
+  {
+    /// Guest registers whose value before the instruction is overwritten without being read.
+    u64 dead_regs;
+
+    /// The instruction only writes a register which is never read, so it can be skipped.
+    bool result_unused;
+
+    /// An interpreter fallback at or after the instruction could read the branch/delay slot flags.
+    bool flags_live;
+  };
+
+  void AnalyzeBlock();
+  bool IsCurrentInstructionResultUnused() const;
+  bool AreBranchFlagsLive() const;
 
   JitCodeBuffer* m_code_buffer;
   CodeBlock* m_block = nullptr;
@@ -251,6 +277,8 @@ private:
   bool m_load_delay_dirty = false;
   bool m_next_load_delay_dirty = false;
 
+  std::vector<InstructionLiveness> m_liveness;
+
   bool m_fastmem_load_base_in_register = false;
   bool m_fastmem_store_base_in_register = false;
 
@@ -197,6 +197,11 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
   m_register_cache.UninhibitAllocation();
 }
 
+bool CodeGenerator::EmitGTEInstruction(u32 instruction_bits)
+{
+  return false;
+}
+
 #endif
 
 } // namespace CPU::Recompiler
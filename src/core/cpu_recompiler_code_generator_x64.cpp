@@ -5,6 +5,7 @@
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
 #include "cpu_recompiler_thunks.h"
+#include "gte.h"
 #include "settings.h"
 #include "timing_event.h"
 Log_SetChannel(Recompiler::CodeGenerator);
@@ -2626,6 +2627,525 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
   m_register_cache.UninhibitAllocation();
 }
 
+static u32 GetGTERegisterOffset(u32 index)
+{
+  return static_cast<u32>(offsetof(State, gte_regs.r32[0]) + (index * sizeof(u32)));
+}
+
+/// Sets the overflow/underflow flag bits when the value doesn't fit in MAC0 (31 bits) or MAC1-3 (43 bits).
+static void EmitGTECheckMACOverflow(CodeEmitter* emit, const Xbyak::Reg64& value, const Xbyak::Reg64& temp,
+                                    const Xbyak::Reg32& flags, u32 index)
+{
+  const u32 overflow_bit = (index == 0) ? 16 : (31 - index);
+  const u32 underflow_bit = (index == 0) ? 15 : (28 - index);
+
+  // in range when the bits above the sign bit are all zeros or all ones, i.e. (value >> bits) + 1 <= 1
+  Xbyak::Label in_range, underflow;
+  emit->mov(temp, value);
+  emit->sar(temp, (index == 0) ? 31 : 43);
+  emit->add(temp, 1);
+  emit->cmp(temp, 1);
+  emit->jbe(in_range);
+  emit->test(temp, temp);
+  emit->js(underflow);
+  emit->or_(flags, UINT32_C(1) << overflow_bit);
+  emit->jmp(in_range);
+  emit->L(underflow);
+  emit->or_(flags, UINT32_C(1) << underflow_bit);
+  emit->L(in_range);
+}
+
+/// Clamps a signed value to [min_value, max_value], setting the flag bit if it was outside the range.
+static void EmitGTESaturate(CodeEmitter* emit, const Xbyak::Reg32& value, const Xbyak::Reg32& flags, s32 min_value,
+                            s32 max_value, u32 flag_bit)
+{
+  Xbyak::Label not_above, done;
+  emit->cmp(value, max_value);
+  emit->jle(not_above);
+  emit->mov(value, max_value);
+  emit->or_(flags, UINT32_C(1) << flag_bit);
+  emit->jmp(done);
+  emit->L(not_above);
+  emit->cmp(value, min_value);
+  emit->jge(done);
+  emit->mov(value, min_value);
+  emit->or_(flags, UINT32_C(1) << flag_bit);
+  emit->L(done);
+}
+
+/// Clamps an IR1-3 value to 16 bits (or 15 bits with lm set), setting the saturation flag bit.
+static void EmitGTESaturateIR(CodeEmitter* emit, const Xbyak::Reg32& value, const Xbyak::Reg32& flags, u32 index,
+                              bool lm)
+{
+  EmitGTESaturate(emit, value, flags, lm ? 0 : -0x8000, 0x7FFF, 25 - index);
+}
+
+/// Computes the UNR reciprocal division in RTPS, result = min((lhs * 20000h / rhs + 1) / 2, 1FFFFh). lhs and rhs are
+/// 16-bit, and are clobbered along with temp.
+static void EmitGTEDivide(CodeEmitter* emit, const Xbyak::Reg64& result, const Xbyak::Reg64& lhs,
+                          const Xbyak::Reg64& rhs, const Xbyak::Reg64& temp, const Xbyak::Reg32& flags)
+{
+  const Xbyak::Reg32 result32 = result.cvt32();
+  const Xbyak::Reg32 lhs32 = lhs.cvt32();
+  const Xbyak::Reg32 rhs32 = rhs.cvt32();
+  const Xbyak::Reg32 temp32 = temp.cvt32();
+
+  Xbyak::Label no_overflow, done;
+  emit->lea(temp32, emit->ptr[rhs + rhs]);
+  emit->cmp(temp32, lhs32);
+  emit->ja(no_overflow);
+  emit->or_(flags, UINT32_C(1) << 17);
+  emit->mov(result32, 0x1FFFF);
+  emit->jmp(done, Xbyak::CodeGenerator::T_NEAR);
+
+  // normalize so the divisor has bit 15 set, rhs can't be zero here
+  emit->L(no_overflow);
+  emit->bsr(temp32, rhs32);
+  emit->neg(temp32);
+  emit->add(temp32, 15);
+  emit->xor_(result32, result32);
+  emit->bts(result32, temp32);
+  emit->imul(lhs32, result32);
+  emit->imul(rhs32, result32);
+
+  // x = 101h + table[((divisor & 7FFFh) + 40h) >> 7]
+  emit->mov(temp32, rhs32);
+  emit->and_(temp32, 0x7FFF);
+  emit->add(temp32, 0x40);
+  emit->shr(temp32, 7);
+  emit->mov(result, reinterpret_cast<size_t>(GTE::GetUNRTable()));
+  emit->movzx(temp32, emit->byte[result + temp]);
+  emit->add(temp32, 0x101);
+
+  // d = ((divisor * -x) + 80h) >> 8, recip = ((x * (20000h + d)) + 80h) >> 8
+  emit->mov(result32, temp32);
+  emit->neg(result32);
+  emit->imul(result32, rhs32);
+  emit->add(result32, 0x80);
+  emit->sar(result32, 8);
+  emit->add(result32, 0x20000);
+  emit->imul(result32, temp32);
+  emit->add(result32, 0x80);
+  emit->sar(result32, 8);
+
+  // result = ((lhs * recip) + 8000h) >> 16, both zero-extended by the 32-bit operations above
+  emit->imul(result, lhs);
+  emit->add(result, 0x8000);
+  emit->shr(result, 16);
+  emit->cmp(result32, 0x1FFFF);
+  emit->jbe(done);
+  emit->mov(result32, 0x1FFFF);
+  emit->L(done);
+}
+
+/// Sets the error flag bit if any of bits 30-23 or 18-13 are set.
+static void EmitGTEUpdateError(CodeEmitter* emit, const Xbyak::Reg32& flags, const Xbyak::Reg32& temp)
+{
+  emit->mov(temp, flags);
+  emit->or_(temp, UINT32_C(0x80000000));
+  emit->test(flags, UINT32_C(0x7F87E000));
+  emit->cmovnz(flags, temp);
+}
+
+bool CodeGenerator::EmitGTEInstruction(u32 instruction_bits)
+{
+  const GTE::Instruction inst{instruction_bits};
+  switch (inst.command)
+  {
+    case 0x06: // NCLIP
+    case 0x2D: // AVSZ3
+    case 0x2E: // AVSZ4
+    case 0x28: // SQR
+    case 0x13: // NCDS
+    case 0x16: // NCDT
+      break;
+
+    case 0x01: // RTPS
+    case 0x30: // RTPT
+    {
+      // PGXP and the widescreen hack change the projection
+      if (g_settings.gpu_pgxp_enable || g_settings.gpu_widescreen_hack)
+        return false;
+    }
+    break;
+
+    case 0x12: // MVMVA
+    {
+      // the buggy far color matrix and translation are left to the interpreter
+      if (inst.mvmva_multiply_matrix == 3 || inst.mvmva_translation_vector == 2)
+        return false;
+    }
+    break;
+
+    default:
+      return false;
+  }
+
+  // PGXP replaces NCLIP with its own calculation for culling
+  if (inst.command == 0x06 && g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
+    return false;
+
+  Value acc = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  Value product = m_register_cache.AllocateScratch(RegSize_64);
+  Value flags = m_register_cache.AllocateScratch(RegSize_32);
+  const Xbyak::Reg64 acc64 = GetHostReg64(acc);
+  const Xbyak::Reg32 acc32 = GetHostReg32(acc.host_reg);
+  const Xbyak::Reg64 temp64 = GetHostReg64(temp);
+  const Xbyak::Reg32 temp32 = GetHostReg32(temp.host_reg);
+  const Xbyak::Reg64 product64 = GetHostReg64(product);
+  const Xbyak::Reg32 product32 = GetHostReg32(product.host_reg);
+  const Xbyak::Reg32 flags32 = GetHostReg32(flags);
+  const auto gte_word = [this](u32 index, u32 half = 0) {
+    return m_emit->word[GetCPUPtrReg() + GetGTERegisterOffset(index) + (half * sizeof(u16))];
+  };
+  const auto gte_dword = [this](u32 index) { return m_emit->dword[GetCPUPtrReg() + GetGTERegisterOffset(index)]; };
+
+  // RTPS/RTPT and NCDS/NCDT need a couple more registers.
+  const bool needs_extra_regs = (inst.command == 0x01 || inst.command == 0x30 || inst.command == 0x13 ||
+                                 inst.command == 0x16);
+  Value extra, extra2;
+  if (needs_extra_regs)
+  {
+    extra = m_register_cache.AllocateScratch(RegSize_64);
+    extra2 = m_register_cache.AllocateScratch(RegSize_64);
+  }
+
+  // MACn = (T << 12) + M[n][0] * Vx + M[n][1] * Vy + M[n][2] * Vz, overflow is checked after each addition.
+  // The matrices are at 32 (RT), 40 (LLM), 48 (LCM). The unshifted MAC3 is kept for RTPS.
+  const auto emit_mul_mat_vec = [&](u32 matrix_index, std::optional<u32> translation_index, const auto& vector_element,
+                                    const Xbyak::Reg64* unshifted_mac3) {
+    const u32 matrix_offset = GetGTERegisterOffset(matrix_index);
+    for (u32 i = 0; i < 3; i++)
+    {
+      if (translation_index.has_value())
+      {
+        m_emit->movsxd(acc64, gte_dword(translation_index.value() + i));
+        m_emit->shl(acc64, 12);
+      }
+      else
+      {
+        m_emit->xor_(acc32, acc32);
+      }
+
+      for (u32 j = 0; j < 3; j++)
+      {
+        m_emit->movsx(product32, m_emit->word[GetCPUPtrReg() + matrix_offset + (((i * 3) + j) * sizeof(u16))]);
+        m_emit->movsx(temp32, vector_element(j));
+        m_emit->imul(product32, temp32);
+        m_emit->movsxd(product64, product32);
+        m_emit->add(acc64, product64);
+        EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, i + 1);
+        if (j < 2)
+        {
+          // sign-extend from 44 bits
+          m_emit->shl(acc64, 20);
+          m_emit->sar(acc64, 20);
+        }
+      }
+
+      if (i == 2 && unshifted_mac3)
+        m_emit->mov(*unshifted_mac3, acc64);
+      if (inst.sf)
+        m_emit->sar(acc64, 12);
+      m_emit->mov(gte_dword(25 + i), acc32);
+    }
+  };
+
+  // IR1-3 are written after all of MAC1-3, since they can be the input vector.
+  const auto emit_set_ir_from_mac = [&](bool lm) {
+    for (u32 i = 0; i < 3; i++)
+    {
+      m_emit->mov(acc32, gte_dword(25 + i));
+      EmitGTESaturateIR(m_emit, acc32, flags32, i + 1, lm);
+      m_emit->mov(gte_dword(9 + i), acc32);
+    }
+  };
+
+  const auto v_element = [&](u32 v) { return [&, v](u32 j) { return gte_word(v * 2, j); }; };
+  const auto ir_element = [&](u32 j) { return gte_word(9 + j); };
+
+  m_emit->xor_(flags32, flags32);
+
+  switch (inst.command)
+  {
+    case 0x06: // NCLIP
+    {
+      // MAC0 = SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1), the same as the six products in 64 bits
+      static constexpr std::array<std::array<u32, 3>, 3> terms = {{{12, 13, 14}, {13, 14, 12}, {14, 12, 13}}};
+      for (u32 i = 0; i < 3; i++)
+      {
+        const Xbyak::Reg64& dst = (i == 0) ? acc64 : product64;
+        m_emit->movsx(dst, gte_word(terms[i][1], 1));
+        m_emit->movsx(temp64, gte_word(terms[i][2], 1));
+        m_emit->sub(dst, temp64);
+        m_emit->movsx(temp64, gte_word(terms[i][0], 0));
+        m_emit->imul(dst, temp64);
+        if (i > 0)
+          m_emit->add(acc64, product64);
+      }
+
+      EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, 0);
+      m_emit->mov(gte_dword(24), acc32);
+    }
+    break;
+
+    case 0x2D: // AVSZ3
+    case 0x2E: // AVSZ4
+    {
+      // MAC0 = ZSF3 * (SZ1 + SZ2 + SZ3), or ZSF4 * (SZ0 + SZ1 + SZ2 + SZ3)
+      const bool avsz4 = (inst.command == 0x2E);
+      m_emit->movzx(acc32, gte_word(avsz4 ? 16 : 17));
+      for (u32 i = avsz4 ? 17 : 18; i <= 19; i++)
+      {
+        m_emit->movzx(temp32, gte_word(i));
+        m_emit->add(acc32, temp32);
+      }
+      m_emit->movsx(temp64, gte_word(avsz4 ? 62 : 61));
+      m_emit->imul(acc64, temp64);
+
+      EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, 0);
+      m_emit->mov(gte_dword(24), acc32);
+
+      // OTZ = clamp(MAC0 >> 12, 0, 0xFFFF), the shifted value always fits in 32 bits
+      Xbyak::Label otz_in_range, otz_negative;
+      m_emit->sar(acc64, 12);
+      m_emit->cmp(acc32, 0xFFFF);
+      m_emit->jbe(otz_in_range);
+      m_emit->or_(flags32, UINT32_C(1) << 18);
+      m_emit->test(acc32, acc32);
+      m_emit->js(otz_negative);
+      m_emit->mov(acc32, 0xFFFF);
+      m_emit->jmp(otz_in_range);
+      m_emit->L(otz_negative);
+      m_emit->xor_(acc32, acc32);
+      m_emit->L(otz_in_range);
+      m_emit->mov(gte_dword(7), acc32);
+    }
+    break;
+
+    case 0x28: // SQR
+    {
+      // The squares can't overflow, or go below zero, so all three lanes can be done at once.
+      // xmm0 = [IR0, IR1, IR2, IR3], xmm2 = low 16 bits of each squared.
+      m_emit->movdqu(m_emit->xmm0, m_emit->xword[GetCPUPtrReg() + GetGTERegisterOffset(8)]);
+      m_emit->mov(temp32, 0xFFFF);
+      m_emit->movd(m_emit->xmm1, temp32);
+      m_emit->pshufd(m_emit->xmm1, m_emit->xmm1, 0);
+      m_emit->movdqa(m_emit->xmm2, m_emit->xmm0);
+      m_emit->pand(m_emit->xmm2, m_emit->xmm1);
+      m_emit->pmaddwd(m_emit->xmm2, m_emit->xmm2);
+      if (inst.sf)
+        m_emit->psrad(m_emit->xmm2, 12);
+
+      // MAC1-3 = squares, keeping MAC0
+      m_emit->movd(m_emit->xmm1, gte_dword(24));
+      m_emit->movss(m_emit->xmm2, m_emit->xmm1);
+      m_emit->movdqu(m_emit->xword[GetCPUPtrReg() + GetGTERegisterOffset(24)], m_emit->xmm2);
+
+      // IR1-3 = min(MAC1-3, 0x7FFF), keeping IR0
+      m_emit->mov(temp32, 0x7FFF);
+      m_emit->movd(m_emit->xmm1, temp32);
+      m_emit->pshufd(m_emit->xmm1, m_emit->xmm1, 0);
+      m_emit->movdqa(m_emit->xmm3, m_emit->xmm2);
+      m_emit->pcmpgtd(m_emit->xmm3, m_emit->xmm1);
+      m_emit->movmskps(temp32, m_emit->xmm3);
+      m_emit->pand(m_emit->xmm1, m_emit->xmm3);
+      m_emit->pandn(m_emit->xmm3, m_emit->xmm2);
+      m_emit->por(m_emit->xmm3, m_emit->xmm1);
+      m_emit->movss(m_emit->xmm3, m_emit->xmm0);
+      m_emit->movdqu(m_emit->xword[GetCPUPtrReg() + GetGTERegisterOffset(8)], m_emit->xmm3);
+
+      // lanes 1-3 of the mask are the IR1-3 saturation flags, which are bits 24-22
+      for (u32 i = 1; i <= 3; i++)
+      {
+        m_emit->mov(product32, temp32);
+        m_emit->and_(product32, 1u << i);
+        m_emit->shl(product32, 25 - (i * 2));
+        m_emit->or_(flags32, product32);
+      }
+    }
+    break;
+
+    case 0x12: // MVMVA
+    {
+      // Vectors are V0-V2 at 0/2/4, or IR1-3.
+      const std::optional<u32> translation_index =
+        (inst.mvmva_translation_vector == 3) ?
+          std::nullopt :
+          std::optional<u32>((inst.mvmva_translation_vector == 0) ? 37 : 45);
+      const auto vector_element = [&](u32 j) {
+        return (inst.mvmva_multiply_vector == 3) ? gte_word(9 + j) : gte_word(inst.mvmva_multiply_vector * 2, j);
+      };
+
+      emit_mul_mat_vec(32 + (inst.mvmva_multiply_matrix * 8), translation_index, vector_element, nullptr);
+      emit_set_ir_from_mac(inst.lm);
+    }
+    break;
+
+    case 0x01: // RTPS
+    case 0x30: // RTPT
+    {
+      const Xbyak::Reg64 z64 = GetHostReg64(extra);
+      const Xbyak::Reg32 z32 = GetHostReg32(extra.host_reg);
+      const Xbyak::Reg64 result64 = GetHostReg64(extra2);
+      const u32 num_vectors = (inst.command == 0x01) ? 1 : 3;
+      for (u32 v = 0; v < num_vectors; v++)
+      {
+        // MAC1-3 = (TR*1000h + RT*V) SAR (sf*12), IR1-2 saturated normally
+        emit_mul_mat_vec(32, 37, v_element(v), &z64);
+        for (u32 i = 0; i < 2; i++)
+        {
+          m_emit->mov(acc32, gte_dword(25 + i));
+          EmitGTESaturateIR(m_emit, acc32, flags32, i + 1, inst.lm);
+          m_emit->mov(gte_dword(9 + i), acc32);
+        }
+
+        // IR3 is saturated from MAC3, but the flag is only set when MAC3 SAR 12 is out of range, regardless of lm.
+        m_emit->sar(z64, 12);
+        m_emit->mov(acc32, z32);
+        EmitGTESaturateIR(m_emit, acc32, flags32, 3, false);
+        m_emit->mov(acc32, gte_dword(27));
+        m_emit->mov(temp32, 0x7FFF);
+        m_emit->cmp(acc32, temp32);
+        m_emit->cmovg(acc32, temp32);
+        m_emit->mov(temp32, inst.lm ? 0 : -0x8000);
+        m_emit->cmp(acc32, temp32);
+        m_emit->cmovl(acc32, temp32);
+        m_emit->mov(gte_dword(11), acc32);
+
+        // push MAC3 SAR 12 to the SZ FIFO, saturated to 0..FFFFh
+        EmitGTESaturate(m_emit, z32, flags32, 0, 0xFFFF, 18);
+        for (u32 i = 16; i < 19; i++)
+        {
+          m_emit->mov(temp32, gte_dword(i + 1));
+          m_emit->mov(gte_dword(i), temp32);
+        }
+        m_emit->mov(gte_dword(19), z32);
+
+        // result = (((H*20000h/SZ3)+1)/2)
+        m_emit->movzx(acc32, gte_word(58));
+        EmitGTEDivide(m_emit, result64, acc64, z64, temp64, flags32);
+
+        // SX2/SY2 = (result * IR1/IR2 + OFX/OFY) SAR 16, saturated to -400h..+3FFh
+        for (u32 i = 0; i < 2; i++)
+        {
+          const Xbyak::Reg64& screen64 = (i == 0) ? acc64 : product64;
+          const Xbyak::Reg32& screen32 = (i == 0) ? acc32 : product32;
+          m_emit->movsx(screen64, gte_word(9 + i));
+          m_emit->imul(screen64, result64);
+          m_emit->movsxd(temp64, gte_dword(56 + i));
+          m_emit->add(screen64, temp64);
+          EmitGTECheckMACOverflow(m_emit, screen64, temp64, flags32, 0);
+          m_emit->sar(screen64, 16);
+          EmitGTESaturate(m_emit, screen32, flags32, -0x400, 0x3FF, 14 - i);
+        }
+
+        // push to the SXY FIFO
+        m_emit->movzx(acc32, GetHostReg16(acc.host_reg));
+        m_emit->shl(product32, 16);
+        m_emit->or_(acc32, product32);
+        for (u32 i = 12; i < 14; i++)
+        {
+          m_emit->mov(temp32, gte_dword(i + 1));
+          m_emit->mov(gte_dword(i), temp32);
+        }
+        m_emit->mov(gte_dword(14), acc32);
+      }
+
+      // MAC0 = result * DQA + DQB, IR0 = MAC0 SAR 12 saturated to 0..1000h
+      m_emit->movsx(acc64, gte_word(59));
+      m_emit->imul(acc64, result64);
+      m_emit->movsxd(temp64, gte_dword(60));
+      m_emit->add(acc64, temp64);
+      EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, 0);
+      m_emit->mov(gte_dword(24), acc32);
+      m_emit->sar(acc64, 12);
+      EmitGTESaturate(m_emit, acc32, flags32, 0, 0x1000, 12);
+      m_emit->mov(gte_dword(8), acc32);
+    }
+    break;
+
+    case 0x13: // NCDS
+    case 0x16: // NCDT
+    {
+      const Xbyak::Reg64 in_mac64 = GetHostReg64(extra);
+      const Xbyak::Reg32 in_mac32 = GetHostReg32(extra.host_reg);
+      const Xbyak::Reg32 color32 = GetHostReg32(extra2.host_reg);
+      const u32 num_vectors = (inst.command == 0x13) ? 1 : 3;
+      for (u32 v = 0; v < num_vectors; v++)
+      {
+        // IR = MAC = (LLM*V) SAR (sf*12), then IR = MAC = (BK*1000h + LCM*IR) SAR (sf*12)
+        emit_mul_mat_vec(40, std::nullopt, v_element(v), nullptr);
+        emit_set_ir_from_mac(inst.lm);
+        emit_mul_mat_vec(48, 45, ir_element, nullptr);
+        emit_set_ir_from_mac(inst.lm);
+
+        // Each lane only depends on its own IR, so the interpolation can be done a lane at a time.
+        for (u32 i = 0; i < 3; i++)
+        {
+          // in_MAC = (color * IR) SHL 4
+          m_emit->movzx(in_mac32, m_emit->byte[GetCPUPtrReg() + GetGTERegisterOffset(6) + i]);
+          m_emit->movsx(temp32, gte_word(9 + i));
+          m_emit->imul(in_mac32, temp32);
+          m_emit->shl(in_mac32, 4);
+          m_emit->movsxd(in_mac64, in_mac32);
+
+          // IR = MAC = ((FC SHL 12) - in_MAC) SAR (sf*12), saturated without lm
+          m_emit->movsxd(acc64, gte_dword(53 + i));
+          m_emit->shl(acc64, 12);
+          m_emit->sub(acc64, in_mac64);
+          EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, i + 1);
+          if (inst.sf)
+            m_emit->sar(acc64, 12);
+          m_emit->mov(gte_dword(25 + i), acc32);
+          EmitGTESaturateIR(m_emit, acc32, flags32, i + 1, false);
+
+          // IR = MAC = (IR * IR0 + in_MAC) SAR (sf*12)
+          m_emit->movsx(temp32, gte_word(8));
+          m_emit->imul(acc32, temp32);
+          m_emit->movsxd(acc64, acc32);
+          m_emit->add(acc64, in_mac64);
+          EmitGTECheckMACOverflow(m_emit, acc64, temp64, flags32, i + 1);
+          if (inst.sf)
+            m_emit->sar(acc64, 12);
+          m_emit->mov(gte_dword(25 + i), acc32);
+          EmitGTESaturateIR(m_emit, acc32, flags32, i + 1, inst.lm);
+          m_emit->mov(gte_dword(9 + i), acc32);
+        }
+
+        // push [MAC1-3 SAR 4, CODE] to the color FIFO, saturated to 0..FFh
+        m_emit->movzx(color32, m_emit->byte[GetCPUPtrReg() + GetGTERegisterOffset(6) + 3]);
+        m_emit->shl(color32, 24);
+        for (u32 i = 0; i < 3; i++)
+        {
+          m_emit->mov(acc32, gte_dword(25 + i));
+          m_emit->sar(acc32, 4);
+          EmitGTESaturate(m_emit, acc32, flags32, 0, 0xFF, 21 - i);
+          if (i > 0)
+            m_emit->shl(acc32, i * 8);
+          m_emit->or_(color32, acc32);
+        }
+        for (u32 i = 20; i < 22; i++)
+        {
+          m_emit->mov(temp32, gte_dword(i + 1));
+          m_emit->mov(gte_dword(i), temp32);
+        }
+        m_emit->mov(gte_dword(22), color32);
+      }
+    }
+    break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  EmitGTEUpdateError(m_emit, flags32, temp32);
+  m_emit->mov(gte_dword(63), flags32);
+  return true;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
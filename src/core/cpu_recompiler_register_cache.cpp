@@ -836,6 +836,13 @@ void RegisterCache::FlushCallerSavedGuestRegisters(bool invalidate, bool clear_d
       continue;
     }
 
+    // no need to write back registers which are going to be overwritten anyway
+    if (invalidate && m_code_generator.IsGuestRegisterDead(static_cast<Reg>(reg)))
+    {
+      InvalidateGuestRegister(static_cast<Reg>(reg));
+      continue;
+    }
+
     FlushGuestRegister(static_cast<Reg>(reg), invalidate, clear_dirty);
   }
 }
@@ -845,6 +852,18 @@ bool RegisterCache::EvictOneGuestRegister()
   if (m_state.guest_reg_order_count == 0)
     return false;
 
+  // prefer registers which won't be read again, since they can be dropped without a store
+  for (u32 i = m_state.guest_reg_order_count; i > 0; i--)
+  {
+    const Reg dead_reg = m_state.guest_reg_order[i - 1];
+    if (m_code_generator.IsGuestRegisterDead(dead_reg))
+    {
+      Log_ProfilePrintf("Discarding dead guest register %s", GetRegName(dead_reg));
+      InvalidateGuestRegister(dead_reg);
+      return HasFreeHostRegister();
+    }
+  }
+
   // evict the register used the longest time ago
   Reg evict_reg = m_state.guest_reg_order[m_state.guest_reg_order_count - 1];
   Log_ProfilePrintf("Evicting guest register %s", GetRegName(evict_reg));
@@ -0,0 +1,158 @@
+#include "dirty_page_tracker.h"
+#include "common/log.h"
+#include <algorithm>
+#include <cstring>
+Log_SetChannel(DirtyPageTracker);
+
+static void XORPage(u8* dst, const u8* src, const u8* base, u32 size)
+{
+  u32 pos = 0;
+  for (; (pos + sizeof(u64)) <= size; pos += sizeof(u64))
+  {
+    u64 src_word, base_word;
+    std::memcpy(&src_word, src + pos, sizeof(src_word));
+    std::memcpy(&base_word, base + pos, sizeof(base_word));
+    src_word ^= base_word;
+    std::memcpy(dst + pos, &src_word, sizeof(src_word));
+  }
+  for (; pos < size; pos++)
+    dst[pos] = src[pos] ^ base[pos];
+}
+
+DirtyPageTracker::DirtyPageTracker() = default;
+
+DirtyPageTracker::~DirtyPageTracker() = default;
+
+void DirtyPageTracker::Reset()
+{
+  m_regions.clear();
+  m_incremental = false;
+}
+
+u64 DirtyPageTracker::GetBaseMemoryUsage() const
+{
+  u64 size = 0;
+  for (const std::vector<u8>& region : m_regions)
+    size += region.size();
+
+  return size;
+}
+
+void DirtyPageTracker::DoPagedRegion(StateWrapper& sw, u32 index, void* data, u32 size)
+{
+  if (index == 0)
+  {
+    m_dirty_page_count = 0;
+    m_total_page_count = 0;
+  }
+
+  m_total_page_count += (size + (TRACKING_PAGE_SIZE - 1)) / TRACKING_PAGE_SIZE;
+
+  if (m_incremental)
+    DoIncrementalRegion(sw, index, static_cast<u8*>(data), size);
+  else
+    DoFullRegion(sw, index, static_cast<u8*>(data), size);
+}
+
+void DirtyPageTracker::DoFullRegion(StateWrapper& sw, u32 index, u8* data, u32 size)
+{
+  sw.DoBytes(data, size);
+
+  if (index >= m_regions.size())
+    m_regions.resize(index + 1);
+
+  m_regions[index].assign(data, data + size);
+  m_dirty_page_count += (size + (TRACKING_PAGE_SIZE - 1)) / TRACKING_PAGE_SIZE;
+}
+
+void DirtyPageTracker::DoIncrementalRegion(StateWrapper& sw, u32 index, u8* data, u32 size)
+{
+  const u32 page_count = (size + (TRACKING_PAGE_SIZE - 1)) / TRACKING_PAGE_SIZE;
+  const u8* base = (index < m_regions.size() && m_regions[index].size() == size) ? m_regions[index].data() : nullptr;
+
+  // Without a matching base, everything is dirty and stored as-is, so the snapshot can be loaded without one.
+  bool has_base = (base != nullptr);
+  sw.Do(&has_base);
+
+  m_dirty_pages.clear();
+  if (sw.IsWriting())
+  {
+    for (u32 page = 0; page < page_count; page++)
+    {
+      const u32 offset = page * TRACKING_PAGE_SIZE;
+      if (!base || std::memcmp(data + offset, base + offset, std::min(size - offset, TRACKING_PAGE_SIZE)) != 0)
+        m_dirty_pages.push_back(page);
+    }
+  }
+
+  u32 dirty_page_count = static_cast<u32>(m_dirty_pages.size());
+  sw.Do(&dirty_page_count);
+  if (sw.IsReading())
+  {
+    if (dirty_page_count > page_count)
+    {
+      Log_ErrorPrintf("Region %u has %u dirty pages, but only %u pages", index, dirty_page_count, page_count);
+      sw.SetError();
+      return;
+    }
+
+    m_dirty_pages.resize(dirty_page_count);
+  }
+
+  sw.DoArray(m_dirty_pages.data(), m_dirty_pages.size());
+  if (sw.HasError())
+    return;
+
+  if (sw.IsReading())
+  {
+    if (has_base)
+    {
+      if (!base)
+      {
+        Log_ErrorPrintf("Incremental state for region %u does not match the current base", index);
+        sw.SetError();
+        return;
+      }
+
+      std::memcpy(data, base, size);
+    }
+    else if (dirty_page_count != page_count)
+    {
+      Log_ErrorPrintf("Incremental state for region %u is missing pages", index);
+      sw.SetError();
+      return;
+    }
+  }
+
+  if (has_base)
+    m_page_buffer.resize(TRACKING_PAGE_SIZE);
+
+  for (u32 page : m_dirty_pages)
+  {
+    if (page >= page_count)
+    {
+      Log_ErrorPrintf("Invalid page %u in region %u", page, index);
+      sw.SetError();
+      return;
+    }
+
+    const u32 offset = page * TRACKING_PAGE_SIZE;
+    const u32 page_size = std::min(size - offset, TRACKING_PAGE_SIZE);
+    if (!has_base)
+    {
+      sw.DoBytes(data + offset, page_size);
+    }
+    else if (sw.IsWriting())
+    {
+      XORPage(m_page_buffer.data(), data + offset, base + offset, page_size);
+      sw.DoBytes(m_page_buffer.data(), page_size);
+    }
+    else
+    {
+      sw.DoBytes(m_page_buffer.data(), page_size);
+      XORPage(data + offset, m_page_buffer.data(), base + offset, page_size);
+    }
+  }
+
+  m_dirty_page_count += dirty_page_count;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "common/state_wrapper.h"
+#include "types.h"
+#include <vector>
+
+/// Stores the paged memory regions of a state (RAM, BIOS, VRAM, SPU RAM) relative to a base snapshot.
+/// Full snapshots store every page and become the new base, incremental snapshots only store the pages which differ
+/// from the base, XORed against it so that the bytes which didn't change encode as zeros. Incremental snapshots can
+/// only be loaded while the base they were created from is active, but do not depend on the current contents of the
+/// regions, as the clean pages are restored from the base.
+///
+/// Writes are not tracked: dirty pages are found by comparing every page against the base, so the CPU cost of a
+/// snapshot is still proportional to the full size of the regions. Only the storage is proportional to the pages which
+/// changed.
+class DirtyPageTracker final : public StateWrapper::PagedRegionHandler
+{
+public:
+  static constexpr u32 TRACKING_PAGE_SIZE = 4096;
+
+  DirtyPageTracker();
+  ~DirtyPageTracker() override;
+
+  bool HasBase() const { return !m_regions.empty(); }
+  bool IsIncremental() const { return m_incremental; }
+
+  /// Switches between full snapshots, which replace the base, and incremental snapshots.
+  void SetIncremental(bool incremental) { m_incremental = incremental; }
+
+  /// Drops the base, the next snapshot has to be a full one.
+  void Reset();
+
+  /// Bytes used by the copy of the base.
+  u64 GetBaseMemoryUsage() const;
+
+  /// Number of pages stored by the last snapshot, and the total number of pages.
+  u32 GetDirtyPageCount() const { return m_dirty_page_count; }
+  u32 GetTotalPageCount() const { return m_total_page_count; }
+
+  void DoPagedRegion(StateWrapper& sw, u32 index, void* data, u32 size) override;
+
+private:
+  void DoFullRegion(StateWrapper& sw, u32 index, u8* data, u32 size);
+  void DoIncrementalRegion(StateWrapper& sw, u32 index, u8* data, u32 size);
+
+  std::vector<std::vector<u8>> m_regions;
+  std::vector<u32> m_dirty_pages;
+  std::vector<u8> m_page_buffer;
+  u32 m_dirty_page_count = 0;
+  u32 m_total_page_count = 0;
+  bool m_incremental = false;
+};
@@ -6,6 +6,7 @@
 #include "common/string_util.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
+#include "frame_profiler.h"
 #include "gpu.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
@@ -29,7 +30,10 @@ void DMA::Initialize()
 
   m_transfer_buffer.resize(32);
   m_unhalt_event = TimingEvents::CreateTimingEvent("DMA Transfer Unhalt", 1, m_max_slice_ticks,
-                                                   std::bind(&DMA::UnhaltTransfer, this, std::placeholders::_1), false);
+                                                   [](void* param, TickCount ticks, TickCount ticks_late) {
+                                                     static_cast<DMA*>(param)->UnhaltTransfer(ticks);
+                                                   },
+                                                   this, false);
 
   Reset();
 }
@@ -454,6 +458,7 @@ TickCount DMA::TransferMemoryToDevice(Channel channel, u32 address, u32 incremen
   {
     case Channel::GPU:
     {
+      FrameProfiler::Scope profiler_scope(FrameProfiler::Component::GPU);
       if (g_gpu->BeginDMAWrite())
       {
         u8* ram_pointer = Bus::g_ram;
@@ -464,14 +469,17 @@ TickCount DMA::TransferMemoryToDevice(Channel channel, u32 address, u32 incremen
           g_gpu->DMAWrite(address, value);
           address = (address + increment) & ADDRESS_MASK;
         }
-        g_gpu->EndDMAWrite();
+        g_gpu->EndDMAWrite(word_count);
       }
     }
     break;
 
     case Channel::SPU:
+    {
+      FrameProfiler::Scope profiler_scope(FrameProfiler::Component::SPU);
       g_spu.DMAWrite(src_pointer, word_count);
-      break;
+    }
+    break;
 
     case Channel::MDECin:
       g_mdec.DMAWrite(src_pointer, word_count);
@@ -521,16 +529,25 @@ TickCount DMA::TransferDeviceToMemory(Channel channel, u32 address, u32 incremen
   switch (channel)
   {
     case Channel::GPU:
+    {
+      FrameProfiler::Scope profiler_scope(FrameProfiler::Component::GPU);
       g_gpu->DMARead(dest_pointer, word_count);
-      break;
+    }
+    break;
 
     case Channel::CDROM:
+    {
+      FrameProfiler::Scope profiler_scope(FrameProfiler::Component::CDROM);
       g_cdrom.DMARead(dest_pointer, word_count);
-      break;
+    }
+    break;
 
     case Channel::SPU:
+    {
+      FrameProfiler::Scope profiler_scope(FrameProfiler::Component::SPU);
       g_spu.DMARead(dest_pointer, word_count);
-      break;
+    }
+    break;
 
     case Channel::MDECout:
       g_mdec.DMARead(dest_pointer, word_count);
@@ -0,0 +1,46 @@
+#include "frame_profiler.h"
+#include "common/timer.h"
+#include <array>
+
+namespace FrameProfiler {
+
+bool g_enabled = false;
+
+static Component s_current_component = Component::CPU;
+static Common::Timer::Value s_last_switch_time = 0;
+static std::array<Common::Timer::Value, static_cast<size_t>(Component::Count)> s_component_times = {};
+
+void SetEnabled(bool enabled)
+{
+  g_enabled = enabled;
+  Reset();
+}
+
+void Reset()
+{
+  s_current_component = Component::CPU;
+  s_last_switch_time = Common::Timer::GetValue();
+  s_component_times.fill(0);
+}
+
+double GetTimeMilliseconds(Component component)
+{
+  Common::Timer::Value time = s_component_times[static_cast<size_t>(component)];
+  if (component == s_current_component)
+    time += Common::Timer::GetValue() - s_last_switch_time;
+
+  return Common::Timer::ConvertValueToMilliseconds(time);
+}
+
+Component SwitchComponent(Component component)
+{
+  const Common::Timer::Value now = Common::Timer::GetValue();
+  s_component_times[static_cast<size_t>(s_current_component)] += now - s_last_switch_time;
+  s_last_switch_time = now;
+
+  const Component previous = s_current_component;
+  s_current_component = component;
+  return previous;
+}
+
+} // namespace FrameProfiler
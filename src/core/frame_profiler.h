@@ -0,0 +1,46 @@
+#pragma once
+#include "types.h"
+
+/// Splits the host time spent running the system between the CPU and the peripherals, for benchmarking. Time is
+/// exclusive, so a GPU DMA started from a CDROM event counts towards the GPU, and everything else towards the CPU.
+namespace FrameProfiler {
+
+enum class Component : u8
+{
+  CPU,
+  GPU,
+  SPU,
+  CDROM,
+  Count
+};
+
+extern bool g_enabled;
+
+void SetEnabled(bool enabled);
+
+/// Clears the totals, and starts charging time to the CPU.
+void Reset();
+
+/// Returns the time charged to the component since the last reset.
+double GetTimeMilliseconds(Component component);
+
+/// Charges the time since the last switch to the current component, and makes component current. Returns the
+/// previously current component.
+Component SwitchComponent(Component component);
+
+/// Charges the time until the end of the scope to a component.
+class Scope
+{
+public:
+  ALWAYS_INLINE Scope(Component component) : m_previous(g_enabled ? SwitchComponent(component) : Component::Count) {}
+  ALWAYS_INLINE ~Scope()
+  {
+    if (m_previous != Component::Count)
+      SwitchComponent(m_previous);
+  }
+
+private:
+  Component m_previous;
+};
+
+} // namespace FrameProfiler
@@ -4,6 +4,8 @@
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
+#include "frame_profiler.h"
+#include "gpu_dump.h"
 #include "host_display.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
@@ -30,9 +32,13 @@ bool GPU::Initialize(HostDisplay* host_display)
   m_force_progressive_scan = g_settings.gpu_disable_interlacing;
   m_force_ntsc_timings = g_settings.gpu_force_ntsc_timings;
   m_crtc_tick_event = TimingEvents::CreateTimingEvent(
-    "GPU CRTC Tick", 1, 1, std::bind(&GPU::CRTCTickEvent, this, std::placeholders::_1), true);
+    "GPU CRTC Tick", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<GPU*>(param)->CRTCTickEvent(ticks); }, this,
+    true);
   m_command_tick_event = TimingEvents::CreateTimingEvent(
-    "GPU Command Tick", 1, 1, std::bind(&GPU::CommandTickEvent, this, std::placeholders::_1), true);
+    "GPU Command Tick", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<GPU*>(param)->CommandTickEvent(ticks); },
+    this, true);
   m_fifo_size = g_settings.gpu_fifo_size;
   m_max_run_ahead = g_settings.gpu_max_run_ahead;
   m_console_is_pal = System::IsPALRegion();
@@ -71,6 +77,13 @@ std::tuple<u32, u32> GPU::GetEffectiveDisplayResolution()
 
 void GPU::Reset()
 {
+  // The reset isn't part of the command stream, so the dump would no longer play back correctly.
+  if (m_dump_recorder)
+  {
+    Log_WarningPrintf("Stopping GPU dump due to reset");
+    m_dump_recorder.reset();
+  }
+
   SoftReset();
   m_set_texture_disable_mask = false;
   m_GPUREAD_latch = 0;
@@ -117,6 +130,13 @@ bool GPU::DoState(StateWrapper& sw, bool update_display)
 {
   if (sw.IsReading())
   {
+    // The dump can't follow the state being replaced, whether by a state load, rewind or runahead.
+    if (m_dump_recorder)
+    {
+      Log_WarningPrintf("Stopping GPU dump due to state load");
+      m_dump_recorder.reset();
+    }
+
     // perform a reset to discard all pending draws/fb state
     Reset();
   }
@@ -218,10 +238,30 @@ bool GPU::DoState(StateWrapper& sw, bool update_display)
     m_GPUSTAT.check_mask_before_draw = false;
     m_GPUSTAT.set_mask_while_drawing = false;
 
-    // Still need a temporary here.
-    HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
-    sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
-    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+    if (!IsHardwareRenderer())
+    {
+      // The software renderer owns VRAM, so we can read straight into it once the backend is idle.
+      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+      sw.DoPagedRegion(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+    }
+    else if (sw.GetPagedRegionHandler())
+    {
+      // Paged regions are always filled completely, incremental states restore clean pages from their base.
+      sw.DoPagedRegion(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr);
+    }
+    else if (const void* vram_data = sw.DoBulkRegionInPlace(VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16)); vram_data)
+    {
+      // Memory-backed state, so we can upload straight out of it.
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, vram_data);
+    }
+    else
+    {
+      // Still need a temporary here.
+      HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
+      sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+    }
 
     // Restore mask setting.
     m_GPUSTAT.bits = old_GPUSTAT;
@@ -236,12 +276,50 @@ bool GPU::DoState(StateWrapper& sw, bool update_display)
   else
   {
     ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
-    sw.DoBytes(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+    sw.DoPagedRegion(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
   }
 
   return !sw.HasError();
 }
 
+const u16* GPU::GetVRAM()
+{
+  RestoreGraphicsAPIState();
+  ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  ResetGraphicsAPIState();
+  return m_vram_ptr;
+}
+
+bool GPU::StartDumping(const char* filename)
+{
+  m_dump_recorder.reset();
+
+  // Runahead executes frames which are then thrown away by loading a state, which would end up in the dump.
+  if (g_settings.runahead_frames > 0)
+  {
+    Log_ErrorPrintf("GPU dumps can't be recorded with runahead enabled");
+    return false;
+  }
+
+  // Bring the CRTC and command timing up to date, the time since then isn't part of the state.
+  RestoreGraphicsAPIState();
+  SynchronizeCRTC();
+  m_command_tick_event->InvokeEarly(true);
+  ResetGraphicsAPIState();
+
+  m_dump_recorder = GPUDump::Recorder::Create(filename, System::GetRegion(), this);
+  return static_cast<bool>(m_dump_recorder);
+}
+
+bool GPU::StopDumping()
+{
+  if (!m_dump_recorder)
+    return false;
+
+  m_dump_recorder.reset();
+  return true;
+}
+
 void GPU::ResetGraphicsAPIState() {}
 
 void GPU::RestoreGraphicsAPIState() {}
@@ -316,7 +394,12 @@ u32 GPU::ReadRegister(u32 offset)
   switch (offset)
   {
     case 0x00:
+    {
+      if (m_dump_recorder)
+        m_dump_recorder->ReadGPUREAD();
+
       return ReadGPUREAD();
+    }
 
     case 0x04:
     {
@@ -341,12 +424,18 @@ void GPU::WriteRegister(u32 offset, u32 value)
   switch (offset)
   {
     case 0x00:
+      if (m_dump_recorder)
+        m_dump_recorder->WriteGP0(value);
+
       m_fifo.Push(value);
       ExecuteCommands();
       UpdateCommandTickEvent();
       return;
 
     case 0x04:
+      if (m_dump_recorder)
+        m_dump_recorder->WriteGP1(value);
+
       WriteGP1(value);
       return;
 
@@ -365,12 +454,24 @@ void GPU::DMARead(u32* words, u32 word_count)
     return;
   }
 
+  if (m_dump_recorder)
+    m_dump_recorder->ReadDMA(word_count);
+
   for (u32 i = 0; i < word_count; i++)
     words[i] = ReadGPUREAD();
 }
 
-void GPU::EndDMAWrite()
+void GPU::EndDMAWrite(u32 word_count)
 {
+  if (m_dump_recorder)
+  {
+    // Nothing has been popped since BeginDMAWrite(), so the block is at the end of the FIFO.
+    const u32 start = m_fifo.GetSize() - word_count;
+    m_dump_recorder->BeginDMAWrite();
+    for (u32 i = 0; i < word_count; i++)
+      m_dump_recorder->WriteDMAWord(FifoPeek(start + i));
+  }
+
   m_fifo_pushed = true;
   if (!m_syncing)
   {
@@ -704,10 +805,14 @@ void GPU::UpdateCRTCTickEvent()
     lines_until_event * m_crtc_state.horizontal_total - m_crtc_state.current_tick_in_scanline;
   if (g_timers.IsExternalIRQEnabled(DOT_TIMER_INDEX))
   {
+    // the timer may not be able to raise an interrupt at all, don't let that overflow into an immediate tick
     const TickCount dots_until_irq = g_timers.GetTicksUntilIRQ(DOT_TIMER_INDEX);
-    const TickCount ticks_until_irq =
-      (dots_until_irq * m_crtc_state.dot_clock_divider) - m_crtc_state.fractional_dot_ticks;
-    ticks_until_event = std::min(ticks_until_event, std::max<TickCount>(ticks_until_irq, 0));
+    if (dots_until_irq != std::numeric_limits<TickCount>::max())
+    {
+      const TickCount ticks_until_irq =
+        (dots_until_irq * m_crtc_state.dot_clock_divider) - m_crtc_state.fractional_dot_ticks;
+      ticks_until_event = std::min(ticks_until_event, std::max<TickCount>(ticks_until_irq, 0));
+    }
   }
 
 #if 0
@@ -732,6 +837,8 @@ bool GPU::IsCommandCompletionPending() const
 
 void GPU::CRTCTickEvent(TickCount ticks)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::GPU);
+
   // convert cpu/master clock to GPU ticks, accounting for partial cycles because of the non-integer divider
   {
     const TickCount gpu_ticks = SystemTicksToCRTCTicks(ticks, &m_crtc_state.fractional_ticks);
@@ -855,6 +962,8 @@ void GPU::CRTCTickEvent(TickCount ticks)
 
 void GPU::CommandTickEvent(TickCount ticks)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::GPU);
+
   m_pending_command_ticks -= SystemTicksToGPUTicks(ticks);
   m_command_tick_event->Deactivate();
 
@@ -19,6 +19,10 @@ class HostDisplay;
 class TimingEvent;
 class Timers;
 
+namespace GPUDump {
+class Recorder;
+}
+
 class GPU
 {
 public:
@@ -87,7 +91,20 @@ public:
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
   }
-  void EndDMAWrite();
+  /// word_count is the number of words written with DMAWrite() since BeginDMAWrite().
+  void EndDMAWrite(u32 word_count);
+
+  /// Returns the contents of VRAM, after finishing any pending rendering.
+  const u16* GetVRAM();
+
+  /// Returns true if currently recording the commands sent to the GPU.
+  ALWAYS_INLINE bool IsDumping() const { return static_cast<bool>(m_dump_recorder); }
+
+  /// Starts recording the commands sent to the GPU to a file, which can be played back without the CPU.
+  bool StartDumping(const char* filename);
+
+  /// Stops recording commands, if started.
+  bool StopDumping();
 
   /// Returns false if the DAC is loading any data from VRAM.
   ALWAYS_INLINE bool IsDisplayDisabled() const
@@ -326,6 +343,8 @@ protected:
   std::unique_ptr<TimingEvent> m_crtc_tick_event;
   std::unique_ptr<TimingEvent> m_command_tick_event;
 
+  std::unique_ptr<GPUDump::Recorder> m_dump_recorder;
+
   // Pointer to VRAM, used for reads/writes. In the hardware backends, this is the shadow buffer.
   u16* m_vram_ptr = nullptr;
 
@@ -0,0 +1,337 @@
+#include "gpu_dump.h"
+#include "common/assert.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/state_wrapper.h"
+#include "cpu_core.h"
+#include "gpu.h"
+#include "save_state_version.h"
+#include "timing_event.h"
+#include <algorithm>
+#include <cstring>
+Log_SetChannel(GPUDump);
+
+namespace GPUDump {
+
+// Packets are written out once this many words are buffered.
+static constexpr size_t FLUSH_THRESHOLD = 1024 * 1024;
+
+static constexpr u32 MakePacketHeader(PacketType type, u32 length)
+{
+  return (static_cast<u32>(type) << PACKET_TYPE_SHIFT) | length;
+}
+
+static u32 GetCurrentTickCounter()
+{
+  // Pending ticks have not been added to the counter yet when we're called from the CPU.
+  return TimingEvents::GetGlobalTickCounter() + static_cast<u32>(CPU::GetPendingTicks());
+}
+
+Recorder::Recorder(std::FILE* fp) : m_fp(fp), m_last_tick_counter(GetCurrentTickCounter()) {}
+
+Recorder::~Recorder()
+{
+  Flush();
+  std::fclose(m_fp);
+}
+
+std::unique_ptr<Recorder> Recorder::Create(const char* filename, ConsoleRegion region, GPU* gpu)
+{
+  std::unique_ptr<GrowableMemoryByteStream> state_stream = ByteStream_CreateGrowableMemoryStream();
+  StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  gpu->RestoreGraphicsAPIState();
+  const bool state_saved = gpu->DoState(sw, false);
+  gpu->ResetGraphicsAPIState();
+  if (!state_saved)
+  {
+    Log_ErrorPrintf("Failed to save GPU state");
+    return {};
+  }
+
+  std::FILE* fp = FileSystem::OpenCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s'", filename);
+    return {};
+  }
+
+  FileHeader header;
+  header.magic = FILE_MAGIC;
+  header.version = FILE_VERSION;
+  header.region = static_cast<u32>(region);
+  header.state_version = SAVE_STATE_VERSION;
+  header.state_size = static_cast<u32>(state_stream->GetPosition());
+  if (std::fwrite(&header, sizeof(header), 1, fp) != 1 ||
+      std::fwrite(state_stream->GetMemoryPointer(), header.state_size, 1, fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write header to '%s'", filename);
+    std::fclose(fp);
+    return {};
+  }
+
+  return std::unique_ptr<Recorder>(new Recorder(fp));
+}
+
+void Recorder::BeginPacket(PacketType type, bool continue_packet)
+{
+  const u32 tick_counter = GetCurrentTickCounter();
+  u32 ticks = tick_counter - m_last_tick_counter;
+  m_last_tick_counter = tick_counter;
+  if (ticks > 0)
+  {
+    m_packet_type = PacketType::Count;
+    do
+    {
+      const u32 length = std::min<u32>(ticks, MAX_PACKET_LENGTH);
+      m_buffer.push_back(MakePacketHeader(PacketType::Ticks, length));
+      ticks -= length;
+    } while (ticks > 0);
+  }
+
+  if (continue_packet && m_packet_type == type && (m_buffer[m_packet_index] & MAX_PACKET_LENGTH) < MAX_PACKET_LENGTH)
+    return;
+
+  if (m_buffer.size() >= FLUSH_THRESHOLD)
+    Flush();
+
+  m_packet_index = m_buffer.size();
+  m_packet_type = type;
+  m_buffer.push_back(MakePacketHeader(type, 0));
+}
+
+void Recorder::AddToPacket(u32 count)
+{
+  // Only DMA blocks can be larger than a packet, and the DMA controller can't transfer that much at once.
+  DebugAssert(((m_buffer[m_packet_index] & MAX_PACKET_LENGTH) + count) <= MAX_PACKET_LENGTH);
+  m_buffer[m_packet_index] += count;
+}
+
+void Recorder::Flush()
+{
+  if (m_buffer.empty())
+    return;
+
+  if (std::fwrite(m_buffer.data(), sizeof(u32), m_buffer.size(), m_fp) != m_buffer.size())
+    Log_ErrorPrintf("Failed to write %zu words to dump", m_buffer.size());
+
+  // The current packet is complete once it has been written out.
+  m_buffer.clear();
+  m_packet_type = PacketType::Count;
+}
+
+void Recorder::WriteGP0(u32 value)
+{
+  BeginPacket(PacketType::GP0Write, true);
+  m_buffer.push_back(value);
+  AddToPacket(1);
+}
+
+void Recorder::WriteGP1(u32 value)
+{
+  BeginPacket(PacketType::GP1Write, true);
+  m_buffer.push_back(value);
+  AddToPacket(1);
+}
+
+void Recorder::BeginDMAWrite()
+{
+  BeginPacket(PacketType::DMAWrite, false);
+}
+
+void Recorder::WriteDMAWord(u32 value)
+{
+  m_buffer.push_back(value);
+  AddToPacket(1);
+}
+
+void Recorder::ReadGPUREAD()
+{
+  BeginPacket(PacketType::GPUREADRead, true);
+  AddToPacket(1);
+}
+
+void Recorder::ReadDMA(u32 word_count)
+{
+  BeginPacket(PacketType::DMARead, false);
+  AddToPacket(word_count);
+}
+
+Player::Player() = default;
+
+Player::~Player() = default;
+
+std::unique_ptr<Player> Player::Open(const char* filename)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename);
+  if (!data.has_value())
+  {
+    Log_ErrorPrintf("Failed to read '%s'", filename);
+    return {};
+  }
+
+  FileHeader header;
+  if (data->size() < sizeof(header))
+  {
+    Log_ErrorPrintf("'%s' is too small to be a GPU dump", filename);
+    return {};
+  }
+
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != FILE_MAGIC || header.version != FILE_VERSION)
+  {
+    Log_ErrorPrintf("'%s' is not a version %u GPU dump", filename, FILE_VERSION);
+    return {};
+  }
+  if (header.state_version < SAVE_STATE_MINIMUM_VERSION || header.state_version > SAVE_STATE_VERSION ||
+      header.region >= static_cast<u32>(ConsoleRegion::Count))
+  {
+    Log_ErrorPrintf("'%s' was recorded with an incompatible version", filename);
+    return {};
+  }
+
+  const size_t packets_offset = sizeof(header) + header.state_size;
+  if (data->size() < packets_offset || ((data->size() - packets_offset) % sizeof(u32)) != 0)
+  {
+    Log_ErrorPrintf("'%s' is truncated", filename);
+    return {};
+  }
+
+  std::unique_ptr<Player> player(new Player());
+  player->m_region = static_cast<ConsoleRegion>(header.region);
+  player->m_state_version = header.state_version;
+  player->m_state.assign(data->begin() + sizeof(header), data->begin() + packets_offset);
+  player->m_packets.resize((data->size() - packets_offset) / sizeof(u32));
+  std::memcpy(player->m_packets.data(), data->data() + packets_offset, player->m_packets.size() * sizeof(u32));
+
+  // Check the packets once here, so playback doesn't have to.
+  for (size_t position = 0; position < player->m_packets.size();)
+  {
+    const u32 packet_header = player->m_packets[position++];
+    const PacketType type = static_cast<PacketType>(packet_header >> PACKET_TYPE_SHIFT);
+    const u32 length = packet_header & MAX_PACKET_LENGTH;
+    if (type >= PacketType::Count)
+    {
+      Log_ErrorPrintf("Invalid packet type %u in '%s'", static_cast<u32>(type), filename);
+      return {};
+    }
+
+    if (type == PacketType::GP0Write || type == PacketType::GP1Write || type == PacketType::DMAWrite)
+    {
+      if ((player->m_packets.size() - position) < length)
+      {
+        Log_ErrorPrintf("'%s' is truncated", filename);
+        return {};
+      }
+
+      position += length;
+    }
+  }
+
+  return player;
+}
+
+bool Player::LoadInitialState()
+{
+  std::unique_ptr<ByteStream> stream =
+    ByteStream_CreateReadOnlyMemoryStream(m_state.data(), static_cast<u32>(m_state.size()));
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Read, m_state_version);
+  if (!g_gpu->DoState(sw, true))
+  {
+    Log_ErrorPrintf("Failed to load GPU state from dump");
+    return false;
+  }
+
+  m_position = 0;
+  return true;
+}
+
+bool Player::Execute()
+{
+  // Starting over is left until the next frame, so the last frame of the dump gets displayed.
+  if (IsAtEnd() && !LoadInitialState())
+    return false;
+
+  CPU::g_state.frame_done = false;
+  while (!CPU::g_state.frame_done)
+  {
+    if (IsAtEnd())
+    {
+      // Nothing left to send, so idle until the end of the frame.
+      while (!CPU::g_state.frame_done)
+      {
+        CPU::AddPendingTicks(std::max<TickCount>(CPU::g_state.downcount - CPU::GetPendingTicks(), 1));
+        TimingEvents::RunEvents();
+      }
+
+      break;
+    }
+
+    const u32 packet_header = m_packets[m_position++];
+    const u32 length = packet_header & MAX_PACKET_LENGTH;
+    switch (static_cast<PacketType>(packet_header >> PACKET_TYPE_SHIFT))
+    {
+      case PacketType::Ticks:
+      {
+        CPU::AddPendingTicks(static_cast<TickCount>(length));
+        TimingEvents::RunEvents();
+      }
+      break;
+
+      case PacketType::GP0Write:
+      {
+        for (u32 i = 0; i < length; i++)
+          g_gpu->WriteRegister(0x00, m_packets[m_position + i]);
+        m_position += length;
+      }
+      break;
+
+      case PacketType::GP1Write:
+      {
+        for (u32 i = 0; i < length; i++)
+          g_gpu->WriteRegister(0x04, m_packets[m_position + i]);
+        m_position += length;
+      }
+      break;
+
+      case PacketType::DMAWrite:
+      {
+        if (g_gpu->BeginDMAWrite())
+        {
+          for (u32 i = 0; i < length; i++)
+            g_gpu->DMAWrite(0, m_packets[m_position + i]);
+          g_gpu->EndDMAWrite(length);
+        }
+        else
+        {
+          Log_WarningPrintf("Dropping DMA block of %u words, GPU is not accepting DMA writes", length);
+        }
+
+        m_position += length;
+      }
+      break;
+
+      case PacketType::GPUREADRead:
+      {
+        for (u32 i = 0; i < length; i++)
+          g_gpu->ReadRegister(0);
+      }
+      break;
+
+      case PacketType::DMARead:
+      {
+        m_read_buffer.resize(length);
+        g_gpu->DMARead(m_read_buffer.data(), length);
+      }
+      break;
+
+      default:
+        UnreachableCode();
+        break;
+    }
+  }
+
+  return true;
+}
+
+} // namespace GPUDump
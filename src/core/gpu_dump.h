@@ -0,0 +1,116 @@
+#pragma once
+#include "types.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+class GPU;
+
+/// Recording and playback of everything the rest of the system sends to the GPU, so renderers can be profiled and
+/// compared on identical workloads without running the CPU. A dump is the GPU state at the start of recording,
+/// followed by a stream of packets holding register writes, DMA blocks, reads which consume GPU data, and the time
+/// which passed between them.
+namespace GPUDump {
+
+static constexpr u32 FILE_MAGIC = 0x55504758; // XGPU
+static constexpr u32 FILE_VERSION = 1;
+static constexpr const char* FILE_EXTENSION = ".psxgpu";
+
+#pragma pack(push, 4)
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 region;
+  u32 state_version;
+  u32 state_size;
+};
+#pragma pack(pop)
+
+/// Each packet starts with a word holding the type in the upper 8 bits and the length in the lower 24 bits. Writes
+/// are followed by length data words, the other packets have no data.
+enum class PacketType : u8
+{
+  Ticks,       // Advances time by length system ticks.
+  GP0Write,    // Consecutive writes to GP0, without time passing in between.
+  GP1Write,    // Consecutive writes to GP1, without time passing in between.
+  DMAWrite,    // One DMA block to GP0.
+  GPUREADRead, // Reads length words from GPUREAD.
+  DMARead,     // Reads length words from GPUREAD with DMA.
+  Count
+};
+
+enum : u32
+{
+  PACKET_TYPE_SHIFT = 24,
+  MAX_PACKET_LENGTH = (1u << PACKET_TYPE_SHIFT) - 1
+};
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Writes the header and the current state of the GPU, which should be idle. Returns null on failure.
+  static std::unique_ptr<Recorder> Create(const char* filename, ConsoleRegion region, GPU* gpu);
+
+  void WriteGP0(u32 value);
+  void WriteGP1(u32 value);
+
+  /// Starts a DMA block, the words are added with WriteDMAWord().
+  void BeginDMAWrite();
+  void WriteDMAWord(u32 value);
+
+  void ReadGPUREAD();
+  void ReadDMA(u32 word_count);
+
+private:
+  Recorder(std::FILE* fp);
+
+  /// Records the time since the last packet, and starts a packet of the specified type. Continues the current packet
+  /// instead if it is of the same type and no time has passed.
+  void BeginPacket(PacketType type, bool continue_packet);
+  void AddToPacket(u32 count);
+  void Flush();
+
+  std::FILE* m_fp;
+  std::vector<u32> m_buffer;
+  size_t m_packet_index = 0;
+  PacketType m_packet_type = PacketType::Count;
+  u32 m_last_tick_counter;
+};
+
+class Player
+{
+public:
+  ~Player();
+
+  /// Reads a dump into memory. Returns null on failure.
+  static std::unique_ptr<Player> Open(const char* filename);
+
+  ALWAYS_INLINE ConsoleRegion GetRegion() const { return m_region; }
+
+  /// Returns true once every packet has been played back.
+  ALWAYS_INLINE bool IsAtEnd() const { return m_position == m_packets.size(); }
+
+  /// Restores the GPU to the state at the start of the dump, and rewinds to the first packet. The graphics API state
+  /// has to be restored beforehand, as when running a frame.
+  bool LoadInitialState();
+
+  /// Takes the place of the CPU, feeding packets to the GPU until it finishes the frame. Starts over from the
+  /// beginning of the dump on the frame after it runs out of packets. Returns false if the state can't be restored
+  /// when starting over, in which case nothing is executed.
+  bool Execute();
+
+private:
+  Player();
+
+  ConsoleRegion m_region = ConsoleRegion::NTSC_U;
+  u32 m_state_version = 0;
+  std::vector<u8> m_state;
+  std::vector<u32> m_packets;
+  std::vector<u32> m_read_buffer;
+  size_t m_position = 0;
+};
+
+} // namespace GPUDump
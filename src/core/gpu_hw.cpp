@@ -164,6 +164,12 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   PrintSettingsToLog();
 }
 
+bool GPU_HW::CanDisplayFromVRAMTexture() const
+{
+  // Run-ahead reloads VRAM after the hidden frames, which would replace the frame being displayed.
+  return (g_settings.runahead_frames == 0);
+}
+
 u32 GPU_HW::CalculateResolutionScale() const
 {
   if (g_settings.gpu_resolution_scale != 0)
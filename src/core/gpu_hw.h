@@ -189,6 +189,9 @@ protected:
 
   ALWAYS_INLINE bool IsUsingMultisampling() const { return m_multisamples > 1; }
 
+  /// Returns true if the display can be presented straight out of the VRAM texture.
+  bool CanDisplayFromVRAMTexture() const;
+
   void SetFullVRAMDirtyRectangle()
   {
     m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
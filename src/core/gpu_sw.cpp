@@ -4,9 +4,13 @@
 #include "common/cpu_detect.h"
 #include "common/log.h"
 #include "common/make_array.h"
+#include "common/state_wrapper.h"
 #include "host_display.h"
 #include "system.h"
 #include <algorithm>
+#ifdef WITH_IMGUI
+#include "imgui.h"
+#endif
 Log_SetChannel(GPU_SW);
 
 #if defined(CPU_X64)
@@ -88,6 +92,21 @@ void GPU_SW::UpdateSettings()
   m_backend.UpdateSettings();
 }
 
+bool GPU_SW::DoState(StateWrapper& sw, bool update_display)
+{
+  if (!GPU::DoState(sw, update_display))
+    return false;
+
+  // VRAM was loaded straight into the backend, so textures decoded from the old contents are stale.
+  if (sw.IsReading())
+  {
+    m_backend.Sync();
+    m_backend.InvalidateTextureCaches();
+  }
+
+  return true;
+}
+
 template<HostDisplayPixelFormat out_format, typename out_type>
 static void CopyOutRow16(const u16* src_ptr, out_type* dst_ptr, u32 width);
 
@@ -565,6 +584,46 @@ void GPU_SW::FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc)
   cmd->window = m_draw_mode.texture_window;
 }
 
+void GPU_SW::DrawRendererStats(bool is_idle_frame)
+{
+  if (!is_idle_frame)
+  {
+    const GPU_SW_Backend::TextureCacheStats stats = m_backend.GetTextureCacheStats();
+    m_last_texture_cache_stats.page_hits = stats.page_hits - m_frame_start_texture_cache_stats.page_hits;
+    m_last_texture_cache_stats.page_misses = stats.page_misses - m_frame_start_texture_cache_stats.page_misses;
+    m_last_texture_cache_stats.palette_hits = stats.palette_hits - m_frame_start_texture_cache_stats.palette_hits;
+    m_last_texture_cache_stats.palette_misses = stats.palette_misses - m_frame_start_texture_cache_stats.palette_misses;
+    m_frame_start_texture_cache_stats = stats;
+  }
+
+#ifdef WITH_IMGUI
+  if (ImGui::CollapsingHeader("Renderer Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    const auto& stats = m_last_texture_cache_stats;
+    const auto hit_rate = [](u64 hits, u64 misses) {
+      return (hits + misses) > 0 ? (static_cast<float>(hits) * 100.0f / static_cast<float>(hits + misses)) : 0.0f;
+    };
+
+    ImGui::Columns(2);
+    ImGui::SetColumnWidth(0, 200.0f * ImGui::GetIO().DisplayFramebufferScale.x);
+
+    ImGui::TextUnformatted("Texture Page Cache:");
+    ImGui::NextColumn();
+    ImGui::Text("%.1f%% hits (%llu misses)", hit_rate(stats.page_hits, stats.page_misses),
+                static_cast<unsigned long long>(stats.page_misses));
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Palette Cache:");
+    ImGui::NextColumn();
+    ImGui::Text("%.1f%% hits (%llu misses)", hit_rate(stats.palette_hits, stats.palette_misses),
+                static_cast<unsigned long long>(stats.palette_misses));
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+  }
+#endif
+}
+
 void GPU_SW::DispatchRenderCommand()
 {
   if (m_drawing_area_changed)
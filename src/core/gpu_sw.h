@@ -20,6 +20,7 @@ public:
   bool Initialize(HostDisplay* host_display) override;
   void Reset() override;
   void UpdateSettings() override;
+  bool DoState(StateWrapper& sw, bool update_display) override;
 
 protected:
   void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
@@ -40,6 +41,7 @@ protected:
 
   void ClearDisplay() override;
   void UpdateDisplay() override;
+  void DrawRendererStats(bool is_idle_frame) override;
 
   void DispatchRenderCommand() override;
 
@@ -51,4 +53,7 @@ protected:
   HostDisplayPixelFormat m_24bit_display_format = HostDisplayPixelFormat::RGBA8;
 
   GPU_SW_Backend m_backend;
+
+  GPU_SW_Backend::TextureCacheStats m_frame_start_texture_cache_stats = {};
+  GPU_SW_Backend::TextureCacheStats m_last_texture_cache_stats = {};
 };
@@ -1,23 +1,105 @@
 #include "gpu_sw_backend.h"
 #include "common/assert.h"
+#include "common/cpu_detect.h"
 #include "common/log.h"
 #include "gpu_sw_backend.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
+#include <cstring>
 Log_SetChannel(GPU_SW_Backend);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define GPU_SW_SIMD 1
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define GPU_SW_SIMD 1
+#endif
+
+#ifdef GPU_SW_SIMD
+static bool s_simd_enabled = true;
+#endif
+
+static bool s_texture_cache_enabled = true;
+
+static bool IntersectsWithWraparound(Common::Rectangle<u32> rect, const Common::Rectangle<u32>& area)
+{
+  if (rect.Intersects(area))
+    return true;
+
+  // Texture pages at the right edge of VRAM wrap around to the left.
+  if (rect.right <= VRAM_WIDTH)
+    return false;
+
+  rect.left = 0;
+  rect.right -= VRAM_WIDTH;
+  return rect.Intersects(area);
+}
+
+static u32 GetPaletteSize(const GPUBackendDrawCommand* cmd)
+{
+  return (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit) ? 16 : 256;
+}
+
+static Common::Rectangle<u32> GetPaletteRectangle(const GPUBackendDrawCommand* cmd)
+{
+  return Common::Rectangle<u32>::FromExtents(cmd->palette.GetXBase(), cmd->palette.GetYBase(), GetPaletteSize(cmd), 1);
+}
+
+/// Returns true if the texture page or palette used by the draw overlaps rect.
+static bool TextureIntersects(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& rect)
+{
+  if (IntersectsWithWraparound(cmd->draw_mode.GetTexturePageRectangle(), rect))
+    return true;
+
+  return cmd->draw_mode.IsUsingPalette() && IntersectsWithWraparound(GetPaletteRectangle(cmd), rect);
+}
+
+/// Returns the area of VRAM written by a transfer, or all of it if the transfer wraps around.
+static Common::Rectangle<u32> GetVRAMWriteRectangle(u32 x, u32 y, u32 width, u32 height)
+{
+  if ((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT)
+    return Common::Rectangle<u32>::FromExtents(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+
+  return Common::Rectangle<u32>::FromExtents(x, y, width, height);
+}
+
 GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
 {
   m_vram.fill(0);
   m_vram_ptr = m_vram.data();
+  m_texture_cache = CreateTextureCache();
 }
 
 GPU_SW_Backend::~GPU_SW_Backend() = default;
 
 bool GPU_SW_Backend::Initialize()
 {
-  return GPUBackend::Initialize();
+  if (!GPUBackend::Initialize())
+    return false;
+
+  if (g_settings.gpu_sw_render_threads > 0)
+    StartRenderThreads(g_settings.gpu_sw_render_threads);
+
+  return true;
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+
+  if (m_render_threads.size() != g_settings.gpu_sw_render_threads)
+  {
+    StopRenderThreads();
+    if (g_settings.gpu_sw_render_threads > 0)
+      StartRenderThreads(g_settings.gpu_sw_render_threads);
+  }
 }
 
 void GPU_SW_Backend::Reset()
@@ -25,39 +107,97 @@ void GPU_SW_Backend::Reset()
   GPUBackend::Reset();
 
   m_vram.fill(0);
+  InvalidateTextureCaches();
+}
+
+void GPU_SW_Backend::Shutdown()
+{
+  GPUBackend::Shutdown();
+  StopRenderThreads();
+}
+
+void GPU_SW_Backend::SetSIMDEnabled(bool enabled)
+{
+#ifdef GPU_SW_SIMD
+  s_simd_enabled = enabled;
+#endif
+}
+
+void GPU_SW_Backend::SetTextureCacheEnabled(bool enabled)
+{
+  s_texture_cache_enabled = enabled;
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  if (CanQueueDraw(cmd))
+  {
+    QueueDraw(cmd);
+    return;
+  }
+
+  FlushRender();
+  DrawPolygon(cmd, GetAllRowsBand());
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  if (CanQueueDraw(cmd))
+  {
+    QueueDraw(cmd);
+    return;
+  }
+
+  FlushRender();
+  DrawRectangle(cmd, GetAllRowsBand());
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  if (CanQueueDraw(cmd))
+  {
+    QueueDraw(cmd);
+    return;
+  }
+
+  FlushRender();
+  DrawLine(cmd, GetAllRowsBand());
+}
+
+void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const DrawBand& band)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
+  if (rc.texture_enable)
+    BindTextureCache(*band.texture_cache, cmd);
 
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
 
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  (this->*DrawFunction)(cmd, band, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
   if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    (this->*DrawFunction)(cmd, band, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawBand& band)
 {
   const GPURenderCommand rc{cmd->rc.bits};
-  const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
+  if (rc.texture_enable)
+    BindTextureCache(*band.texture_cache, cmd);
 
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
 
-  (this->*DrawFunction)(cmd);
+  (this->*DrawFunction)(cmd, band);
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const DrawBand& band)
 {
   const DrawLineFunction DrawFunction =
     GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
 
   for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+    (this->*DrawFunction)(cmd, band, &cmd->vertices[i - 1], &cmd->vertices[i]);
 }
 
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
@@ -79,53 +219,94 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
-                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+/// Unpacks the block of palette indices containing the texel from a 4-bit or 8-bit texture page.
+static void DecodeTexturePageBlock(const u16* vram, const GPUDrawModeReg& draw_mode,
+                                   GPU_SW_Backend::CachedTexturePage* page, u8 texcoord_x, u8 texcoord_y)
 {
-  VRAMPixel color;
-  bool transparent;
-  if constexpr (texture_enable)
+  static constexpr u32 BLOCK_WIDTH = GPU_SW_Backend::TEXTURE_CACHE_BLOCK_WIDTH;
+  const u32 block = ZeroExtend32(texcoord_x) / BLOCK_WIDTH;
+  const u16* row_ptr = &vram[((draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT) * VRAM_WIDTH];
+  u8* indices = &page->indices[texcoord_y][block * BLOCK_WIDTH];
+  if (draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
   {
-    // Apply texture window
-    // TODO: Precompute the second half
-    texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
-    texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
-
-    VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+    const u32 base_x = draw_mode.GetTexturePageBaseX() + block * (BLOCK_WIDTH / 4);
+    for (u32 x = 0; x < BLOCK_WIDTH / 4; x++)
     {
-      case GPUTextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      const u16 value = row_ptr[(base_x + x) % VRAM_WIDTH];
+      indices[x * 4 + 0] = Truncate8(value & 0x0Fu);
+      indices[x * 4 + 1] = Truncate8((value >> 4) & 0x0Fu);
+      indices[x * 4 + 2] = Truncate8((value >> 8) & 0x0Fu);
+      indices[x * 4 + 3] = Truncate8(value >> 12);
+    }
+  }
+  else
+  {
+    const u32 base_x = draw_mode.GetTexturePageBaseX() + block * (BLOCK_WIDTH / 2);
+    for (u32 x = 0; x < BLOCK_WIDTH / 2; x++)
+    {
+      const u16 value = row_ptr[(base_x + x) % VRAM_WIDTH];
+      indices[x * 2 + 0] = Truncate8(value);
+      indices[x * 2 + 1] = Truncate8(value >> 8);
+    }
+  }
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+  page->decoded_blocks[texcoord_y] |= static_cast<u16>(1u << block);
+}
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+/// Returns the texel at the given coordinates, after applying the texture window and looking up the palette.
+static ALWAYS_INLINE_RELEASE u16 FetchTexel(const u16* vram, const GPUBackendDrawCommand* cmd,
+                                            GPU_SW_Backend::TextureCache& cache, u8 texcoord_x, u8 texcoord_y)
+{
+  // Apply texture window
+  // TODO: Precompute the second half
+  texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
+  texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-      }
-      break;
+  GPU_SW_Backend::CachedTexturePage* page = cache.page;
+  if (page)
+  {
+    if (!(page->decoded_blocks[texcoord_y] & (1u << (texcoord_x / GPU_SW_Backend::TEXTURE_CACHE_BLOCK_WIDTH))))
+      DecodeTexturePageBlock(vram, cmd->draw_mode, page, texcoord_x, texcoord_y);
+
+    return cache.palette->colors[page->indices[texcoord_y][texcoord_x]];
+  }
+
+  const u32 page_row = ((cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT) * VRAM_WIDTH;
+  const u32 palette_row = cmd->palette.GetYBase() * VRAM_WIDTH;
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
+    {
+      const u16 palette_value =
+        vram[page_row + (cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH];
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      return vram[palette_row + (cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH];
+    }
+
+    case GPUTextureMode::Palette8Bit:
+    {
+      const u16 palette_value =
+        vram[page_row + (cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH];
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return vram[palette_row + (cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH];
     }
 
+    default:
+      return vram[page_row + (cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH];
+  }
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, TextureCache& cache, u32 x,
+                                                      u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
+                                                      u8 texcoord_y)
+{
+  VRAMPixel color;
+  bool transparent;
+  if constexpr (texture_enable)
+  {
+    VRAMPixel texture_color;
+    texture_color.bits = FetchTexel(m_vram.data(), cmd, cache, texcoord_x, texcoord_y);
     if (texture_color.bits == 0)
       return;
 
@@ -210,8 +391,380 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
   SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | cmd->params.GetMaskOR());
 }
 
+#ifdef GPU_SW_SIMD
+
+// The vector path shades SIMD_SPAN_WIDTH pixels at once, with each pixel in a 16-bit lane. Texels are still fetched
+// one at a time, as there's no gather on SSE2/NEON, but the texture window, palette lookup and everything after it
+// matches ShadePixel() exactly. The dither LUT is replaced by the arithmetic it was generated from.
+
+#if defined(CPU_X64)
+
+using SIMDVec16 = __m128i;
+using SIMDVec32 = __m128i;
+
+ALWAYS_INLINE static SIMDVec16 SIMDLoad16(const u16* values)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+ALWAYS_INLINE static void SIMDStore16(u16* dst, SIMDVec16 a)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), a);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDSet16(u16 value)
+{
+  return _mm_set1_epi16(static_cast<s16>(value));
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDAnd16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_and_si128(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDOr16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_or_si128(a, b);
+}
+
+/// Returns lanes of a where mask is set, otherwise b.
+ALWAYS_INLINE static SIMDVec16 SIMDSelect16(SIMDVec16 mask, SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDAdd16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_add_epi16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDSubSaturate16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_subs_epu16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMul16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_mullo_epi16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMinSigned16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_min_epi16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMaxSigned16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_max_epi16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDEqual16(SIMDVec16 a, SIMDVec16 b)
+{
+  return _mm_cmpeq_epi16(a, b);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftLeft16(SIMDVec16 a)
+{
+  return _mm_slli_epi16(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftRight16(SIMDVec16 a)
+{
+  return _mm_srli_epi16(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftRightSigned16(SIMDVec16 a)
+{
+  return _mm_srai_epi16(a, N);
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDSet32(u32 a, u32 b, u32 c, u32 d)
+{
+  return _mm_setr_epi32(static_cast<s32>(a), static_cast<s32>(b), static_cast<s32>(c), static_cast<s32>(d));
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDSet32(u32 value)
+{
+  return _mm_set1_epi32(static_cast<s32>(value));
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDAdd32(SIMDVec32 a, SIMDVec32 b)
+{
+  return _mm_add_epi32(a, b);
+}
+
+/// Returns the top byte of each 32-bit lane of lo and hi, in 16-bit lanes.
+ALWAYS_INLINE static SIMDVec16 SIMDPackHighBytes32(SIMDVec32 lo, SIMDVec32 hi)
+{
+  return _mm_packs_epi32(_mm_srli_epi32(lo, 24), _mm_srli_epi32(hi, 24));
+}
+
+#elif defined(CPU_AARCH64)
+
+using SIMDVec16 = uint16x8_t;
+using SIMDVec32 = uint32x4_t;
+
+ALWAYS_INLINE static SIMDVec16 SIMDLoad16(const u16* values)
+{
+  return vld1q_u16(values);
+}
+
+ALWAYS_INLINE static void SIMDStore16(u16* dst, SIMDVec16 a)
+{
+  vst1q_u16(dst, a);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDSet16(u16 value)
+{
+  return vdupq_n_u16(value);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDAnd16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vandq_u16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDOr16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vorrq_u16(a, b);
+}
+
+/// Returns lanes of a where mask is set, otherwise b.
+ALWAYS_INLINE static SIMDVec16 SIMDSelect16(SIMDVec16 mask, SIMDVec16 a, SIMDVec16 b)
+{
+  return vbslq_u16(mask, a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDAdd16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vaddq_u16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDSubSaturate16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vqsubq_u16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMul16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vmulq_u16(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMinSigned16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vreinterpretq_u16_s16(vminq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDMaxSigned16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vreinterpretq_u16_s16(vmaxq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+
+ALWAYS_INLINE static SIMDVec16 SIMDEqual16(SIMDVec16 a, SIMDVec16 b)
+{
+  return vceqq_u16(a, b);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftLeft16(SIMDVec16 a)
+{
+  return vshlq_n_u16(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftRight16(SIMDVec16 a)
+{
+  return vshrq_n_u16(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec16 SIMDShiftRightSigned16(SIMDVec16 a)
+{
+  return vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(a), N));
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDSet32(u32 a, u32 b, u32 c, u32 d)
+{
+  const u32 values[4] = {a, b, c, d};
+  return vld1q_u32(values);
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDSet32(u32 value)
+{
+  return vdupq_n_u32(value);
+}
+
+ALWAYS_INLINE static SIMDVec32 SIMDAdd32(SIMDVec32 a, SIMDVec32 b)
+{
+  return vaddq_u32(a, b);
+}
+
+/// Returns the top byte of each 32-bit lane of lo and hi, in 16-bit lanes.
+ALWAYS_INLINE static SIMDVec16 SIMDPackHighBytes32(SIMDVec32 lo, SIMDVec32 hi)
+{
+  return vcombine_u16(vmovn_u32(vshrq_n_u32(lo, 24)), vmovn_u32(vshrq_n_u32(hi, 24)));
+}
+
+#endif
+
+struct SIMDDitherOffsets
+{
+  // [y & 3][x & 3][lane]
+  s16 offsets[DITHER_MATRIX_SIZE][DITHER_MATRIX_SIZE][GPU_SW_Backend::SIMD_SPAN_WIDTH];
+};
+
+static constexpr SIMDDitherOffsets ComputeSIMDDitherOffsets()
+{
+  SIMDDitherOffsets ret = {};
+  for (u32 y = 0; y < DITHER_MATRIX_SIZE; y++)
+  {
+    for (u32 x = 0; x < DITHER_MATRIX_SIZE; x++)
+    {
+      for (u32 lane = 0; lane < GPU_SW_Backend::SIMD_SPAN_WIDTH; lane++)
+        ret.offsets[y][x][lane] = static_cast<s16>(DITHER_MATRIX[y][(x + lane) % DITHER_MATRIX_SIZE]);
+    }
+  }
+  return ret;
+}
+
+static constexpr SIMDDitherOffsets s_simd_dither_offsets = ComputeSIMDDitherOffsets();
+
+/// Equivalent to s_dither_lut[][][value] for each lane.
+ALWAYS_INLINE static SIMDVec16 SIMDDither(SIMDVec16 value, SIMDVec16 offsets)
+{
+  const SIMDVec16 dithered = SIMDShiftRightSigned16<3>(SIMDAdd16(value, offsets));
+  return SIMDMinSigned16(SIMDMaxSigned16(dithered, SIMDSet16(0)), SIMDSet16(0x1F));
+}
+
+/// Eight consecutive values of an interpolated polygon attribute.
+struct SIMDSpanAttribute
+{
+  SIMDVec32 lo;
+  SIMDVec32 hi;
+  SIMDVec32 step;
+
+  ALWAYS_INLINE SIMDSpanAttribute(u32 value, u32 dx)
+    : lo(SIMDSet32(value, value + dx, value + dx * 2, value + dx * 3)), hi(SIMDAdd32(lo, SIMDSet32(dx * 4))),
+      step(SIMDSet32(dx * 8))
+  {
+  }
+
+  /// Returns the integer part, which is in the top byte.
+  ALWAYS_INLINE SIMDVec16 GetValue() const { return SIMDPackHighBytes32(lo, hi); }
+
+  ALWAYS_INLINE void Step()
+  {
+    lo = SIMDAdd32(lo, step);
+    hi = SIMDAdd32(hi, step);
+  }
+};
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+static ALWAYS_INLINE_RELEASE void ShadePixelsSIMD(u16* vram, const GPUBackendDrawCommand* cmd,
+                                                  GPU_SW_Backend::TextureCache& cache, u32 x, u32 y,
+                                                  SIMDVec16 color_r, SIMDVec16 color_g, SIMDVec16 color_b,
+                                                  SIMDVec16 texcoord_x, SIMDVec16 texcoord_y)
+{
+  const SIMDVec16 zero = SIMDSet16(0);
+  const SIMDVec16 channel_mask = SIMDSet16(0x1F);
+  const SIMDVec16 dither_offsets =
+    dithering_enable ? SIMDLoad16(reinterpret_cast<const u16*>(s_simd_dither_offsets.offsets[y & 3u][x & 3u])) :
+                       SIMDSet16(static_cast<u16>(DITHER_MATRIX[2][3]));
+
+  u16* dst = &vram[VRAM_WIDTH * y + x];
+  const SIMDVec16 bg_color = SIMDLoad16(dst);
+
+  SIMDVec16 color;
+  SIMDVec16 write_mask;
+  SIMDVec16 transparent;
+  if constexpr (texture_enable)
+  {
+    alignas(16) u16 texcoords_x[GPU_SW_Backend::SIMD_SPAN_WIDTH];
+    alignas(16) u16 texcoords_y[GPU_SW_Backend::SIMD_SPAN_WIDTH];
+    alignas(16) u16 texels[GPU_SW_Backend::SIMD_SPAN_WIDTH];
+    SIMDStore16(texcoords_x, texcoord_x);
+    SIMDStore16(texcoords_y, texcoord_y);
+    for (u32 i = 0; i < GPU_SW_Backend::SIMD_SPAN_WIDTH; i++)
+      texels[i] = FetchTexel(vram, cmd, cache, Truncate8(texcoords_x[i]), Truncate8(texcoords_y[i]));
+
+    const SIMDVec16 texture_color = SIMDLoad16(texels);
+
+    // Fully transparent texels are skipped.
+    write_mask = SIMDSelect16(SIMDEqual16(texture_color, zero), zero, SIMDSet16(0xFFFF));
+    transparent = SIMDShiftRightSigned16<15>(texture_color);
+
+    if constexpr (raw_texture_enable)
+    {
+      color = texture_color;
+    }
+    else
+    {
+      const SIMDVec16 texture_r = SIMDAnd16(texture_color, channel_mask);
+      const SIMDVec16 texture_g = SIMDAnd16(SIMDShiftRight16<5>(texture_color), channel_mask);
+      const SIMDVec16 texture_b = SIMDAnd16(SIMDShiftRight16<10>(texture_color), channel_mask);
+      const SIMDVec16 r = SIMDDither(SIMDShiftRight16<4>(SIMDMul16(texture_r, color_r)), dither_offsets);
+      const SIMDVec16 g = SIMDDither(SIMDShiftRight16<4>(SIMDMul16(texture_g, color_g)), dither_offsets);
+      const SIMDVec16 b = SIMDDither(SIMDShiftRight16<4>(SIMDMul16(texture_b, color_b)), dither_offsets);
+      color = SIMDOr16(SIMDOr16(r, SIMDShiftLeft16<5>(g)),
+                       SIMDOr16(SIMDShiftLeft16<10>(b), SIMDAnd16(texture_color, SIMDSet16(0x8000))));
+    }
+  }
+  else
+  {
+    write_mask = SIMDSet16(0xFFFF);
+    transparent = SIMDSet16(0xFFFF);
+
+    const SIMDVec16 r = SIMDDither(color_r, dither_offsets);
+    const SIMDVec16 g = SIMDDither(color_g, dither_offsets);
+    const SIMDVec16 b = SIMDDither(color_b, dither_offsets);
+    color = SIMDOr16(r, SIMDOr16(SIMDShiftLeft16<5>(g), SIMDShiftLeft16<10>(b)));
+  }
+
+  if constexpr (transparency_enable)
+  {
+    const GPUTransparencyMode mode = cmd->draw_mode.transparency_mode;
+    const auto blend = [mode, &channel_mask](SIMDVec16 bg, SIMDVec16 fg) {
+      switch (mode)
+      {
+        case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+          return SIMDMinSigned16(SIMDAdd16(SIMDShiftRight16<1>(bg), SIMDShiftRight16<1>(fg)), channel_mask);
+        case GPUTransparencyMode::BackgroundPlusForeground:
+          return SIMDMinSigned16(SIMDAdd16(bg, fg), channel_mask);
+        case GPUTransparencyMode::BackgroundMinusForeground:
+          return SIMDSubSaturate16(bg, fg);
+        case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+        default:
+          return SIMDMinSigned16(SIMDAdd16(bg, SIMDShiftRight16<2>(fg)), channel_mask);
+      }
+    };
+
+    const SIMDVec16 r = blend(SIMDAnd16(bg_color, channel_mask), SIMDAnd16(color, channel_mask));
+    const SIMDVec16 g = blend(SIMDAnd16(SIMDShiftRight16<5>(bg_color), channel_mask),
+                              SIMDAnd16(SIMDShiftRight16<5>(color), channel_mask));
+    const SIMDVec16 b = blend(SIMDAnd16(SIMDShiftRight16<10>(bg_color), channel_mask),
+                              SIMDAnd16(SIMDShiftRight16<10>(color), channel_mask));
+    const SIMDVec16 blended = SIMDOr16(SIMDOr16(r, SIMDShiftLeft16<5>(g)),
+                                       SIMDOr16(SIMDShiftLeft16<10>(b), SIMDAnd16(color, SIMDSet16(0x8000))));
+    color = SIMDSelect16(transparent, blended, color);
+  }
+  else
+  {
+    UNREFERENCED_VARIABLE(transparent);
+  }
+
+  const SIMDVec16 mask_and = SIMDSet16(cmd->params.GetMaskAND());
+  write_mask = SIMDAnd16(write_mask, SIMDEqual16(SIMDAnd16(bg_color, mask_and), zero));
+  color = SIMDOr16(color, SIMDSet16(cmd->params.GetMaskOR()));
+  SIMDStore16(dst, SIMDSelect16(write_mask, color, bg_color));
+}
+
+#endif // GPU_SW_SIMD
+
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawBand& band)
 {
   const s32 origin_x = cmd->x;
   const s32 origin_y = cmd->y;
@@ -222,14 +775,34 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
     if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
-        (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
+        (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)) ||
+        !band.ContainsRow(y))
     {
       continue;
     }
 
     const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
+    u32 offset_x = 0;
 
-    for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
+#ifdef GPU_SW_SIMD
+    if (s_simd_enabled)
+    {
+      // Shade whole groups of the part inside the drawing area, the loop below finishes the row.
+      const s32 start = std::max(static_cast<s32>(m_drawing_area.left) - origin_x, 0);
+      const s32 end = std::min(static_cast<s32>(m_drawing_area.right) + 1 - origin_x, static_cast<s32>(cmd->width));
+      const u32 count = (end > start) ? (static_cast<u32>(end - start) & ~(SIMD_SPAN_WIDTH - 1)) : 0;
+      const u32 x = static_cast<u32>(origin_x + start);
+      if (count > 0 && (!texture_enable || CanShadeSpanSIMD(cmd, x, static_cast<u32>(y), count)))
+      {
+        DrawRectangleSpanSIMD<texture_enable, raw_texture_enable, transparency_enable>(
+          cmd, *band.texture_cache, x, static_cast<u32>(y), count, r, g, b,
+          Truncate8(ZeroExtend32(origin_texcoord_x) + start), texcoord_y);
+        offset_x = static_cast<u32>(start) + count;
+      }
+    }
+#endif
+
+    for (; offset_x < cmd->width; offset_x++)
     {
       const s32 x = origin_x + static_cast<s32>(offset_x);
       if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
@@ -238,11 +811,42 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
       const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
 
       ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
-        cmd, static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
+        cmd, *band.texture_cache, static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
     }
   }
 }
 
+#ifdef GPU_SW_SIMD
+
+bool GPU_SW_Backend::CanShadeSpanSIMD(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 width)
+{
+  return !TextureIntersects(cmd, Common::Rectangle<u32>(x, y, x + width, y + 1));
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
+void GPU_SW_Backend::DrawRectangleSpanSIMD(const GPUBackendDrawRectangleCommand* cmd, TextureCache& cache, u32 x,
+                                           u32 y, u32 count, u8 r, u8 g, u8 b, u8 texcoord_x, u8 texcoord_y)
+{
+  static constexpr u16 lane_offsets[SIMD_SPAN_WIDTH] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  const SIMDVec16 color_r = SIMDSet16(r);
+  const SIMDVec16 color_g = SIMDSet16(g);
+  const SIMDVec16 color_b = SIMDSet16(b);
+  const SIMDVec16 texcoords_y = SIMDSet16(texcoord_y);
+
+  // Only the low byte is used, so the coordinates wrap at 256 like the scalar path.
+  SIMDVec16 texcoords_x = SIMDAdd16(SIMDSet16(texcoord_x), SIMDLoad16(lane_offsets));
+
+  for (u32 offset = 0; offset < count; offset += SIMD_SPAN_WIDTH)
+  {
+    ShadePixelsSIMD<texture_enable, raw_texture_enable, transparency_enable, false>(
+      m_vram.data(), cmd, cache, x + offset, y, color_r, color_g, color_b, texcoords_x, texcoords_y);
+    texcoords_x = SIMDAdd16(texcoords_x, SIMDSet16(SIMD_SPAN_WIDTH));
+  }
+}
+
+#endif // GPU_SW_SIMD
+
 //////////////////////////////////////////////////////////////////////////
 // Polygon and line rasterization ported from Mednafen
 //////////////////////////////////////////////////////////////////////////
@@ -351,8 +955,8 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                              const i_deltas& idl)
+void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, TextureCache& cache, s32 y, s32 x_start,
+                              s32 x_bound, i_group ig, const i_deltas& idl)
 {
   if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
     return;
@@ -378,6 +982,23 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
+#ifdef GPU_SW_SIMD
+  if (s_simd_enabled && w >= static_cast<s32>(SIMD_SPAN_WIDTH) &&
+      (!texture_enable || CanShadeSpanSIMD(cmd, static_cast<u32>(x), static_cast<u32>(y), static_cast<u32>(w))))
+  {
+    const s32 count = w & ~static_cast<s32>(SIMD_SPAN_WIDTH - 1);
+    DrawSpanSIMD<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      cmd, cache, static_cast<u32>(x), static_cast<u32>(y), static_cast<u32>(count), ig, idl);
+
+    w -= count;
+    if (w == 0)
+      return;
+
+    x += count;
+    AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, static_cast<u32>(count));
+  }
+#endif
+
   do
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -387,7 +1008,7 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
     const u32 v = ig.v >> (COORD_FBS + COORD_POST_PADDING);
 
     ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-      cmd, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b), Truncate8(u),
+      cmd, cache, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b), Truncate8(u),
       Truncate8(v));
 
     x++;
@@ -395,9 +1016,46 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   } while (--w > 0);
 }
 
+#ifdef GPU_SW_SIMD
+
+template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+         bool dithering_enable>
+void GPU_SW_Backend::DrawSpanSIMD(const GPUBackendDrawPolygonCommand* cmd, TextureCache& cache, u32 x, u32 y,
+                                  u32 count, const i_group& ig, const i_deltas& idl)
+{
+  // Flat-shaded and untextured attributes stay constant across the span.
+  SIMDSpanAttribute r(ig.r, shading_enable ? idl.dr_dx : 0);
+  SIMDSpanAttribute g(ig.g, shading_enable ? idl.dg_dx : 0);
+  SIMDSpanAttribute b(ig.b, shading_enable ? idl.db_dx : 0);
+  SIMDSpanAttribute u(texture_enable ? ig.u : 0, texture_enable ? idl.du_dx : 0);
+  SIMDSpanAttribute v(texture_enable ? ig.v : 0, texture_enable ? idl.dv_dx : 0);
+
+  for (u32 offset = 0; offset < count; offset += SIMD_SPAN_WIDTH)
+  {
+    ShadePixelsSIMD<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      m_vram.data(), cmd, cache, x + offset, y, r.GetValue(), g.GetValue(), b.GetValue(), u.GetValue(),
+      v.GetValue());
+
+    if constexpr (shading_enable)
+    {
+      r.Step();
+      g.Step();
+      b.Step();
+    }
+
+    if constexpr (texture_enable)
+    {
+      u.Step();
+      v.Step();
+    }
+  }
+}
+
+#endif // GPU_SW_SIMD
+
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
+void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const DrawBand& band,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
                                   const GPUBackendDrawPolygonCommand::Vertex* v2)
@@ -558,11 +1216,11 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
         if (y < static_cast<s32>(m_drawing_area.top))
           break;
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(m_drawing_area.bottom) || !band.ContainsRow(y))
           continue;
 
         DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          cmd, *band.texture_cache, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
       }
     }
     else
@@ -574,11 +1232,11 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
         if (y > static_cast<s32>(m_drawing_area.bottom))
           break;
 
-        if (y >= static_cast<s32>(m_drawing_area.top))
+        if (y >= static_cast<s32>(m_drawing_area.top) && band.ContainsRow(y))
         {
 
           DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+            cmd, *band.texture_cache, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
         }
 
         yi++;
@@ -655,8 +1313,8 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
 }
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const DrawBand& band,
+                              const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -717,14 +1375,15 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
         x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom) &&
+        band.ContainsRow(y))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
       const u8 b = shading_enable ? static_cast<u8>(cur_point.b >> Line_RGB_FractBits) : p0->b;
 
-      ShadePixel<false, false, transparency_enable, dithering_enable>(cmd, static_cast<u32>(x), static_cast<u32>(y), r,
-                                                                      g, b, 0, 0);
+      ShadePixel<false, false, transparency_enable, dithering_enable>(cmd, *band.texture_cache, static_cast<u32>(x),
+                                                                      static_cast<u32>(y), r, g, b, 0, 0);
     }
 
     cur_point.x += step.dx_dk;
@@ -767,8 +1426,158 @@ GPU_SW_Backend::GetDrawRectangleFunction(bool texture_enable, bool raw_texture_e
   return funcs[u8(texture_enable)][u8(raw_texture_enable)][u8(transparency_enable)];
 }
 
+std::unique_ptr<GPU_SW_Backend::TextureCache> GPU_SW_Backend::CreateTextureCache()
+{
+  std::unique_ptr<TextureCache> cache = std::make_unique<TextureCache>();
+  for (CachedTexturePage& page : cache->pages)
+    page.valid = false;
+  for (CachedPalette& palette : cache->palettes)
+    palette.valid = false;
+  cache->use_counter = 0;
+  cache->page = nullptr;
+  cache->palette = nullptr;
+  cache->page_hits.store(0);
+  cache->page_misses.store(0);
+  cache->palette_hits.store(0);
+  cache->palette_misses.store(0);
+  return cache;
+}
+
+/// Returns the entry for key, or the least recently used entry with valid cleared if it isn't present.
+template<typename Entry, size_t Size, typename Key>
+static Entry* LookupTextureCacheEntry(std::array<Entry, Size>& entries, Key key, u32 use_counter)
+{
+  Entry* victim = &entries[0];
+  for (Entry& entry : entries)
+  {
+    if (entry.valid && entry.key == key)
+    {
+      entry.last_used = use_counter;
+      return &entry;
+    }
+
+    if (victim->valid && (!entry.valid || entry.last_used < victim->last_used))
+      victim = &entry;
+  }
+
+  victim->key = key;
+  victim->valid = false;
+  victim->last_used = use_counter;
+  return victim;
+}
+
+void GPU_SW_Backend::BindTextureCache(TextureCache& cache, const GPUBackendDrawCommand* cmd)
+{
+  // Direct textures are cheap enough to read from VRAM, and ones in the drawing area can change mid-draw.
+  const Common::Rectangle<u32> drawing_area(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right + 1,
+                                            m_drawing_area.bottom + 1);
+  if (!s_texture_cache_enabled || !cmd->draw_mode.IsUsingPalette() || TextureIntersects(cmd, drawing_area))
+  {
+    cache.page = nullptr;
+    cache.palette = nullptr;
+    return;
+  }
+
+  const u32 use_counter = ++cache.use_counter;
+
+  // Texture page base, and 4-bit or 8-bit mode.
+  const u16 page_key = cmd->draw_mode.bits & 0x019Fu;
+  CachedTexturePage* page = LookupTextureCacheEntry(cache.pages, page_key, use_counter);
+  if (page->valid)
+  {
+    cache.page_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
+  {
+    cache.page_misses.fetch_add(1, std::memory_order_relaxed);
+    page->rect = cmd->draw_mode.GetTexturePageRectangle();
+    page->decoded_blocks.fill(0);
+    page->valid = true;
+  }
+
+  const u32 palette_key =
+    ZeroExtend32(cmd->palette.bits) | (static_cast<u32>(cmd->draw_mode.texture_mode.GetValue()) << 16);
+  CachedPalette* palette = LookupTextureCacheEntry(cache.palettes, palette_key, use_counter);
+  if (palette->valid)
+  {
+    cache.palette_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
+  {
+    cache.palette_misses.fetch_add(1, std::memory_order_relaxed);
+    const u16* row_ptr = &m_vram[cmd->palette.GetYBase() * VRAM_WIDTH];
+    const u32 base_x = cmd->palette.GetXBase();
+    const u32 size = GetPaletteSize(cmd);
+    for (u32 i = 0; i < size; i++)
+      palette->colors[i] = row_ptr[(base_x + i) % VRAM_WIDTH];
+    palette->rect = GetPaletteRectangle(cmd);
+    palette->valid = true;
+  }
+
+  cache.page = page;
+  cache.palette = palette;
+}
+
+void GPU_SW_Backend::InvalidateTextureCaches(const Common::Rectangle<u32>& rect)
+{
+  const auto invalidate = [&rect](TextureCache& cache) {
+    for (CachedTexturePage& page : cache.pages)
+    {
+      if (page.valid && IntersectsWithWraparound(page.rect, rect))
+        page.valid = false;
+    }
+    for (CachedPalette& palette : cache.palettes)
+    {
+      if (palette.valid && IntersectsWithWraparound(palette.rect, rect))
+        palette.valid = false;
+    }
+  };
+
+  invalidate(*m_texture_cache);
+  for (const std::unique_ptr<TextureCache>& cache : m_render_thread_texture_caches)
+    invalidate(*cache);
+}
+
+void GPU_SW_Backend::InvalidateTextureCaches()
+{
+  InvalidateTextureCaches(Common::Rectangle<u32>::FromExtents(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+}
+
+GPU_SW_Backend::TextureCacheStats GPU_SW_Backend::GetTextureCacheStats() const
+{
+  TextureCacheStats stats = {};
+  const auto add = [&stats](const TextureCache& cache) {
+    stats.page_hits += cache.page_hits.load(std::memory_order_relaxed);
+    stats.page_misses += cache.page_misses.load(std::memory_order_relaxed);
+    stats.palette_hits += cache.palette_hits.load(std::memory_order_relaxed);
+    stats.palette_misses += cache.palette_misses.load(std::memory_order_relaxed);
+  };
+
+  add(*m_texture_cache);
+  for (const std::unique_ptr<TextureCache>& cache : m_render_thread_texture_caches)
+    add(*cache);
+
+  return stats;
+}
+
+void GPU_SW_Backend::ResetTextureCacheStats()
+{
+  const auto reset = [](TextureCache& cache) {
+    cache.page_hits.store(0, std::memory_order_relaxed);
+    cache.page_misses.store(0, std::memory_order_relaxed);
+    cache.palette_hits.store(0, std::memory_order_relaxed);
+    cache.palette_misses.store(0, std::memory_order_relaxed);
+  };
+
+  reset(*m_texture_cache);
+  for (const std::unique_ptr<TextureCache>& cache : m_render_thread_texture_caches)
+    reset(*cache);
+}
+
 void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
 {
+  InvalidateTextureCaches(GetVRAMWriteRectangle(x, y, width, height));
+
   const u16 color16 = RGBA8888ToRGBA5551(color);
   if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
   {
@@ -814,6 +1623,8 @@ void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GP
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
 {
+  InvalidateTextureCaches(GetVRAMWriteRectangle(x, y, width, height));
+
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
   {
@@ -850,6 +1661,8 @@ void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
                               GPUBackendCommandParameters params)
 {
+  InvalidateTextureCaches(GetVRAMWriteRectangle(dst_x, dst_y, width, height));
+
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
   {
@@ -921,6 +1734,182 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
   }
 }
 
-void GPU_SW_Backend::FlushRender() {}
+void GPU_SW_Backend::FlushRender()
+{
+  if (m_render_threads.empty())
+    return;
+
+  SubmitRenderBatch();
+  WaitForRenderBatch();
+}
+
+void GPU_SW_Backend::DrawingAreaChanged()
+{
+  // Cached textures aren't invalidated by draws, so they can't be inside the drawing area.
+  InvalidateTextureCaches(Common::Rectangle<u32>(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right + 1,
+                                                 m_drawing_area.bottom + 1));
+}
+
+void GPU_SW_Backend::StartRenderThreads(u32 count)
+{
+  count = std::min(count, MAX_RENDER_THREADS);
+
+  m_render_batch_index = 0;
+  m_render_batch_data = nullptr;
+  m_render_batch_size = 0;
+  m_render_batch_generation = 0;
+  m_render_threads_busy = 0;
+  m_render_threads_shutdown = false;
+  for (std::vector<u8>& batch : m_render_batches)
+  {
+    batch.clear();
+    batch.reserve(RENDER_BATCH_SUBMIT_SIZE * 2);
+  }
+
+  m_render_threads.reserve(count);
+  m_render_thread_texture_caches.reserve(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    TextureCache* cache = m_render_thread_texture_caches.emplace_back(CreateTextureCache()).get();
+    m_render_threads.emplace_back(&GPU_SW_Backend::RenderThreadLoop, this, DrawBand{i, count, cache});
+  }
+
+  Log_InfoPrintf("%u render threads started.", count);
+}
+
+void GPU_SW_Backend::StopRenderThreads()
+{
+  if (m_render_threads.empty())
+    return;
+
+  WaitForRenderBatch();
+
+  {
+    std::unique_lock<std::mutex> lock(m_render_mutex);
+    m_render_threads_shutdown = true;
+    m_render_work_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_render_threads)
+    thread.join();
+  m_render_threads.clear();
+
+  // Keep the lookups made by the render threads in the totals.
+  const TextureCacheStats stats = GetTextureCacheStats();
+  m_render_thread_texture_caches.clear();
+  m_texture_cache->page_hits.store(stats.page_hits, std::memory_order_relaxed);
+  m_texture_cache->page_misses.store(stats.page_misses, std::memory_order_relaxed);
+  m_texture_cache->palette_hits.store(stats.palette_hits, std::memory_order_relaxed);
+  m_texture_cache->palette_misses.store(stats.palette_misses, std::memory_order_relaxed);
+
+  for (std::vector<u8>& batch : m_render_batches)
+    batch = {};
+
+  Log_InfoPrint("Render threads stopped.");
+}
+
+void GPU_SW_Backend::RenderThreadLoop(DrawBand band)
+{
+  u32 last_generation = 0;
+
+  std::unique_lock<std::mutex> lock(m_render_mutex);
+  for (;;)
+  {
+    m_render_work_cv.wait(lock, [this, last_generation]() {
+      return m_render_threads_shutdown || m_render_batch_generation != last_generation;
+    });
+    if (m_render_threads_shutdown)
+      break;
+
+    last_generation = m_render_batch_generation;
+    const u8* data = m_render_batch_data;
+    const u32 size = m_render_batch_size;
+    lock.unlock();
+
+    for (u32 offset = 0; offset < size;)
+    {
+      const GPUBackendDrawCommand* cmd = reinterpret_cast<const GPUBackendDrawCommand*>(&data[offset]);
+      DrawQueuedCommand(cmd, band);
+      offset += cmd->size;
+    }
+
+    lock.lock();
+    if (--m_render_threads_busy == 0)
+      m_render_done_cv.notify_one();
+  }
+}
+
+bool GPU_SW_Backend::CanQueueDraw(const GPUBackendDrawCommand* cmd) const
+{
+  if (m_render_threads.empty())
+    return false;
+
+  if (cmd->type == GPUBackendCommandType::DrawLine || !cmd->rc.texture_enable)
+    return true;
 
-void GPU_SW_Backend::DrawingAreaChanged() {}
+  // Draws only write to the drawing area, so a texture outside of it can't change during the batch.
+  const Common::Rectangle<u32> drawing_area(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right + 1,
+                                            m_drawing_area.bottom + 1);
+  return !TextureIntersects(cmd, drawing_area);
+}
+
+void GPU_SW_Backend::QueueDraw(const GPUBackendDrawCommand* cmd)
+{
+  std::vector<u8>& batch = m_render_batches[m_render_batch_index];
+  const size_t offset = batch.size();
+  batch.resize(offset + cmd->size);
+  std::memcpy(&batch[offset], cmd, cmd->size);
+
+  if (batch.size() >= RENDER_BATCH_SUBMIT_SIZE)
+    SubmitRenderBatch();
+}
+
+void GPU_SW_Backend::DrawQueuedCommand(const GPUBackendDrawCommand* cmd, const DrawBand& band)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+      DrawPolygon(static_cast<const GPUBackendDrawPolygonCommand*>(cmd), band);
+      break;
+
+    case GPUBackendCommandType::DrawRectangle:
+      DrawRectangle(static_cast<const GPUBackendDrawRectangleCommand*>(cmd), band);
+      break;
+
+    case GPUBackendCommandType::DrawLine:
+      DrawLine(static_cast<const GPUBackendDrawLineCommand*>(cmd), band);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
+void GPU_SW_Backend::SubmitRenderBatch()
+{
+  std::vector<u8>& batch = m_render_batches[m_render_batch_index];
+  if (batch.empty())
+    return;
+
+  WaitForRenderBatch();
+
+  {
+    std::unique_lock<std::mutex> lock(m_render_mutex);
+    m_render_batch_data = batch.data();
+    m_render_batch_size = static_cast<u32>(batch.size());
+    m_render_batch_generation++;
+    m_render_threads_busy = static_cast<u32>(m_render_threads.size());
+    m_render_work_cv.notify_all();
+  }
+
+  // The previous batch is done, so it can be reused while the threads draw this one.
+  m_render_batch_index ^= 1;
+  m_render_batches[m_render_batch_index].clear();
+}
+
+void GPU_SW_Backend::WaitForRenderBatch()
+{
+  std::unique_lock<std::mutex> lock(m_render_mutex);
+  m_render_done_cv.wait(lock, [this]() { return m_render_threads_busy == 0; });
+}
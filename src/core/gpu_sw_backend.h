@@ -1,7 +1,11 @@
 #pragma once
 #include "gpu_backend.h"
+#include "settings.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class GPU_SW_Backend final : public GPUBackend
@@ -11,7 +15,30 @@ public:
   ~GPU_SW_Backend() override;
 
   bool Initialize() override;
+  void UpdateSettings() override;
   void Reset() override;
+  void Shutdown() override;
+
+  /// Switches between the SSE2/NEON and scalar pixel shading. Both produce identical output.
+  static void SetSIMDEnabled(bool enabled);
+
+  /// Switches between sampling paletted textures from the decoded caches and from VRAM. Both produce identical output.
+  static void SetTextureCacheEnabled(bool enabled);
+
+  struct TextureCacheStats
+  {
+    u64 page_hits;
+    u64 page_misses;
+    u64 palette_hits;
+    u64 palette_misses;
+  };
+
+  /// Returns the texture cache lookups made by all drawing threads since the last reset.
+  TextureCacheStats GetTextureCacheStats() const;
+  void ResetTextureCacheStats();
+
+  /// Drops all decoded textures, for when VRAM is written behind the backend's back. The backend must be idle.
+  void InvalidateTextureCaches();
 
   ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
@@ -23,6 +50,53 @@ public:
   using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
   static constexpr DitherLUT ComputeDitherLUT();
 
+  /// Number of pixels shaded at once by the vector path.
+  static constexpr u32 SIMD_SPAN_WIDTH = 8;
+
+  static constexpr u32 TEXTURE_CACHE_PAGES = 4;
+  static constexpr u32 TEXTURE_CACHE_PALETTES = 16;
+  static constexpr u32 TEXTURE_CACHE_BLOCK_WIDTH = 16;
+
+  /// The palette indices of a 4-bit or 8-bit texture page, one byte per texel. Each row is decoded in blocks of
+  /// TEXTURE_CACHE_BLOCK_WIDTH texels when they are first sampled.
+  struct CachedTexturePage
+  {
+    Common::Rectangle<u32> rect;
+    u16 key;
+    bool valid;
+    u32 last_used;
+    std::array<u16, TEXTURE_PAGE_HEIGHT> decoded_blocks;
+    std::array<std::array<u8, TEXTURE_PAGE_WIDTH>, TEXTURE_PAGE_HEIGHT> indices;
+  };
+
+  struct CachedPalette
+  {
+    Common::Rectangle<u32> rect;
+    u32 key;
+    bool valid;
+    u32 last_used;
+    std::array<u16, 256> colors;
+  };
+
+  /// Decoded textures for one drawing thread, so they can be filled in without locking. Entries are never created
+  /// for textures which overlap the drawing area, so draws can't make them stale. VRAM transfers and drawing area
+  /// changes invalidate them, and those wait for the render threads to finish first.
+  struct TextureCache
+  {
+    std::array<CachedTexturePage, TEXTURE_CACHE_PAGES> pages;
+    std::array<CachedPalette, TEXTURE_CACHE_PALETTES> palettes;
+    u32 use_counter;
+
+    // Entries for the draw being shaded, null if the texture isn't cached.
+    CachedTexturePage* page;
+    const CachedPalette* palette;
+
+    std::atomic<u64> page_hits;
+    std::atomic<u64> page_misses;
+    std::atomic<u64> palette_hits;
+    std::atomic<u64> palette_misses;
+  };
+
 protected:
   static constexpr u8 Convert5To8(u8 x5) { return (x5 << 3) | (x5 & 7); }
   static constexpr u8 Convert8To5(u8 x8) { return (x8 >> 3); }
@@ -102,17 +176,77 @@ protected:
   void FlushRender() override;
   void DrawingAreaChanged() override;
 
+  //////////////////////////////////////////////////////////////////////////
+  // Parallel rendering
+  //////////////////////////////////////////////////////////////////////////
+  static constexpr u32 MAX_RENDER_THREADS = Settings::MAX_GPU_SW_RENDER_THREADS;
+  static constexpr u32 BAND_HEIGHT = 8;
+  static constexpr u32 RENDER_BATCH_SUBMIT_SIZE = 16 * 1024;
+
+  /// The rows drawn by one render thread, and its texture cache. VRAM is split into bands of BAND_HEIGHT lines, which
+  /// are dealt out to the threads in turn so that each gets an even share of the drawing area.
+  struct DrawBand
+  {
+    u32 index;
+    u32 count;
+    TextureCache* texture_cache;
+
+    ALWAYS_INLINE bool ContainsRow(s32 y) const { return ((static_cast<u32>(y) / BAND_HEIGHT) % count) == index; }
+  };
+
+  /// Band for drawing on the calling thread.
+  ALWAYS_INLINE DrawBand GetAllRowsBand() const { return DrawBand{0, 1, m_texture_cache.get()}; }
+
+  void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const DrawBand& band);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawBand& band);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const DrawBand& band);
+
+  void StartRenderThreads(u32 count);
+  void StopRenderThreads();
+  void RenderThreadLoop(DrawBand band);
+
+  /// Returns false if the draw samples the drawing area. The render threads can be at different points in the batch,
+  /// so those draws have to wait for the others to finish, and are then drawn on the calling thread.
+  bool CanQueueDraw(const GPUBackendDrawCommand* cmd) const;
+  void QueueDraw(const GPUBackendDrawCommand* cmd);
+  void DrawQueuedCommand(const GPUBackendDrawCommand* cmd, const DrawBand& band);
+
+  /// Hands the queued draws to the render threads, after they finish the previous batch.
+  void SubmitRenderBatch();
+  void WaitForRenderBatch();
+
+  //////////////////////////////////////////////////////////////////////////
+  // Texture cache
+  //////////////////////////////////////////////////////////////////////////
+  static std::unique_ptr<TextureCache> CreateTextureCache();
+
+  /// Points the cache at the decoded page and palette for the draw, decoding them if needed.
+  void BindTextureCache(TextureCache& cache, const GPUBackendDrawCommand* cmd);
+
+  /// Invalidates entries in all of the caches which overlap rect.
+  void InvalidateTextureCaches(const Common::Rectangle<u32>& rect);
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-  void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
-                  u8 texcoord_y);
+  void ShadePixel(const GPUBackendDrawCommand* cmd, TextureCache& cache, u32 x, u32 y, u8 color_r, u8 color_g,
+                  u8 color_b, u8 texcoord_x, u8 texcoord_y);
+
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawBand& band);
 
+  /// Returns false if the draw can read its texture or palette from the span [x, x + width) on line y. The vector
+  /// path fetches the texels for a group of pixels before writing any of them, so it would miss earlier writes.
+  static bool CanShadeSpanSIMD(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 width);
+
+  /// Draws count pixels of a rectangle row, count must be a multiple of SIMD_SPAN_WIDTH.
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawRectangleSpanSIMD(const GPUBackendDrawRectangleCommand* cmd, TextureCache& cache, u32 x, u32 y, u32 count,
+                             u8 r, u8 g, u8 b, u8 texcoord_x, u8 texcoord_y);
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd,
+                                                         const DrawBand& band);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -146,15 +280,22 @@ protected:
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                const i_deltas& idl);
+  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, TextureCache& cache, s32 y, s32 x_start, s32 x_bound,
+                i_group ig, const i_deltas& idl);
 
+  /// Draws count pixels of a polygon span, count must be a multiple of SIMD_SPAN_WIDTH. ig is at the first pixel.
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+  void DrawSpanSIMD(const GPUBackendDrawPolygonCommand* cmd, TextureCache& cache, u32 x, u32 y, u32 count,
+                    const i_group& ig, const i_deltas& idl);
 
-  using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
+  template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+           bool dithering_enable>
+  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const DrawBand& band,
+                    const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                    const GPUBackendDrawPolygonCommand::Vertex* v2);
+
+  using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd, const DrawBand& band,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v2);
@@ -162,13 +303,28 @@ protected:
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                const GPUBackendDrawLineCommand::Vertex* p1);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const DrawBand& band,
+                const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1);
 
-  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
+  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd, const DrawBand& band,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
                                                     const GPUBackendDrawLineCommand::Vertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
+  std::vector<std::thread> m_render_threads;
+  std::mutex m_render_mutex;
+  std::condition_variable m_render_work_cv;
+  std::condition_variable m_render_done_cv;
+  std::array<std::vector<u8>, 2> m_render_batches;
+  u32 m_render_batch_index = 0; // the batch being queued to, the other one may be being drawn
+  const u8* m_render_batch_data = nullptr;
+  u32 m_render_batch_size = 0;
+  u32 m_render_batch_generation = 0;
+  u32 m_render_threads_busy = 0;
+  bool m_render_threads_shutdown = false;
+
+  std::unique_ptr<TextureCache> m_texture_cache; // for draws on the GPU thread
+  std::vector<std::unique_ptr<TextureCache>> m_render_thread_texture_caches;
+
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
 };
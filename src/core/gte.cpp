@@ -1,12 +1,26 @@
 #include "gte.h"
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/cpu_detect.h"
 #include "common/state_wrapper.h"
 #include "cpu_core.h"
 #include "pgxp.h"
 #include "settings.h"
 #include <algorithm>
 #include <array>
+#include <tuple>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define GTE_SIMD 1
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define GTE_SIMD 1
+#endif
 
 namespace GTE {
 
@@ -21,6 +35,10 @@ static constexpr s32 IR123_MAX_VALUE = (INT64_C(1) << 15) - 1;
 
 #define REGS CPU::g_state.gte_regs
 
+#ifdef GTE_SIMD
+static bool s_simd_enabled = true;
+#endif
+
 ALWAYS_INLINE static u32 CountLeadingBits(u32 value)
 {
   // if top-most bit is set, we want to count ones not zeros
@@ -162,6 +180,22 @@ bool DoState(StateWrapper& sw)
   return !sw.HasError();
 }
 
+bool IsSIMDSupported()
+{
+#ifdef GTE_SIMD
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SetSIMDEnabled(bool enabled)
+{
+#ifdef GTE_SIMD
+  s_simd_enabled = enabled;
+#endif
+}
+
 u32 ReadRegister(u32 index)
 {
   DebugAssert(index < countof(REGS.r32));
@@ -366,6 +400,31 @@ static void PushRGBFromMAC()
   REGS.dr32[22] = r | (g << 8) | (b << 16) | (c << 24); // RGB2 <- Value
 }
 
+static constexpr std::array<u8, 257> s_unr_table = {{
+  0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
+  0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
+  0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
+  0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
+  0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
+  0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
+  0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
+  0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
+  0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
+  0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
+  0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
+  0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
+  0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
+  0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
+  0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
+  0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
+  0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
+}};
+
+const u8* GetUNRTable()
+{
+  return s_unr_table.data();
+}
+
 static u32 UNRDivide(u32 lhs, u32 rhs)
 {
   if (rhs * 2 <= lhs)
@@ -378,28 +437,8 @@ static u32 UNRDivide(u32 lhs, u32 rhs)
   lhs <<= shift;
   rhs <<= shift;
 
-  static constexpr std::array<u8, 257> unr_table = {{
-    0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
-    0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
-    0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
-    0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
-    0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
-    0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
-    0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
-    0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
-    0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
-    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
-    0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
-    0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
-    0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
-    0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
-    0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
-    0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
-    0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
-  }};
-
   const u32 divisor = rhs | 0x8000;
-  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
+  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(s_unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
   const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
   const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
 
@@ -410,8 +449,335 @@ static u32 UNRDivide(u32 lhs, u32 rhs)
   return std::min<u32>(0x1FFFF, result);
 }
 
+#ifdef GTE_SIMD
+
+// The vector paths compute MAC1-3 together in 32-bit lanes, lane 3 is ignored. They are only used when the translation
+// vector is small enough that none of the intermediate sums can leave the 44-bit range, so the only flags which can be
+// raised are the IR saturation flags. Otherwise, the scalar path is used, which also keeps the FLAG semantics exact.
+
+#if defined(CPU_X64)
+
+using SIMDVec = __m128i;
+
+ALWAYS_INLINE static SIMDVec SIMDZero()
+{
+  return _mm_setzero_si128();
+}
+
+ALWAYS_INLINE static SIMDVec SIMDSet(s32 a, s32 b, s32 c)
+{
+  return _mm_setr_epi32(a, b, c, 0);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDLoad(const s32* values)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+/// Loads the sign-extended low halfwords of three consecutive registers.
+ALWAYS_INLINE static SIMDVec SIMDLoadLowHalves(const u32* values)
+{
+  return _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)), 16), 16);
+}
+
+/// Multiplies lanes which contain sign-extended 16-bit values.
+ALWAYS_INLINE static SIMDVec SIMDMul16(SIMDVec a, SIMDVec b)
+{
+  // pmaddwd with the upper halves of a cleared is a 16x16->32 multiply.
+  return _mm_madd_epi16(_mm_and_si128(a, _mm_set1_epi32(0xFFFF)), b);
+}
+
+ALWAYS_INLINE static void SIMDMulMatVec(const s16 M[3][3], s16 Vx, s16 Vy, s16 Vz, SIMDVec* col0, SIMDVec* col1,
+                                        SIMDVec* col2)
+{
+  // Multiply the rows, the fourth halfword of each row is multiplied by zero.
+  const __m128i V = _mm_setr_epi16(Vx, Vy, Vz, 0, Vx, Vy, Vz, 0);
+  const __m128i row01 = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(M[0])),
+                                           _mm_loadl_epi64(reinterpret_cast<const __m128i*>(M[1])));
+  const __m128i row2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(M[2]));
+  const __m128i lo01 = _mm_mullo_epi16(row01, V);
+  const __m128i hi01 = _mm_mulhi_epi16(row01, V);
+  const __m128i lo2 = _mm_mullo_epi16(row2, V);
+  const __m128i hi2 = _mm_mulhi_epi16(row2, V);
+  const __m128i p0 = _mm_unpacklo_epi16(lo01, hi01);
+  const __m128i p1 = _mm_unpackhi_epi16(lo01, hi01);
+  const __m128i p2 = _mm_unpacklo_epi16(lo2, hi2);
+
+  // Transpose so that each lane is a row.
+  const __m128i t0 = _mm_unpacklo_epi32(p0, p1);
+  const __m128i t1 = _mm_unpackhi_epi32(p0, p1);
+  const __m128i t2 = _mm_unpacklo_epi32(p2, _mm_setzero_si128());
+  const __m128i t3 = _mm_unpackhi_epi32(p2, _mm_setzero_si128());
+  *col0 = _mm_unpacklo_epi64(t0, t2);
+  *col1 = _mm_unpackhi_epi64(t0, t2);
+  *col2 = _mm_unpacklo_epi64(t1, t3);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDAdd(SIMDVec a, SIMDVec b)
+{
+  return _mm_add_epi32(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDSub(SIMDVec a, SIMDVec b)
+{
+  return _mm_sub_epi32(a, b);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec SIMDShiftLeft(SIMDVec a)
+{
+  return _mm_slli_epi32(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec SIMDShiftRight(SIMDVec a)
+{
+  return _mm_srai_epi32(a, N);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDAndConstant(SIMDVec a, s32 b)
+{
+  return _mm_and_si128(a, _mm_set1_epi32(b));
+}
+
+ALWAYS_INLINE static SIMDVec SIMDClampIR(SIMDVec a, bool lm)
+{
+  __m128i packed = _mm_packs_epi32(a, a);
+  if (lm)
+    packed = _mm_max_epi16(packed, _mm_setzero_si128());
+
+  return _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+}
+
+/// Returns a bit for each of lanes 0-2 which differ.
+ALWAYS_INLINE static u32 SIMDNotEqualMask(SIMDVec a, SIMDVec b)
+{
+  return ~static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))) & 7u;
+}
+
+ALWAYS_INLINE static void SIMDStore(u32* dst, SIMDVec a)
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), a);
+  dst[2] = static_cast<u32>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(a, a)));
+}
+
+#elif defined(CPU_AARCH64)
+
+using SIMDVec = int32x4_t;
+
+ALWAYS_INLINE static SIMDVec SIMDZero()
+{
+  return vdupq_n_s32(0);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDSet(s32 a, s32 b, s32 c)
+{
+  const s32 values[4] = {a, b, c, 0};
+  return vld1q_s32(values);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDLoad(const s32* values)
+{
+  return vld1q_s32(values);
+}
+
+/// Loads the sign-extended low halfwords of three consecutive registers.
+ALWAYS_INLINE static SIMDVec SIMDLoadLowHalves(const u32* values)
+{
+  return vmovl_s16(vmovn_s32(vld1q_s32(reinterpret_cast<const s32*>(values))));
+}
+
+/// Multiplies lanes which contain sign-extended 16-bit values.
+ALWAYS_INLINE static SIMDVec SIMDMul16(SIMDVec a, SIMDVec b)
+{
+  return vmulq_s32(a, b);
+}
+
+ALWAYS_INLINE static void SIMDMulMatVec(const s16 M[3][3], s16 Vx, s16 Vy, s16 Vz, SIMDVec* col0, SIMDVec* col1,
+                                        SIMDVec* col2)
+{
+  // De-interleaving load, so each lane is a row. The fourth "row" is the next register, and ignored.
+  const int16x4x3_t cols = vld3_s16(&M[0][0]);
+  *col0 = vmull_n_s16(cols.val[0], Vx);
+  *col1 = vmull_n_s16(cols.val[1], Vy);
+  *col2 = vmull_n_s16(cols.val[2], Vz);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDAdd(SIMDVec a, SIMDVec b)
+{
+  return vaddq_s32(a, b);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDSub(SIMDVec a, SIMDVec b)
+{
+  return vsubq_s32(a, b);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec SIMDShiftLeft(SIMDVec a)
+{
+  return vshlq_n_s32(a, N);
+}
+
+template<int N>
+ALWAYS_INLINE static SIMDVec SIMDShiftRight(SIMDVec a)
+{
+  return vshrq_n_s32(a, N);
+}
+
+ALWAYS_INLINE static SIMDVec SIMDAndConstant(SIMDVec a, s32 b)
+{
+  return vandq_s32(a, vdupq_n_s32(b));
+}
+
+ALWAYS_INLINE static SIMDVec SIMDClampIR(SIMDVec a, bool lm)
+{
+  const int32x4_t clamped = vmovl_s16(vqmovn_s32(a));
+  return lm ? vmaxq_s32(clamped, vdupq_n_s32(0)) : clamped;
+}
+
+/// Returns a bit for each of lanes 0-2 which differ.
+ALWAYS_INLINE static u32 SIMDNotEqualMask(SIMDVec a, SIMDVec b)
+{
+  const uint32x4_t ne = vshrq_n_u32(vmvnq_u32(vceqq_s32(a, b)), 31);
+  return vgetq_lane_u32(ne, 0) | (vgetq_lane_u32(ne, 1) << 1) | (vgetq_lane_u32(ne, 2) << 2);
+}
+
+ALWAYS_INLINE static void SIMDStore(u32* dst, SIMDVec a)
+{
+  vst1_s32(reinterpret_cast<s32*>(dst), vget_low_s32(a));
+  vst1q_lane_s32(reinterpret_cast<s32*>(dst) + 2, a, 2);
+}
+
+#endif
+
+/// Returns true if T SHL 12 plus three 16x16 products can't leave the 44-bit MAC range.
+ALWAYS_INLINE static bool CanSkipMACOverflowCheck(s32 T0, s32 T1, s32 T2)
+{
+  return ((static_cast<u32>(T0) + 0x40000000u) | (static_cast<u32>(T1) + 0x40000000u) |
+          (static_cast<u32>(T2) + 0x40000000u)) < 0x80000000u;
+}
+
+namespace {
+/// Sum of T SHL 12 and 32-bit terms, kept as the low 32 bits and the sum SAR 12 without overflowing a lane.
+struct SIMDMACSum
+{
+  SIMDVec hi;
+  SIMDVec lo;
+  SIMDVec low32;
+
+  ALWAYS_INLINE explicit SIMDMACSum(SIMDVec T) : hi(T), lo(SIMDZero()), low32(SIMDShiftLeft<12>(T)) {}
+
+  ALWAYS_INLINE void Add(SIMDVec term)
+  {
+    hi = SIMDAdd(hi, SIMDShiftRight<12>(term));
+    lo = SIMDAdd(lo, SIMDAndConstant(term, 0xFFF));
+    low32 = SIMDAdd(low32, term);
+  }
+
+  ALWAYS_INLINE void Subtract(SIMDVec term)
+  {
+    hi = SIMDSub(hi, SIMDShiftRight<12>(term));
+    lo = SIMDSub(lo, SIMDAndConstant(term, 0xFFF));
+    low32 = SIMDSub(low32, term);
+  }
+
+  /// Returns the sum SAR 12.
+  ALWAYS_INLINE SIMDVec GetHigh() const { return SIMDAdd(hi, SIMDShiftRight<12>(lo)); }
+
+  /// Returns the MAC register value, i.e. the low 32 bits of the sum SAR shift.
+  ALWAYS_INLINE SIMDVec GetShifted(u8 shift) const { return (shift != 0) ? GetHigh() : low32; }
+};
+} // namespace
+
+// Maps a mask of the saturated lanes to the IR1-3 saturation flags.
+static constexpr std::array<u32, 8> s_ir_saturation_flags = {{0x0000000, 0x1000000, 0x0800000, 0x1800000, 0x0400000,
+                                                               0x1400000, 0x0C00000, 0x1C00000}};
+
+ALWAYS_INLINE static SIMDVec SaturateIRSIMD(SIMDVec value, bool lm)
+{
+  const SIMDVec clamped = SIMDClampIR(value, lm);
+  REGS.FLAG.bits |= s_ir_saturation_flags[SIMDNotEqualMask(clamped, value)];
+  return clamped;
+}
+
+ALWAYS_INLINE static SIMDVec SetMACAndIRSIMD(SIMDVec value, bool lm)
+{
+  SIMDStore(&REGS.dr32[25], value);
+
+  const SIMDVec clamped = SaturateIRSIMD(value, lm);
+  SIMDStore(&REGS.dr32[9], clamped);
+  return clamped;
+}
+
+static SIMDMACSum MulMatVecSIMD(SIMDVec T, const s16 M[3][3], s16 Vx, s16 Vy, s16 Vz)
+{
+  SIMDVec col0, col1, col2;
+  SIMDMulMatVec(M, Vx, Vy, Vz, &col0, &col1, &col2);
+
+  SIMDMACSum sum(T);
+  sum.Add(col0);
+  sum.Add(col1);
+  sum.Add(col2);
+  return sum;
+}
+
+/// Returns the unshifted MAC1-3 values.
+static std::tuple<s64, s64, s64> RTPSTransformSIMD(const s16 V[3], u8 shift, bool lm)
+{
+  const SIMDMACSum sum = MulMatVecSIMD(SIMDLoad(REGS.TR), REGS.RT, V[0], V[1], V[2]);
+  const SIMDVec value = sum.GetShifted(shift);
+  const SIMDVec high = sum.GetHigh();
+  SIMDStore(&REGS.dr32[25], value);
+
+  // IR3 is saturated from MAC3, but the flag comes from "MAC3 SAR 12", without lm.
+  const SIMDVec clamped = SIMDClampIR(value, lm);
+  SIMDStore(&REGS.dr32[9], clamped);
+  const u32 saturated =
+    (SIMDNotEqualMask(clamped, value) & 3u) | (SIMDNotEqualMask(SIMDClampIR(high, false), high) & 4u);
+  REGS.FLAG.bits |= s_ir_saturation_flags[saturated];
+
+  u32 hi[3], lo[3];
+  SIMDStore(hi, high);
+  SIMDStore(lo, sum.low32);
+  return std::make_tuple((s64(s32(hi[0])) << 12) | (lo[0] & 0xFFFu), (s64(s32(hi[1])) << 12) | (lo[1] & 0xFFFu),
+                         (s64(s32(hi[2])) << 12) | (lo[2] & 0xFFFu));
+}
+
+static void InterpolateColorSIMD(SIMDVec in_MAC, u8 shift, bool lm)
+{
+  // [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
+  // The intermediate MAC and IR values are overwritten below, only the flags remain.
+  SIMDMACSum diff(SIMDLoad(REGS.FC));
+  diff.Subtract(in_MAC);
+  const SIMDVec IR = SaturateIRSIMD(diff.GetShifted(shift), false);
+
+  // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12)
+  SIMDMACSum sum(SIMDZero());
+  sum.Add(in_MAC);
+  sum.Add(SIMDMul16(IR, SIMDSet(REGS.IR0, REGS.IR0, REGS.IR0)));
+  SetMACAndIRSIMD(sum.GetShifted(shift), lm);
+}
+
+/// Returns [R*IR1,G*IR2,B*IR3] SHL 4, which can't leave the 32-bit range.
+static SIMDVec MulColorByIRSIMD()
+{
+  const SIMDVec color = SIMDSet(REGS.RGBC[0], REGS.RGBC[1], REGS.RGBC[2]);
+  return SIMDShiftLeft<4>(SIMDMul16(SIMDLoadLowHalves(&REGS.dr32[9]), color));
+}
+
+#endif
+
 static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
+#ifdef GTE_SIMD
+  if (s_simd_enabled)
+  {
+    SetMACAndIRSIMD(MulMatVecSIMD(SIMDZero(), M, Vx, Vy, Vz).GetShifted(shift), lm);
+    return;
+  }
+#endif
+
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M[i][0]) * s64(Vx)) + (s64(M[i][1]) * s64(Vy))) +      \
                                   (s64(M[i][2]) * s64(Vz)),                                                            \
@@ -426,6 +792,14 @@ static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 V
 
 static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
+#ifdef GTE_SIMD
+  if (s_simd_enabled && CanSkipMACOverflowCheck(T[0], T[1], T[2]))
+  {
+    SetMACAndIRSIMD(MulMatVecSIMD(SIMDSet(T[0], T[1], T[2]), M, Vx, Vy, Vz).GetShifted(shift), lm);
+    return;
+  }
+#endif
+
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(                                                                                       \
     SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M[i][0]) * s64(Vx))) +              \
@@ -465,31 +839,33 @@ static void Execute_MVMVA(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  // TODO: Remove memcpy..
-  s16 M[3][3];
+  // The vector path loads past the end of the matrix, which is fine for the registers, but not the local copy.
+  const s16(*M)[3];
+  s16 buggy_M[4][3] = {};
   switch (inst.mvmva_multiply_matrix)
   {
     case 0:
-      std::memcpy(M, REGS.RT, sizeof(s16) * 3 * 3);
+      M = REGS.RT;
       break;
     case 1:
-      std::memcpy(M, REGS.LLM, sizeof(s16) * 3 * 3);
+      M = REGS.LLM;
       break;
     case 2:
-      std::memcpy(M, REGS.LCM, sizeof(s16) * 3 * 3);
+      M = REGS.LCM;
       break;
     default:
     {
       // buggy
-      M[0][0] = -static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
-      M[0][1] = static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
-      M[0][2] = REGS.IR0;
-      M[1][0] = REGS.RT[0][2];
-      M[1][1] = REGS.RT[0][2];
-      M[1][2] = REGS.RT[0][2];
-      M[2][0] = REGS.RT[1][1];
-      M[2][1] = REGS.RT[1][1];
-      M[2][2] = REGS.RT[1][1];
+      buggy_M[0][0] = -static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
+      buggy_M[0][1] = static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
+      buggy_M[0][2] = REGS.IR0;
+      buggy_M[1][0] = REGS.RT[0][2];
+      buggy_M[1][1] = REGS.RT[0][2];
+      buggy_M[1][2] = REGS.RT[0][2];
+      buggy_M[2][0] = REGS.RT[1][1];
+      buggy_M[2][1] = REGS.RT[1][1];
+      buggy_M[2][2] = REGS.RT[1][1];
+      M = buggy_M;
     }
     break;
   }
@@ -590,20 +966,30 @@ static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
   // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
   // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
-  const s64 x = dot3(0);
-  const s64 y = dot3(1);
-  const s64 z = dot3(2);
-  TruncateAndSetMAC<1>(x, shift);
-  TruncateAndSetMAC<2>(y, shift);
-  TruncateAndSetMAC<3>(z, shift);
-  TruncateAndSetIR<1>(REGS.MAC1, lm);
-  TruncateAndSetIR<2>(REGS.MAC2, lm);
-
-  // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then the
-  // IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is saturated
-  // when "MAC3" exceeds -8000h..+7FFFh).
-  TruncateAndSetIR<3>(s32(z >> 12), false);
-  REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
+  s64 x, y, z;
+#ifdef GTE_SIMD
+  if (s_simd_enabled && CanSkipMACOverflowCheck(REGS.TR[0], REGS.TR[1], REGS.TR[2]))
+  {
+    std::tie(x, y, z) = RTPSTransformSIMD(V, shift, lm);
+  }
+  else
+#endif
+  {
+    x = dot3(0);
+    y = dot3(1);
+    z = dot3(2);
+    TruncateAndSetMAC<1>(x, shift);
+    TruncateAndSetMAC<2>(y, shift);
+    TruncateAndSetMAC<3>(z, shift);
+    TruncateAndSetIR<1>(REGS.MAC1, lm);
+    TruncateAndSetIR<2>(REGS.MAC2, lm);
+
+    // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then
+    // the IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is
+    // saturated when "MAC3" exceeds -8000h..+7FFFh).
+    TruncateAndSetIR<3>(s32(z >> 12), false);
+    REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
+  }
 #undef dot3
 
   // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
@@ -844,8 +1230,16 @@ static void Execute_AVSZ4(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
-static void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm)
+static void InterpolateColor(s32 in_MAC1, s32 in_MAC2, s32 in_MAC3, u8 shift, bool lm)
 {
+#ifdef GTE_SIMD
+  if (s_simd_enabled && CanSkipMACOverflowCheck(REGS.FC[0], REGS.FC[1], REGS.FC[2]))
+  {
+    InterpolateColorSIMD(SIMDSet(in_MAC1, in_MAC2, in_MAC3), shift, lm);
+    return;
+  }
+#endif
+
   // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0
   //   [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
   TruncateAndSetMACAndIR<1>((s64(REGS.FC[0]) << 12) - in_MAC1, shift, false);
@@ -859,6 +1253,22 @@ static void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bo
   TruncateAndSetMACAndIR<3>(s64(s32(REGS.IR3) * s32(REGS.IR0)) + in_MAC3, shift, lm);
 }
 
+static void MulColorByIR(u8 shift, bool lm)
+{
+#ifdef GTE_SIMD
+  if (s_simd_enabled)
+  {
+    const SIMDVec value = MulColorByIRSIMD();
+    SetMACAndIRSIMD((shift != 0) ? SIMDShiftRight<12>(value) : value, lm);
+    return;
+  }
+#endif
+
+  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4, shift, lm);
+  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4, shift, lm);
+  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4, shift, lm);
+}
+
 static void NCS(const s16 V[3], u8 shift, bool lm)
 {
   // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
@@ -904,9 +1314,7 @@ static void NCCS(const s16 V[3], u8 shift, bool lm)
 
   // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for NCDx/NCCx
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)       ;<--- for NCDx/NCCx
-  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4, shift, lm);
+  MulColorByIR(shift, lm);
 
   // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
   PushRGBFromMAC();
@@ -991,9 +1399,7 @@ static void Execute_CC(Instruction inst)
 
   // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
-  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4, shift, lm);
+  MulColorByIR(shift, lm);
 
   // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
   PushRGBFromMAC();
@@ -9,6 +9,10 @@ void Initialize();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+// The transform and lighting commands use a vectorized implementation where the host has one.
+bool IsSIMDSupported();
+void SetSIMDEnabled(bool enabled);
+
 // control registers are offset by +32
 u32 ReadRegister(u32 index);
 void WriteRegister(u32 index, u32 value);
@@ -16,6 +20,9 @@ void WriteRegister(u32 index, u32 value);
 // use with care, direct register access
 u32* GetRegisterPtr(u32 index);
 
+// reciprocal table for the division in RTPS/RTPT, so the recompiler can inline them
+const u8* GetUNRTable();
+
 void ExecuteInstruction(u32 inst_bits);
 
 using InstructionImpl = void (*)(Instruction);
@@ -16,6 +16,7 @@
 #include "host_display.h"
 #include "pgxp.h"
 #include "save_state_version.h"
+#include "spu.h"
 #include "system.h"
 #include <cmath>
 #include <cstring>
@@ -45,6 +46,7 @@ HostInterface::~HostInterface()
 
 bool HostInterface::Initialize()
 {
+  System::StartStateChunkWorkers();
   return true;
 }
 
@@ -52,6 +54,8 @@ void HostInterface::Shutdown()
 {
   if (!System::IsShutdown())
     System::Shutdown();
+
+  System::StopStateChunkWorkers();
 }
 
 void HostInterface::CreateAudioStream()
@@ -382,7 +386,7 @@ bool HostInterface::SaveState(const char* filename)
   if (!stream)
     return false;
 
-  const bool result = System::SaveState(stream.get());
+  const bool result = System::SaveState(stream.get(), 128, g_settings.save_state_compression);
   if (!result)
   {
     ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
@@ -428,6 +432,11 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Main", "ConfirmPowerOff", true);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   si.SetBoolValue("Main", "ApplyGameSettings", true);
+  si.SetBoolValue("Main", "RewindEnable", false);
+  si.SetFloatValue("Main", "RewindFrequency", 0.5f);
+  si.SetIntValue("Main", "RewindMaxMemory", 256);
+  si.SetIntValue("Main", "RunaheadFrameCount", 0);
+  si.SetBoolValue("Main", "CompressSaveStates", true);
 
   si.SetStringValue("CPU", "ExecutionMode", Settings::GetCPUExecutionModeName(Settings::DEFAULT_CPU_EXECUTION_MODE));
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", false);
@@ -440,6 +449,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("GPU", "UseDebugDevice", false);
   si.SetBoolValue("GPU", "PerSampleShading", false);
   si.SetBoolValue("GPU", "UseThread", true);
+  si.SetIntValue("GPU", "SWRenderThreads", 0);
   si.SetBoolValue("GPU", "TrueColor", false);
   si.SetBoolValue("GPU", "ScaledDithering", true);
   si.SetStringValue("GPU", "TextureFilter", Settings::GetTextureFilterName(Settings::DEFAULT_GPU_TEXTURE_FILTER));
@@ -522,6 +532,7 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Debug", "ShowTimersState", false);
   si.SetBoolValue("Debug", "ShowMDECState", false);
   si.SetBoolValue("Debug", "ShowDMAState", false);
+  si.SetBoolValue("Debug", "ShowCodeCacheState", false);
 
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS));
   si.SetIntValue("Hacks", "DMAHaltTicks", static_cast<int>(Settings::DEFAULT_DMA_HALT_TICKS));
@@ -604,6 +615,7 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
                                Settings::GetAudioBackendName(g_settings.audio_backend));
       }
       DebugAssert(m_audio_stream);
+      g_spu.Sync();
       m_audio_stream.reset();
       CreateAudioStream();
       m_audio_stream->PauseOutput(System::IsPaused());
@@ -612,6 +624,13 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.emulation_speed != old_settings.emulation_speed)
       System::UpdateThrottlePeriod();
 
+    if (g_settings.rewind_enable != old_settings.rewind_enable ||
+        g_settings.rewind_save_frequency != old_settings.rewind_save_frequency ||
+        g_settings.rewind_max_memory != old_settings.rewind_max_memory)
+    {
+      System::UpdateRewindSettings();
+    }
+
     if (g_settings.cpu_execution_mode != old_settings.cpu_execution_mode ||
         g_settings.cpu_fastmem_mode != old_settings.cpu_fastmem_mode)
     {
@@ -644,12 +663,30 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
       CPU::ClearICache();
     }
 
+    if (g_settings.cpu_execution_mode != CPUExecutionMode::Interpreter &&
+        g_settings.cpu_recompiler_superblocks != old_settings.cpu_recompiler_superblocks)
+    {
+      AddOSDMessage(g_settings.cpu_recompiler_superblocks ?
+                      TranslateStdString("OSDMessage", "CPU superblocks enabled, flushing all blocks.") :
+                      TranslateStdString("OSDMessage", "CPU superblocks disabled, flushing all blocks."),
+                    5.0f);
+      CPU::CodeCache::Flush();
+    }
+
+    // RTPS/RTPT are only inlined by the recompiler when the projection isn't being adjusted.
+    if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+        g_settings.gpu_widescreen_hack != old_settings.gpu_widescreen_hack)
+    {
+      CPU::CodeCache::Flush();
+    }
+
     m_audio_stream->SetOutputVolume(GetAudioOutputVolume());
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_sw_render_threads != old_settings.gpu_sw_render_threads ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
@@ -694,6 +731,9 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_read_thread != old_settings.cdrom_read_thread)
       g_cdrom.SetUseReadThread(g_settings.cdrom_read_thread);
 
+    if (g_settings.audio_use_thread != old_settings.audio_use_thread)
+      g_spu.SetUseThread(g_settings.audio_use_thread);
+
     if (g_settings.memory_card_types != old_settings.memory_card_types ||
         g_settings.memory_card_paths != old_settings.memory_card_paths ||
         (g_settings.memory_card_use_playlist_title != old_settings.memory_card_use_playlist_title &&
@@ -58,7 +58,7 @@ public:
   virtual void DestroySystem();
 
   /// Loads state from the specified filename.
-  bool LoadState(const char* filename);
+  virtual bool LoadState(const char* filename);
 
   virtual void ReportError(const char* message);
   virtual void ReportMessage(const char* message);
@@ -13,8 +13,10 @@ MemoryCard::MemoryCard()
 {
   m_FLAG.no_write_yet = true;
 
-  m_save_event = TimingEvents::CreateTimingEvent("Memory Card Host Flush", GetSaveDelayInTicks(), GetSaveDelayInTicks(),
-                                                 std::bind(&MemoryCard::SaveIfChanged, this, true), false);
+  m_save_event = TimingEvents::CreateTimingEvent(
+    "Memory Card Host Flush", GetSaveDelayInTicks(), GetSaveDelayInTicks(),
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MemoryCard*>(param)->SaveIfChanged(true); },
+    this, false);
 }
 
 MemoryCard::~MemoryCard()
@@ -45,7 +47,7 @@ bool MemoryCard::DoState(StateWrapper& sw)
   sw.Do(&m_sector_offset);
   sw.Do(&m_checksum);
   sw.Do(&m_last_byte);
-  sw.Do(&m_data);
+  sw.DoPagedRegion(m_data.data(), m_data.size());
   sw.Do(&m_changed);
 
   return !sw.HasError();
@@ -13,7 +13,14 @@ struct SAVE_STATE_HEADER
   enum : u32
   {
     MAX_TITLE_LENGTH = 128,
-    MAX_GAME_CODE_LENGTH = 32
+    MAX_GAME_CODE_LENGTH = 32,
+
+    COMPRESSION_TYPE_NONE = 0,
+    COMPRESSION_TYPE_DEFLATE = 1,
+
+    // Compressed data is split into independently-deflated chunks of this size, prefixed by a chunk count and a
+    // table of compressed chunk sizes, so that it can be (de)compressed in parallel.
+    COMPRESSION_CHUNK_SIZE = 256 * 1024
   };
 
   u32 magic;
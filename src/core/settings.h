@@ -76,6 +76,8 @@ struct Settings
   bool cpu_overclock_active = false;
   bool cpu_recompiler_memory_exceptions = false;
   bool cpu_recompiler_icache = false;
+  u32 cpu_recompiler_compile_threshold = 0;
+  bool cpu_recompiler_superblocks = false;
   CPUFastmemMode cpu_fastmem_mode = CPUFastmemMode::Disabled;
 
   float emulation_speed = 1.0f;
@@ -90,12 +92,21 @@ struct Settings
   bool apply_game_settings = true;
   bool auto_load_cheats = false;
 
+  // Rewind states between keyframes only store the memory pages which changed, but finding them compares all of RAM,
+  // VRAM and SPU RAM, so saving a state takes about as long regardless of how much the game wrote.
+  bool rewind_enable = false;
+  float rewind_save_frequency = 0.5f;
+  u32 rewind_max_memory = 256; // in megabytes
+  u32 runahead_frames = 0;
+  bool save_state_compression = true;
+
   GPURenderer gpu_renderer = GPURenderer::Software;
   std::string gpu_adapter;
   std::string display_post_process_chain;
   u32 gpu_resolution_scale = 1;
   u32 gpu_multisamples = 1;
   bool gpu_use_thread = true;
+  u32 gpu_sw_render_threads = 0; // draws on the GPU thread when zero
   bool gpu_use_debug_device = false;
   bool gpu_per_sample_shading = false;
   bool gpu_true_color = true;
@@ -146,6 +157,7 @@ struct Settings
   u32 audio_buffer_size = 2048;
   bool audio_output_muted = false;
   bool audio_sync_enabled = true;
+  bool audio_use_thread = false;
   bool audio_dump_on_boot = true;
 
   // timing hacks section
@@ -167,6 +179,7 @@ struct Settings
     mutable bool show_timers_state = false;
     mutable bool show_mdec_state = false;
     mutable bool show_dma_state = false;
+    mutable bool show_code_cache_state = false;
   } debugging;
 
   // TODO: Controllers, memory cards, etc.
@@ -220,7 +233,8 @@ struct Settings
     DEFAULT_DMA_MAX_SLICE_TICKS = 1000,
     DEFAULT_DMA_HALT_TICKS = 100,
     DEFAULT_GPU_FIFO_SIZE = 16,
-    DEFAULT_GPU_MAX_RUN_AHEAD = 128
+    DEFAULT_GPU_MAX_RUN_AHEAD = 128,
+    MAX_GPU_SW_RENDER_THREADS = 16
   };
 
   void Load(SettingsInterface& si);
@@ -1,10 +1,12 @@
 #include "spu.h"
 #include "cdrom.h"
 #include "common/audio_stream.h"
+#include "common/cpu_detect.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "common/wav_writer.h"
 #include "dma.h"
+#include "frame_profiler.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
 #include "system.h"
@@ -13,8 +15,25 @@
 #endif
 Log_SetChannel(SPU);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define SPU_SIMD 1
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define SPU_SIMD 1
+#endif
+
 SPU g_spu;
 
+#ifdef SPU_SIMD
+static bool s_simd_enabled = true;
+#endif
+static bool s_optimized_reverb_enabled = true;
+
 SPU::SPU() = default;
 
 SPU::~SPU() = default;
@@ -24,11 +43,16 @@ void SPU::Initialize()
   // (X * D) / N / 768 -> (X * D) / (N * 768)
   m_cpu_ticks_per_spu_tick = System::ScaleTicksToOverclock(SYSCLK_TICKS_PER_SPU_TICK);
   m_cpu_tick_divider = static_cast<TickCount>(g_settings.cpu_overclock_numerator * SYSCLK_TICKS_PER_SPU_TICK);
-  m_tick_event = TimingEvents::CreateTimingEvent("SPU Sample", m_cpu_ticks_per_spu_tick, m_cpu_ticks_per_spu_tick,
-                                                 std::bind(&SPU::Execute, this, std::placeholders::_1), false);
-  m_transfer_event =
-    TimingEvents::CreateTimingEvent("SPU Transfer", TRANSFER_TICKS_PER_HALFWORD, TRANSFER_TICKS_PER_HALFWORD,
-                                    std::bind(&SPU::ExecuteTransfer, this, std::placeholders::_1), false);
+  m_tick_event = TimingEvents::CreateTimingEvent(
+    "SPU Sample", m_cpu_ticks_per_spu_tick, m_cpu_ticks_per_spu_tick,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<SPU*>(param)->Execute(ticks); }, this, false);
+  m_transfer_event = TimingEvents::CreateTimingEvent(
+    "SPU Transfer", TRANSFER_TICKS_PER_HALFWORD, TRANSFER_TICKS_PER_HALFWORD,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<SPU*>(param)->ExecuteTransfer(ticks); }, this,
+    false);
+
+  if (g_settings.audio_use_thread)
+    StartThread();
 
   Reset();
 }
@@ -44,6 +68,7 @@ void SPU::CPUClockChanged()
 
 void SPU::Shutdown()
 {
+  StopThread();
   m_tick_event.reset();
   m_transfer_event.reset();
   m_dump_writer.reset();
@@ -51,6 +76,7 @@ void SPU::Shutdown()
 
 void SPU::Reset()
 {
+  Sync();
   m_ticks_carry = 0;
 
   m_SPUCNT.bits = 0;
@@ -83,6 +109,7 @@ void SPU::Reset()
   m_reverb_downsample_buffer = {};
   m_reverb_upsample_buffer = {};
   m_reverb_resample_buffer_position = 0;
+  UpdateReverbAccessOffsets();
 
   for (u32 i = 0; i < NUM_VOICES; i++)
   {
@@ -94,6 +121,9 @@ void SPU::Reset()
     v.is_first_block = 0;
     v.current_block_samples.fill(s16(0));
     v.adpcm_last_samples.fill(s32(0));
+    v.last_volume = 0;
+    v.left_volume = {};
+    v.right_volume = {};
     v.adsr_envelope.Reset(0, false, false);
     v.adsr_phase = ADSRPhase::Off;
     v.adsr_target = 0;
@@ -109,6 +139,7 @@ void SPU::Reset()
 
 bool SPU::DoState(StateWrapper& sw)
 {
+  Sync();
   sw.Do(&m_ticks_carry);
   sw.Do(&m_SPUCNT.bits);
   sw.Do(&m_SPUSTAT.bits);
@@ -166,10 +197,11 @@ bool SPU::DoState(StateWrapper& sw)
   }
 
   sw.Do(&m_transfer_fifo);
-  sw.DoBytes(m_ram.data(), RAM_SIZE);
+  sw.DoPagedRegion(m_ram.data(), RAM_SIZE);
 
   if (sw.IsReading())
   {
+    UpdateReverbAccessOffsets();
     g_host_interface->GetAudioStream()->EmptyBuffers();
     UpdateEventInterval();
     UpdateTransferEvent();
@@ -180,6 +212,10 @@ bool SPU::DoState(StateWrapper& sw)
 
 u16 SPU::ReadRegister(u32 offset)
 {
+  // Queued writes have to be applied before the registers can be read back. Registers which mixing changes also
+  // wait for the frames before them below.
+  SyncRegisterWrites();
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -195,15 +231,19 @@ u16 SPU::ReadRegister(u32 offset)
       return m_reverb_registers.vROUT;
 
     case 0x1F801D88 - SPU_BASE:
+      Sync();
       return Truncate16(m_key_on_register);
 
     case 0x1F801D8A - SPU_BASE:
+      Sync();
       return Truncate16(m_key_on_register >> 16);
 
     case 0x1F801D8C - SPU_BASE:
+      Sync();
       return Truncate16(m_key_off_register);
 
     case 0x1F801D8E - SPU_BASE:
+      Sync();
       return Truncate16(m_key_off_register >> 16);
 
     case 0x1F801D90 - SPU_BASE:
@@ -225,9 +265,11 @@ u16 SPU::ReadRegister(u32 offset)
       return Truncate16(m_reverb_on_register >> 16);
 
     case 0x1F801D9C - SPU_BASE:
+      Sync();
       return Truncate16(m_endx_register);
 
     case 0x1F801D9E - SPU_BASE:
+      Sync();
       return Truncate16(m_endx_register >> 16);
 
     case 0x1F801DA2 - SPU_BASE:
@@ -254,8 +296,9 @@ u16 SPU::ReadRegister(u32 offset)
       return m_transfer_control.bits;
 
     case 0x1F801DAE - SPU_BASE:
-      m_tick_event->InvokeEarly();
+      CatchUpVoices();
       m_transfer_event->InvokeEarly();
+      m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
       Log_TracePrintf("SPU status register -> 0x%04X", ZeroExtend32(m_SPUCNT.bits));
       return m_SPUSTAT.bits;
 
@@ -272,11 +315,11 @@ u16 SPU::ReadRegister(u32 offset)
       return m_external_volume_right;
 
     case 0x1F801DB8 - SPU_BASE:
-      m_tick_event->InvokeEarly();
+      CatchUpVoices();
       return m_main_volume_left.current_level;
 
     case 0x1F801DBA - SPU_BASE:
-      m_tick_event->InvokeEarly();
+      CatchUpVoices();
       return m_main_volume_right.current_level;
 
     default:
@@ -290,7 +333,7 @@ u16 SPU::ReadRegister(u32 offset)
       if (offset >= (0x1F801E00 - SPU_BASE) && offset < (0x1F801E60 - SPU_BASE))
       {
         const u32 voice_index = (offset - (0x1F801E00 - SPU_BASE)) / 4;
-        m_tick_event->InvokeEarly();
+        CatchUpVoices();
         if (offset & 0x02)
           return m_voices[voice_index].left_volume.current_level;
         else
@@ -304,13 +347,126 @@ u16 SPU::ReadRegister(u32 offset)
 }
 
 void SPU::WriteRegister(u32 offset, u16 value)
+{
+  switch (offset)
+  {
+    case 0x1F801DA6 - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU transfer address register <- 0x%04X", ZeroExtend32(value));
+      m_transfer_address_reg = value;
+      m_transfer_address = ZeroExtend32(value) * 8;
+      return;
+    }
+
+    case 0x1F801DA8 - SPU_BASE:
+    {
+      Log_TracePrintf("SPU transfer data register <- 0x%04X (RAM offset 0x%08X)", ZeroExtend32(value),
+                      m_transfer_address);
+
+      ManualTransferWrite(value);
+      return;
+    }
+
+    case 0x1F801DAA - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU control register <- 0x%04X", ZeroExtend32(value));
+      m_tick_event->InvokeEarly(true);
+
+      // The thread has to be idle before changing the control register, since it switches between threaded and
+      // synchronous mixing when the IRQ is enabled.
+      Sync();
+
+      const SPUCNT new_value{value};
+      if (new_value.ram_transfer_mode != m_SPUCNT.ram_transfer_mode &&
+          new_value.ram_transfer_mode == RAMTransferMode::Stopped)
+      {
+        // clear the fifo here?
+        if (!m_transfer_fifo.IsEmpty())
+        {
+          if (m_SPUCNT.ram_transfer_mode == RAMTransferMode::DMAWrite)
+            Log_WarningPrintf("Clearing SPU transfer FIFO with %u bytes left", m_transfer_fifo.GetSize());
+
+          m_transfer_fifo.Clear();
+        }
+      }
+
+      if (!new_value.enable && m_SPUCNT.enable)
+      {
+        // Mute all voices.
+        // Interestingly, hardware tests found this seems to happen immediately, not on the next 44100hz cycle.
+        for (u32 i = 0; i < NUM_VOICES; i++)
+          m_voices[i].ForceOff();
+      }
+
+      m_SPUCNT.bits = new_value.bits;
+      m_SPUSTAT.mode = m_SPUCNT.mode.GetValue();
+
+      if (!m_SPUCNT.irq9_enable)
+        m_SPUSTAT.irq9_flag = false;
+
+      UpdateEventInterval();
+      UpdateDMARequest();
+      UpdateTransferEvent();
+      return;
+    }
+
+    case 0x1F801DAC - SPU_BASE:
+    {
+      Log_DebugPrintf("SPU transfer control register <- 0x%04X", ZeroExtend32(value));
+      m_transfer_control.bits = value;
+      return;
+    }
+
+      // read-only registers
+    case 0x1F801DAE - SPU_BASE:
+    {
+      return;
+    }
+
+    case 0x1F801DB4 - SPU_BASE:
+    case 0x1F801DB6 - SPU_BASE:
+    {
+      // External volumes aren't used, so don't bother syncing.
+      if (IsMixingOnThread())
+        QueueRegisterWrite(offset, value);
+      else
+        ApplyRegisterWrite(offset, value);
+      return;
+    }
+
+    default:
+    {
+      if (offset < (0x1F801D80 - SPU_BASE))
+      {
+        WriteVoiceRegister(offset, value);
+        return;
+      }
+
+      m_tick_event->InvokeEarly();
+      if (IsMixingOnThread())
+        QueueRegisterWrite(offset, value);
+      else
+        ApplyRegisterWrite(offset, value);
+
+      // Key on, pitch modulation and the IRQ address change where the next RAM IRQ can happen.
+      if (offset == (0x1F801D88 - SPU_BASE) || offset == (0x1F801D8A - SPU_BASE) ||
+          offset == (0x1F801D90 - SPU_BASE) || offset == (0x1F801D92 - SPU_BASE) || offset == (0x1F801DA4 - SPU_BASE))
+      {
+        UpdateEventInterval();
+      }
+
+      return;
+    }
+  }
+}
+
+void SPU::ApplyRegisterWrite(u32 offset, u16 value)
 {
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
     {
       Log_DebugPrintf("SPU main volume left <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_main_volume_left_reg.bits = value;
       m_main_volume_left.Reset(m_main_volume_left_reg);
       return;
@@ -319,7 +475,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D82 - SPU_BASE:
     {
       Log_DebugPrintf("SPU main volume right <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_main_volume_right_reg.bits = value;
       m_main_volume_right.Reset(m_main_volume_right_reg);
       return;
@@ -328,7 +483,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D84 - SPU_BASE:
     {
       Log_DebugPrintf("SPU reverb output volume left <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_reverb_registers.vLOUT = value;
       return;
     }
@@ -336,7 +490,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D86 - SPU_BASE:
     {
       Log_DebugPrintf("SPU reverb output volume right <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_reverb_registers.vROUT = value;
       return;
     }
@@ -344,7 +497,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D88 - SPU_BASE:
     {
       Log_DebugPrintf("SPU key on low <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_key_on_register = (m_key_on_register & 0xFFFF0000) | ZeroExtend32(value);
     }
     break;
@@ -352,7 +504,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D8A - SPU_BASE:
     {
       Log_DebugPrintf("SPU key on high <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_key_on_register = (m_key_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
     }
     break;
@@ -360,7 +511,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D8C - SPU_BASE:
     {
       Log_DebugPrintf("SPU key off low <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_key_off_register = (m_key_off_register & 0xFFFF0000) | ZeroExtend32(value);
     }
     break;
@@ -368,14 +518,12 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D8E - SPU_BASE:
     {
       Log_DebugPrintf("SPU key off high <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_key_off_register = (m_key_off_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
     }
     break;
 
     case 0x1F801D90 - SPU_BASE:
     {
-      m_tick_event->InvokeEarly();
       m_pitch_modulation_enable_register = (m_pitch_modulation_enable_register & 0xFFFF0000) | ZeroExtend32(value);
       Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
     }
@@ -383,7 +531,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
 
     case 0x1F801D92 - SPU_BASE:
     {
-      m_tick_event->InvokeEarly();
       m_pitch_modulation_enable_register =
         (m_pitch_modulation_enable_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
       Log_DebugPrintf("SPU pitch modulation enable register <- 0x%08X", m_pitch_modulation_enable_register);
@@ -393,7 +540,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D94 - SPU_BASE:
     {
       Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_noise_mode_register = (m_noise_mode_register & 0xFFFF0000) | ZeroExtend32(value);
     }
     break;
@@ -401,7 +547,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D96 - SPU_BASE:
     {
       Log_DebugPrintf("SPU noise mode register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_noise_mode_register = (m_noise_mode_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
     }
     break;
@@ -409,7 +554,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D98 - SPU_BASE:
     {
       Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_reverb_on_register = (m_reverb_on_register & 0xFFFF0000) | ZeroExtend32(value);
     }
     break;
@@ -417,7 +561,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801D9A - SPU_BASE:
     {
       Log_DebugPrintf("SPU reverb on register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_reverb_on_register = (m_reverb_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
     }
     break;
@@ -425,7 +568,6 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801DA2 - SPU_BASE:
     {
       Log_DebugPrintf("SPU reverb base address < 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_reverb_registers.mBASE = value;
       m_reverb_base_address = ZeroExtend32(value << 2) & 0x3FFFFu;
       m_reverb_current_address = m_reverb_base_address;
@@ -435,78 +577,13 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801DA4 - SPU_BASE:
     {
       Log_DebugPrintf("SPU IRQ address register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_irq_address = value;
       return;
     }
 
-    case 0x1F801DA6 - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU transfer address register <- 0x%04X", ZeroExtend32(value));
-      m_transfer_address_reg = value;
-      m_transfer_address = ZeroExtend32(value) * 8;
-      return;
-    }
-
-    case 0x1F801DA8 - SPU_BASE:
-    {
-      Log_TracePrintf("SPU transfer data register <- 0x%04X (RAM offset 0x%08X)", ZeroExtend32(value),
-                      m_transfer_address);
-
-      ManualTransferWrite(value);
-      return;
-    }
-
-    case 0x1F801DAA - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU control register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly(true);
-
-      const SPUCNT new_value{value};
-      if (new_value.ram_transfer_mode != m_SPUCNT.ram_transfer_mode &&
-          new_value.ram_transfer_mode == RAMTransferMode::Stopped)
-      {
-        // clear the fifo here?
-        if (!m_transfer_fifo.IsEmpty())
-        {
-          if (m_SPUCNT.ram_transfer_mode == RAMTransferMode::DMAWrite)
-            Log_WarningPrintf("Clearing SPU transfer FIFO with %u bytes left", m_transfer_fifo.GetSize());
-
-          m_transfer_fifo.Clear();
-        }
-      }
-
-      if (!new_value.enable && m_SPUCNT.enable)
-      {
-        // Mute all voices.
-        // Interestingly, hardware tests found this seems to happen immediately, not on the next 44100hz cycle.
-        for (u32 i = 0; i < NUM_VOICES; i++)
-          m_voices[i].ForceOff();
-      }
-
-      m_SPUCNT.bits = new_value.bits;
-      m_SPUSTAT.mode = m_SPUCNT.mode.GetValue();
-
-      if (!m_SPUCNT.irq9_enable)
-        m_SPUSTAT.irq9_flag = false;
-
-      UpdateEventInterval();
-      UpdateDMARequest();
-      UpdateTransferEvent();
-      return;
-    }
-
-    case 0x1F801DAC - SPU_BASE:
-    {
-      Log_DebugPrintf("SPU transfer control register <- 0x%04X", ZeroExtend32(value));
-      m_transfer_control.bits = value;
-      return;
-    }
-
     case 0x1F801DB0 - SPU_BASE:
     {
       Log_DebugPrintf("SPU left cd audio register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_cd_audio_volume_left = value;
     }
     break;
@@ -514,14 +591,12 @@ void SPU::WriteRegister(u32 offset, u16 value)
     case 0x1F801DB2 - SPU_BASE:
     {
       Log_DebugPrintf("SPU right cd audio register <- 0x%04X", ZeroExtend32(value));
-      m_tick_event->InvokeEarly();
       m_cd_audio_volume_right = value;
     }
     break;
 
     case 0x1F801DB4 - SPU_BASE:
     {
-      // External volumes aren't used, so don't bother syncing.
       Log_DebugPrintf("SPU left external volume register <- 0x%04X", ZeroExtend32(value));
       m_external_volume_left = value;
     }
@@ -529,23 +604,16 @@ void SPU::WriteRegister(u32 offset, u16 value)
 
     case 0x1F801DB6 - SPU_BASE:
     {
-      // External volumes aren't used, so don't bother syncing.
       Log_DebugPrintf("SPU right external volume register <- 0x%04X", ZeroExtend32(value));
       m_external_volume_right = value;
     }
     break;
 
-      // read-only registers
-    case 0x1F801DAE - SPU_BASE:
-    {
-      return;
-    }
-
     default:
     {
       if (offset < (0x1F801D80 - SPU_BASE))
       {
-        WriteVoiceRegister(offset, value);
+        ApplyVoiceRegisterWrite(offset, value);
         return;
       }
 
@@ -553,8 +621,8 @@ void SPU::WriteRegister(u32 offset, u16 value)
       {
         const u32 reg = (offset - (0x1F801DC0 - SPU_BASE)) / 2;
         Log_DebugPrintf("SPU reverb register %u <- 0x%04X", reg, value);
-        m_tick_event->InvokeEarly();
         m_reverb_registers.rev[reg] = value;
+        UpdateReverbAccessOffsets();
         return;
       }
 
@@ -572,15 +640,44 @@ u16 SPU::ReadVoiceRegister(u32 offset)
   Assert(voice_index < 24);
 
   // ADSR volume needs to be updated when reading. A voice might be off as well, but key on is pending.
+  // The ADSR volume and repeat address are changed by mixing, so the thread has to catch up before either is read.
   const Voice& voice = m_voices[voice_index];
-  if (reg_index >= 6 && (voice.IsOn() || m_key_on_register & (1u << voice_index)))
-    m_tick_event->InvokeEarly();
+  if (reg_index >= 6)
+  {
+    Sync();
+    if (voice.IsOn() || m_key_on_register & (1u << voice_index))
+      CatchUpVoices();
+  }
 
   Log_TracePrintf("Read voice %u register %u -> 0x%02X", voice_index, reg_index, voice.regs.index[reg_index]);
   return voice.regs.index[reg_index];
 }
 
 void SPU::WriteVoiceRegister(u32 offset, u16 value)
+{
+  if (IsMixingOnThread())
+  {
+    // The voice state belongs to the thread, so always catch up.
+    m_tick_event->InvokeEarly();
+    QueueRegisterWrite(offset, value);
+    return;
+  }
+
+  // Voices which are off still fetch blocks while the IRQ is enabled, so they need to be caught up too.
+  const u32 reg_index = (offset % 0x10);
+  const u32 voice_index = (offset / 0x10);
+  const Voice& voice = m_voices[voice_index];
+  if (voice.IsOn() || m_key_on_register & (1u << voice_index) || m_SPUCNT.irq9_enable)
+    m_tick_event->InvokeEarly();
+
+  ApplyVoiceRegisterWrite(offset, value);
+
+  // The sample rate and repeat address change where the next RAM IRQ can happen.
+  if (reg_index == 0x04 || reg_index == 0x0E)
+    UpdateEventInterval();
+}
+
+void SPU::ApplyVoiceRegisterWrite(u32 offset, u16 value)
 {
   // per-voice registers
   const u32 reg_index = (offset % 0x10);
@@ -588,9 +685,6 @@ void SPU::WriteVoiceRegister(u32 offset, u16 value)
   DebugAssert(voice_index < 24);
 
   Voice& voice = m_voices[voice_index];
-  if (voice.IsOn() || m_key_on_register & (1u << voice_index))
-    m_tick_event->InvokeEarly();
-
   switch (reg_index)
   {
     case 0x00: // volume left
@@ -703,16 +797,20 @@ void SPU::IncrementCaptureBufferPosition()
 {
   m_capture_buffer_position += sizeof(s16);
   m_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
-  m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
 }
 
 void SPU::ExecuteTransfer(TickCount ticks)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::SPU);
+
   const RAMTransferMode mode = m_SPUCNT.ram_transfer_mode;
   Assert(mode != RAMTransferMode::Stopped);
 
   if (mode == RAMTransferMode::DMARead)
   {
+    // The thread writes the capture buffers and reverb work area while mixing.
+    Sync();
+
     while (ticks > 0 && !m_transfer_fifo.IsFull())
     {
       while (ticks > 0 && !m_transfer_fifo.IsFull())
@@ -743,21 +841,34 @@ void SPU::ExecuteTransfer(TickCount ticks)
   }
   else
   {
+    // Voices have to catch up before their sample data is overwritten when the IRQ is predicted ahead of time.
+    if (m_SPUCNT.irq9_enable)
+      m_tick_event->InvokeEarly();
+
     // write the fifo to ram, request dma again when empty
     while (ticks > 0 && !m_transfer_fifo.IsEmpty())
     {
+      std::array<u16, FIFO_SIZE_IN_HALFWORDS> values;
+      u32 count = 0;
       while (ticks > 0 && !m_transfer_fifo.IsEmpty())
       {
-        u16 value = m_transfer_fifo.Pop();
-        std::memcpy(&m_ram[m_transfer_address], &value, sizeof(u16));
-        m_transfer_address = (m_transfer_address + sizeof(u16)) & RAM_MASK;
+        values[count++] = m_transfer_fifo.Pop();
         ticks -= TRANSFER_TICKS_PER_HALFWORD;
       }
 
+      // The thread may not have mixed the frames before the write yet, so it goes in the queue behind them.
+      if (IsMixingOnThread())
+        QueueRAMWrite(m_transfer_address, values.data(), count);
+      else
+        WriteRAM(m_transfer_address, values.data(), count);
+      m_transfer_address = (m_transfer_address + (count * sizeof(u16))) & RAM_MASK;
+
       // similar deal here, the FIFO can be written out in a long slice
       UpdateDMARequest();
     }
 
+    UpdateEventInterval();
+
     // we're done if we have no more data to write
     if (m_transfer_fifo.IsEmpty())
     {
@@ -773,6 +884,15 @@ void SPU::ExecuteTransfer(TickCount ticks)
   }
 }
 
+void SPU::WriteRAM(u32 address, const u16* values, u32 count)
+{
+  for (u32 i = 0; i < count; i++)
+  {
+    std::memcpy(&m_ram[address], &values[i], sizeof(u16));
+    address = (address + sizeof(u16)) & RAM_MASK;
+  }
+}
+
 void SPU::ManualTransferWrite(u16 value)
 {
   if (m_transfer_fifo.IsFull())
@@ -934,6 +1054,7 @@ void SPU::GeneratePendingSamples()
 
 bool SPU::StartDumpingAudio(const char* filename)
 {
+  Sync();
   if (m_dump_writer)
     m_dump_writer.reset();
 
@@ -953,10 +1074,247 @@ bool SPU::StopDumpingAudio()
   if (!m_dump_writer)
     return false;
 
+  Sync();
   m_dump_writer.reset();
   return true;
 }
 
+void SPU::SetSIMDEnabled(bool enabled)
+{
+#ifdef SPU_SIMD
+  s_simd_enabled = enabled;
+#endif
+}
+
+void SPU::SetOptimizedReverbEnabled(bool enabled)
+{
+  s_optimized_reverb_enabled = enabled;
+}
+
+void SPU::SetUseThread(bool enabled)
+{
+  if (m_use_thread == enabled)
+    return;
+
+  if (enabled)
+    StartThread();
+  else
+    StopThread();
+
+  UpdateEventInterval();
+}
+
+void SPU::CatchUpVoices()
+{
+  m_tick_event->InvokeEarly();
+  Sync();
+}
+
+void SPU::StartThread()
+{
+  m_thread_done.store(false);
+  m_thread_queue_read_ptr.store(0);
+  m_thread_queue_write_ptr.store(0);
+  m_thread_register_writes_applied.store(0);
+  m_thread_register_writes_queued = 0;
+  m_use_thread = true;
+  m_thread = std::thread(&SPU::RunThreadLoop, this);
+  Log_InfoPrint("SPU thread started.");
+}
+
+void SPU::StopThread()
+{
+  if (!m_use_thread)
+    return;
+
+  Sync();
+  m_thread_done.store(true);
+  WakeThread();
+  m_thread.join();
+  m_use_thread = false;
+  Log_InfoPrint("SPU thread stopped.");
+}
+
+void SPU::WakeThread()
+{
+  std::unique_lock<std::mutex> lock(m_thread_mutex);
+  if (!m_thread_sleeping.load())
+    return;
+
+  m_wake_thread_cv.notify_one();
+}
+
+void SPU::SyncThread()
+{
+  u32* cmd = AllocateThreadCommand(1);
+  cmd[0] = static_cast<u32>(ThreadCommand::Sync) << 28;
+  PushThreadCommand(1);
+  WakeThread();
+
+  m_thread_sync_event.Wait();
+  m_thread_sync_event.Reset();
+}
+
+u32* SPU::AllocateThreadCommand(u32 size)
+{
+  DebugAssert(size < (THREAD_QUEUE_SIZE / 2));
+
+  u32 write_ptr = m_thread_queue_write_ptr.load();
+  for (;;)
+  {
+    // One word is always left free, otherwise a full queue would look empty.
+    const u32 read_ptr = m_thread_queue_read_ptr.load();
+    if (read_ptr > write_ptr)
+    {
+      if ((read_ptr - write_ptr) > size)
+        return &m_thread_queue[write_ptr];
+    }
+    else if ((THREAD_QUEUE_SIZE - write_ptr) > size || ((THREAD_QUEUE_SIZE - write_ptr) == size && read_ptr != 0))
+    {
+      return &m_thread_queue[write_ptr];
+    }
+    else if (read_ptr != 0)
+    {
+      // Commands have to be contiguous, so skip the rest of the queue.
+      m_thread_queue[write_ptr] = static_cast<u32>(ThreadCommand::Wraparound) << 28;
+      m_thread_queue_write_ptr.store(0);
+      write_ptr = 0;
+      continue;
+    }
+
+    // The thread is too far behind, wait for it to catch up.
+    WakeThread();
+    std::this_thread::yield();
+  }
+}
+
+void SPU::PushThreadCommand(u32 size)
+{
+  u32 new_write_ptr = m_thread_queue_write_ptr.load() + size;
+  if (new_write_ptr == THREAD_QUEUE_SIZE)
+    new_write_ptr = 0;
+
+  m_thread_queue_write_ptr.store(new_write_ptr);
+}
+
+void SPU::QueueRegisterWrite(u32 offset, u16 value)
+{
+  u32* cmd = AllocateThreadCommand(1);
+  cmd[0] = (static_cast<u32>(ThreadCommand::WriteRegister) << 28) | (offset << 16) | ZeroExtend32(value);
+  PushThreadCommand(1);
+  m_thread_register_writes_queued++;
+}
+
+void SPU::QueueRAMWrite(u32 address, const u16* values, u32 count)
+{
+  // The halfwords are packed two to a word after the header.
+  DebugAssert(count <= FIFO_SIZE_IN_HALFWORDS);
+  const u32 size = 1 + ((count + 1) / 2);
+  u32* cmd = AllocateThreadCommand(size);
+  cmd[0] = (static_cast<u32>(ThreadCommand::WriteRAM) << 28) | (count << 19) | address;
+  std::memcpy(&cmd[1], values, count * sizeof(u16));
+  PushThreadCommand(size);
+}
+
+void SPU::QueueFrames(u32 frames)
+{
+  while (frames > 0)
+  {
+    const u32 frames_in_command = std::min(frames, THREAD_MAX_FRAMES_PER_COMMAND);
+    u32* cmd = AllocateThreadCommand(1 + frames_in_command);
+    cmd[0] = (static_cast<u32>(ThreadCommand::GenerateFrames) << 28) | (BoolToUInt32(m_audio_output_muted) << 27) |
+             frames_in_command;
+
+    // The CD-ROM fills its audio FIFO on this thread, so the frames are passed along with the command.
+    for (u32 i = 0; i < frames_in_command; i++)
+    {
+      const auto [left, right] = g_cdrom.GetAudioFrame();
+      cmd[1 + i] = ZeroExtend32(static_cast<u16>(left)) | (ZeroExtend32(static_cast<u16>(right)) << 16);
+    }
+
+    PushThreadCommand(1 + frames_in_command);
+    frames -= frames_in_command;
+  }
+
+  WakeThread();
+}
+
+void SPU::RunThreadLoop()
+{
+  for (;;)
+  {
+    const u32 write_ptr = m_thread_queue_write_ptr.load();
+    u32 read_ptr = m_thread_queue_read_ptr.load();
+    if (read_ptr == write_ptr)
+    {
+      std::unique_lock<std::mutex> lock(m_thread_mutex);
+      m_thread_sleeping.store(true);
+      m_wake_thread_cv.wait(lock, [this]() {
+        return m_thread_done.load() || m_thread_queue_read_ptr.load() != m_thread_queue_write_ptr.load();
+      });
+      m_thread_sleeping.store(false);
+
+      if (m_thread_done.load())
+        break;
+      else
+        continue;
+    }
+
+    while (read_ptr != write_ptr)
+    {
+      const u32 header = m_thread_queue[read_ptr];
+      bool sync = false;
+      switch (static_cast<ThreadCommand>(header >> 28))
+      {
+        case ThreadCommand::Wraparound:
+        {
+          read_ptr = THREAD_QUEUE_SIZE;
+        }
+        break;
+
+        case ThreadCommand::GenerateFrames:
+        {
+          const u32 frames = header & 0xFFFFu;
+          GenerateFrames(frames, &m_thread_queue[read_ptr + 1], ConvertToBoolUnchecked((header >> 27) & 1u));
+          read_ptr += 1 + frames;
+        }
+        break;
+
+        case ThreadCommand::WriteRegister:
+        {
+          ApplyRegisterWrite((header >> 16) & 0x3FFu, Truncate16(header));
+          m_thread_register_writes_applied.store(m_thread_register_writes_applied.load() + 1);
+          read_ptr++;
+        }
+        break;
+
+        case ThreadCommand::WriteRAM:
+        {
+          const u32 count = (header >> 19) & 0x3Fu;
+          WriteRAM(header & RAM_MASK, reinterpret_cast<const u16*>(&m_thread_queue[read_ptr + 1]), count);
+          read_ptr += 1 + ((count + 1) / 2);
+        }
+        break;
+
+        case ThreadCommand::Sync:
+        {
+          sync = true;
+          read_ptr++;
+        }
+        break;
+      }
+
+      if (read_ptr == THREAD_QUEUE_SIZE)
+        read_ptr = 0;
+
+      // Frees up space for the CPU thread as soon as each command is done.
+      m_thread_queue_read_ptr.store(read_ptr);
+      if (sync)
+        m_thread_sync_event.Signal();
+    }
+  }
+}
+
 void SPU::Voice::KeyOn()
 {
   current_address = regs.adpcm_start_address & ~u16(1);
@@ -1185,6 +1543,48 @@ void SPU::Voice::TickADSR()
   }
 }
 
+#ifdef SPU_SIMD
+
+/// Sign-extends the 28 nibbles of an ADPCM block to the top of 16-bit values, and applies the block shift.
+/// Writes 32 samples, the last four are garbage.
+ALWAYS_INLINE static void ExpandADPCMNibbles(const void* block, u8 shift, s16* out)
+{
+#if defined(CPU_X64)
+  // Drop the two header bytes, and split the data into low and high nibbles. Low nibbles are the earlier samples.
+  const __m128i data = _mm_srli_si128(_mm_loadu_si128(static_cast<const __m128i*>(block)), 2);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  const __m128i low = _mm_and_si128(data, nibble_mask);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(data, 4), nibble_mask);
+  const __m128i nibbles_0_15 = _mm_unpacklo_epi8(low, high);
+  const __m128i nibbles_16_31 = _mm_unpackhi_epi8(low, high);
+
+  // Placing each nibble in the top of a 16-bit lane sign-extends it, then the shift is arithmetic.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  const auto expand = [&zero, &shift_count](__m128i nibbles) {
+    return _mm_sra_epi16(_mm_unpacklo_epi8(zero, _mm_slli_epi16(nibbles, 4)), shift_count);
+  };
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), expand(nibbles_0_15));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), expand(_mm_srli_si128(nibbles_0_15, 8)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), expand(nibbles_16_31));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 24), expand(_mm_srli_si128(nibbles_16_31, 8)));
+#elif defined(CPU_AARCH64)
+  const uint8x16_t data = vextq_u8(vld1q_u8(static_cast<const u8*>(block)), vdupq_n_u8(0), 2);
+  const uint8x16x2_t nibbles = vzipq_u8(vandq_u8(data, vdupq_n_u8(0x0F)), vshrq_n_u8(data, 4));
+
+  const int16x8_t shift_count = vdupq_n_s16(-static_cast<s16>(shift));
+  const auto expand = [&shift_count](uint8x8_t nibbles) {
+    return vshlq_s16(vreinterpretq_s16_u16(vshlq_n_u16(vmovl_u8(nibbles), 12)), shift_count);
+  };
+  vst1q_s16(out + 0, expand(vget_low_u8(nibbles.val[0])));
+  vst1q_s16(out + 8, expand(vget_high_u8(nibbles.val[0])));
+  vst1q_s16(out + 16, expand(vget_low_u8(nibbles.val[1])));
+  vst1q_s16(out + 24, expand(vget_high_u8(nibbles.val[1])));
+#endif
+}
+
+#endif
+
 void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
 {
   static constexpr std::array<s32, 5> filter_table_pos = {{0, 60, 115, 98, 122}};
@@ -1202,6 +1602,39 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   const s32 filter_neg = filter_table_neg[filter_index];
   s16 last_samples[2] = {adpcm_last_samples[0], adpcm_last_samples[1]};
 
+#ifdef SPU_SIMD
+  if (s_simd_enabled)
+  {
+    // The nibbles can be extended and shifted all at once. The filter depends on the previous output sample, so
+    // only blocks without a filter can be decoded entirely in vector registers.
+    s16* const out = &current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK];
+    std::array<s16, 32> expanded;
+    ExpandADPCMNibbles(&block, shift, expanded.data());
+    if (filter_index == 0)
+    {
+      std::copy_n(expanded.begin(), NUM_SAMPLES_PER_ADPCM_BLOCK, out);
+      adpcm_last_samples[0] = expanded[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+      adpcm_last_samples[1] = expanded[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+      current_block_flags.bits = block.flags.bits;
+      return;
+    }
+
+    for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
+    {
+      s32 sample = s32(expanded[i]);
+      sample += (last_samples[0] * filter_pos) >> 6;
+      sample += (last_samples[1] * filter_neg) >> 6;
+
+      last_samples[1] = last_samples[0];
+      out[i] = last_samples[0] = static_cast<s16>(Clamp16(sample));
+    }
+
+    std::copy(last_samples, last_samples + countof(last_samples), adpcm_last_samples.begin());
+    current_block_flags.bits = block.flags.bits;
+    return;
+  }
+#endif
+
   // samples
   for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
   {
@@ -1218,82 +1651,118 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
-s32 SPU::Voice::Interpolate() const
+static constexpr std::array<s16, 0x200> s_gauss_table = {{
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
+  0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
+  0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
+  0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
+  0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
+  0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
+  0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
+  0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
+  0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
+  0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
+  0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
+  0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
+  0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
+  0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
+  0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
+  0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
+  0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
+  0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
+  0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
+  0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
+  0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
+  0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
+  0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
+  0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
+  0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
+  0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
+  0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
+  0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
+  0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
+  0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
+  0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
+  0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
+  0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
+  0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
+  0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
+  0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
+  0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
+  0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
+  0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
+  0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
+  0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
+  0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
+  0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
+  0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
+  0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
+  0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
+  0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
+  0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
+  0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
+  0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
+  0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
+  0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
+  0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
+  0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
+  0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
+  0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
+  0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
+  0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
+  0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
+  0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
+  0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
+  0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
+}};
+
+#ifdef SPU_SIMD
+using GaussTapsTable = std::array<std::array<s16, 4>, 0x100>;
+
+static constexpr GaussTapsTable ComputeGaussTaps()
 {
-  static constexpr std::array<s16, 0x200> gauss = {{
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
-    0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
-    0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
-    0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
-    0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
-    0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
-    0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
-    0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
-    0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
-    0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
-    0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
-    0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
-    0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
-    0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
-    0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
-    0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
-    0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
-    0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
-    0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
-    0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
-    0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
-    0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
-    0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
-    0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
-    0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
-    0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
-    0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
-    0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
-    0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
-    0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
-    0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
-    0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
-    0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
-    0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
-    0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
-    0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
-    0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
-    0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
-    0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
-    0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
-    0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
-    0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
-    0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
-    0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
-    0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
-    0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
-    0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
-    0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
-    0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
-    0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
-    0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
-    0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
-    0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
-    0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
-    0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
-    0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
-    0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
-    0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
-    0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
-    0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
-    0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
-    0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
-  }};
+  GaussTapsTable taps = {};
+  for (u32 i = 0; i < 0x100; i++)
+  {
+    taps[i][0] = s_gauss_table[0x0FF - i];
+    taps[i][1] = s_gauss_table[0x1FF - i];
+    taps[i][2] = s_gauss_table[0x100 + i];
+    taps[i][3] = s_gauss_table[0x000 + i];
+  }
+
+  return taps;
+}
+
+// The four coefficients for each interpolation index, in the order of the samples they apply to.
+alignas(8) static constexpr GaussTapsTable s_gauss_taps = ComputeGaussTaps();
+#endif
 
+s32 SPU::Voice::Interpolate() const
+{
   const u8 i = counter.interpolation_index;
   const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
 
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
+#ifdef SPU_SIMD
+  if (s_simd_enabled)
+  {
+#if defined(CPU_X64)
+    const __m128i taps = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s_gauss_taps[i].data()));
+    const __m128i samples = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&current_block_samples[s - 3]));
+    const __m128i products = _mm_madd_epi16(taps, samples);
+    return (_mm_cvtsi128_si32(products) + _mm_cvtsi128_si32(_mm_srli_si128(products, 4))) >> 15;
+#elif defined(CPU_AARCH64)
+    const int32x4_t products = vmull_s16(vld1_s16(s_gauss_taps[i].data()), vld1_s16(&current_block_samples[s - 3]));
+    return vaddvq_s32(products) >> 15;
+#endif
+  }
+#endif
+
+  s32 out = s32(s_gauss_table[0x0FF - i]) * s32(current_block_samples[s - 3]);
+  out += s32(s_gauss_table[0x1FF - i]) * s32(current_block_samples[s - 2]);
+  out += s32(s_gauss_table[0x100 + i]) * s32(current_block_samples[s - 1]);
+  out += s32(s_gauss_table[0x000 + i]) * s32(current_block_samples[s - 0]);
   return out >> 15;
 }
 
@@ -1541,6 +2010,14 @@ ALWAYS_INLINE static s32 IIASM(const s16 IIR_ALPHA, const s16 insamp)
 }
 
 void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out)
+{
+  if (s_optimized_reverb_enabled)
+    ProcessReverbOptimized(left_in, right_in, left_out, right_out);
+  else
+    ProcessReverbReference(left_in, right_in, left_out, right_out);
+}
+
+void SPU::ProcessReverbReference(s16 left_in, s16 right_in, s32* left_out, s32* right_out)
 {
   s_last_reverb_input[0] = left_in;
   s_last_reverb_input[1] = right_in;
@@ -1624,8 +2101,231 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
   s_last_reverb_output[1] = *right_out = ApplyVolume(out[1], m_reverb_registers.vROUT);
 }
 
+// The downsampling filter with the skipped taps and middle tap filled in, and the upsampling filter padded to whole
+// vectors, so both can be evaluated as a single dot product.
+using ReverbDownsampleTaps = std::array<s16, 40>;
+using ReverbUpsampleTaps = std::array<s16, 24>;
+
+static constexpr ReverbDownsampleTaps ComputeReverbDownsampleTaps()
+{
+  ReverbDownsampleTaps taps = {};
+  for (u32 i = 0; i < s_reverb_resample_coefficients.size(); i++)
+    taps[i * 2] = s_reverb_resample_coefficients[i];
+  taps[19] = 0x4000;
+  return taps;
+}
+
+static constexpr ReverbUpsampleTaps ComputeReverbUpsampleTaps()
+{
+  ReverbUpsampleTaps taps = {};
+  for (u32 i = 0; i < s_reverb_resample_coefficients.size(); i++)
+    taps[i] = s_reverb_resample_coefficients[i];
+  return taps;
+}
+
+alignas(16) static constexpr ReverbDownsampleTaps s_reverb_downsample_taps = ComputeReverbDownsampleTaps();
+alignas(16) static constexpr ReverbUpsampleTaps s_reverb_upsample_taps = ComputeReverbUpsampleTaps();
+
+template<u32 N>
+ALWAYS_INLINE static s32 ReverbDotProduct(const s16* taps, const s16* src)
+{
+  static_assert((N % 8) == 0, "tap count is a whole number of vectors");
+
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < N; i += 8)
+  {
+    const __m128i t = _mm_load_si128(reinterpret_cast<const __m128i*>(&taps[i]));
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(t, x));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+#elif defined(CPU_AARCH64)
+  int32x4_t sum = vdupq_n_s32(0);
+  for (u32 i = 0; i < N; i += 8)
+  {
+    const int16x8_t t = vld1q_s16(&taps[i]);
+    const int16x8_t x = vld1q_s16(&src[i]);
+    sum = vmlal_s16(sum, vget_low_s16(t), vget_low_s16(x));
+    sum = vmlal_high_s16(sum, t, x);
+  }
+  return vaddvq_s32(sum);
+#else
+  s32 sum = 0;
+  for (u32 i = 0; i < N; i++)
+    sum += s32(taps[i]) * s32(src[i]);
+  return sum;
+#endif
+}
+
+void SPU::UpdateReverbAccessOffsets()
+{
+  static constexpr u32 MASK = (RAM_SIZE - 1) / 2;
+  const ReverbRegisters& rr = m_reverb_registers;
+
+  for (u32 lr = 0; lr < 2; lr++)
+  {
+    u32* offsets = &m_reverb_access_offsets[lr * REVERB_ACCESSES_PER_CHANNEL];
+    const auto set_offset = [offsets](ReverbAccess access, u32 address, s32 offset = 0) {
+      offsets[static_cast<u32>(access)] = ((address << 2) + offset) & MASK;
+    };
+
+    set_offset(ReverbAccess::IIRSourceA, rr.IIR_SRC_A[lr ^ 0]);
+    set_offset(ReverbAccess::IIRSourceB, rr.IIR_SRC_B[lr ^ 1]);
+    set_offset(ReverbAccess::IIRDestAPrevious, rr.IIR_DEST_A[lr], -1);
+    set_offset(ReverbAccess::IIRDestBPrevious, rr.IIR_DEST_B[lr], -1);
+    set_offset(ReverbAccess::IIRDestA, rr.IIR_DEST_A[lr]);
+    set_offset(ReverbAccess::IIRDestB, rr.IIR_DEST_B[lr]);
+    set_offset(ReverbAccess::AccumulatorSourceA, rr.ACC_SRC_A[lr]);
+    set_offset(ReverbAccess::AccumulatorSourceB, rr.ACC_SRC_B[lr]);
+    set_offset(ReverbAccess::AccumulatorSourceC, rr.ACC_SRC_C[lr]);
+    set_offset(ReverbAccess::AccumulatorSourceD, rr.ACC_SRC_D[lr]);
+    set_offset(ReverbAccess::FeedbackSourceA, rr.MIX_DEST_A[lr] - rr.FB_SRC_A);
+    set_offset(ReverbAccess::FeedbackSourceB, rr.MIX_DEST_B[lr] - rr.FB_SRC_B);
+    set_offset(ReverbAccess::MixDestA, rr.MIX_DEST_A[lr]);
+    set_offset(ReverbAccess::MixDestB, rr.MIX_DEST_B[lr]);
+  }
+}
+
+/// Converts the work area offsets to RAM byte addresses for the current position, wrapping around to the base.
+template<u32 MASK>
+ALWAYS_INLINE static void ComputeReverbAddresses(const u32* offsets, u32 current_address, u32 base_address,
+                                                 u32* addresses, u32 count)
+{
+#if defined(CPU_X64)
+  const __m128i current = _mm_set1_epi32(static_cast<s32>(current_address));
+  const __m128i base = _mm_set1_epi32(static_cast<s32>(base_address));
+  const __m128i mask = _mm_set1_epi32(static_cast<s32>(MASK));
+  for (u32 i = 0; i < count; i += 4)
+  {
+    __m128i offset = _mm_add_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(&offsets[i])), current);
+    offset = _mm_add_epi32(offset, _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(offset, 13), 31), base));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&addresses[i]), _mm_slli_epi32(_mm_and_si128(offset, mask), 1));
+  }
+#elif defined(CPU_AARCH64)
+  const uint32x4_t current = vdupq_n_u32(current_address);
+  const uint32x4_t base = vdupq_n_u32(base_address);
+  const uint32x4_t mask = vdupq_n_u32(MASK);
+  for (u32 i = 0; i < count; i += 4)
+  {
+    uint32x4_t offset = vaddq_u32(vld1q_u32(&offsets[i]), current);
+    const uint32x4_t wrap = vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(vshlq_n_u32(offset, 13)), 31));
+    offset = vaddq_u32(offset, vandq_u32(wrap, base));
+    vst1q_u32(&addresses[i], vshlq_n_u32(vandq_u32(offset, mask), 1));
+  }
+#else
+  for (u32 i = 0; i < count; i++)
+  {
+    u32 offset = current_address + offsets[i];
+    offset += base_address & ((s32)(offset << 13) >> 31);
+    addresses[i] = (offset & MASK) * 2u;
+  }
+#endif
+}
+
+void SPU::ProcessReverbOptimized(s16 left_in, s16 right_in, s32* left_out, s32* right_out)
+{
+  s_last_reverb_input[0] = left_in;
+  s_last_reverb_input[1] = right_in;
+  m_reverb_downsample_buffer[0][m_reverb_resample_buffer_position | 0x00] = left_in;
+  m_reverb_downsample_buffer[0][m_reverb_resample_buffer_position | 0x40] = left_in;
+  m_reverb_downsample_buffer[1][m_reverb_resample_buffer_position | 0x00] = right_in;
+  m_reverb_downsample_buffer[1][m_reverb_resample_buffer_position | 0x40] = right_in;
+
+  s32 out[2];
+  if (m_reverb_resample_buffer_position & 1u)
+  {
+    const ReverbRegisters& rr = m_reverb_registers;
+
+    // Both channels' addresses are computed at once, instead of per access.
+    alignas(16) std::array<u32, REVERB_ACCESSES_PER_CHANNEL * 2> addresses;
+    ComputeReverbAddresses<(RAM_SIZE - 1) / 2>(m_reverb_access_offsets.data(), m_reverb_current_address,
+                                               m_reverb_base_address, addresses.data(),
+                                               static_cast<u32>(addresses.size()));
+
+    for (unsigned lr = 0; lr < 2; lr++)
+    {
+      const u32* channel_addresses = &addresses[lr * REVERB_ACCESSES_PER_CHANNEL];
+      const auto read = [this, channel_addresses](ReverbAccess access) {
+        s16 data;
+        std::memcpy(&data, &m_ram[channel_addresses[static_cast<u32>(access)]], sizeof(data));
+        return data;
+      };
+      const auto write = [this, channel_addresses](ReverbAccess access, s16 data) {
+        std::memcpy(&m_ram[channel_addresses[static_cast<u32>(access)]], &data, sizeof(data));
+      };
+
+      const s16* src = &m_reverb_downsample_buffer[lr][(m_reverb_resample_buffer_position - 38) & 0x3F];
+      const s32 downsampled = std::clamp<s32>(
+        ReverbDotProduct<s_reverb_downsample_taps.size()>(s_reverb_downsample_taps.data(), src) >> 15, -32768, 32767);
+
+      if (m_SPUCNT.reverb_master_enable)
+      {
+        const s32 input = (downsampled * rr.IN_COEF[lr]) >> 14;
+        const s16 IIR_INPUT_A = ReverbSat((((read(ReverbAccess::IIRSourceA) * rr.IIR_COEF) >> 14) + input) >> 1);
+        const s16 IIR_INPUT_B = ReverbSat((((read(ReverbAccess::IIRSourceB) * rr.IIR_COEF) >> 14) + input) >> 1);
+        const s16 IIR_A = ReverbSat((((IIR_INPUT_A * rr.IIR_ALPHA) >> 14) +
+                                     (IIASM(rr.IIR_ALPHA, read(ReverbAccess::IIRDestAPrevious)) >> 14)) >>
+                                    1);
+        const s16 IIR_B = ReverbSat((((IIR_INPUT_B * rr.IIR_ALPHA) >> 14) +
+                                     (IIASM(rr.IIR_ALPHA, read(ReverbAccess::IIRDestBPrevious)) >> 14)) >>
+                                    1);
+
+        write(ReverbAccess::IIRDestA, IIR_A);
+        write(ReverbAccess::IIRDestB, IIR_B);
+      }
+
+      const s32 ACC = ((read(ReverbAccess::AccumulatorSourceA) * rr.ACC_COEF_A) >> 14) +
+                      ((read(ReverbAccess::AccumulatorSourceB) * rr.ACC_COEF_B) >> 14) +
+                      ((read(ReverbAccess::AccumulatorSourceC) * rr.ACC_COEF_C) >> 14) +
+                      ((read(ReverbAccess::AccumulatorSourceD) * rr.ACC_COEF_D) >> 14);
+
+      const s16 FB_A = read(ReverbAccess::FeedbackSourceA);
+      const s16 FB_B = read(ReverbAccess::FeedbackSourceB);
+      const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(rr.FB_ALPHA)) >> 14)) >> 1);
+      const s16 MDB =
+        ReverbSat(FB_A + ((((MDA * rr.FB_ALPHA) >> 14) + ((FB_B * ReverbNeg(rr.FB_X)) >> 14)) >> 1));
+      const s16 IVB = ReverbSat(FB_B + ((MDB * rr.FB_X) >> 15));
+
+      if (m_SPUCNT.reverb_master_enable)
+      {
+        write(ReverbAccess::MixDestA, MDA);
+        write(ReverbAccess::MixDestB, MDB);
+      }
+
+      m_reverb_upsample_buffer[lr][(m_reverb_resample_buffer_position >> 1) | 0x20] =
+        m_reverb_upsample_buffer[lr][m_reverb_resample_buffer_position >> 1] = IVB;
+    }
+
+    m_reverb_current_address = (m_reverb_current_address + 1) & 0x3FFFFu;
+    if (m_reverb_current_address == 0)
+      m_reverb_current_address = m_reverb_base_address;
+
+    for (unsigned lr = 0; lr < 2; lr++)
+    {
+      const s16* src = &m_reverb_upsample_buffer[lr][((m_reverb_resample_buffer_position >> 1) - 19) & 0x1F];
+      out[lr] = std::clamp<s32>(
+        ReverbDotProduct<s_reverb_upsample_taps.size()>(s_reverb_upsample_taps.data(), src) >> 14, -32768, 32767);
+    }
+  }
+  else
+  {
+    for (unsigned lr = 0; lr < 2; lr++)
+      out[lr] = m_reverb_upsample_buffer[lr][(((m_reverb_resample_buffer_position >> 1) - 19) & 0x1F) + 9];
+  }
+
+  m_reverb_resample_buffer_position = (m_reverb_resample_buffer_position + 1) & 0x3F;
+
+  s_last_reverb_output[0] = *left_out = ApplyVolume(out[0], m_reverb_registers.vLOUT);
+  s_last_reverb_output[1] = *right_out = ApplyVolume(out[1], m_reverb_registers.vROUT);
+}
+
 void SPU::Execute(TickCount ticks)
 {
+  FrameProfiler::Scope profiler_scope(FrameProfiler::Component::SPU);
+
   u32 remaining_frames;
   if (g_settings.cpu_overclock_active)
   {
@@ -1640,12 +2340,32 @@ void SPU::Execute(TickCount ticks)
     m_ticks_carry = (ticks + m_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
+  if (IsMixingOnThread())
+    QueueFrames(remaining_frames);
+  else
+    GenerateFrames(remaining_frames, nullptr, m_audio_output_muted);
+
+  // Predict the next IRQ from where the voices have got to.
+  if (m_SPUCNT.enable && m_SPUCNT.irq9_enable)
+    ScheduleTickEvent(GetFramesUntilRAMIRQ());
+}
+
+void SPU::GenerateFrames(u32 remaining_frames, const u32* cd_audio_frames, bool muted)
+{
   while (remaining_frames > 0)
   {
     AudioStream* const output_stream = g_host_interface->GetAudioStream();
     s16* output_frame_start;
     u32 output_frame_space = remaining_frames;
-    output_stream->BeginWrite(&output_frame_start, &output_frame_space);
+    if (muted)
+    {
+      output_frame_start = m_muted_output_buffer.data();
+      output_frame_space = MUTED_OUTPUT_BUFFER_FRAMES;
+    }
+    else
+    {
+      output_stream->BeginWrite(&output_frame_start, &output_frame_space);
+    }
 
     s16* output_frame = output_frame_start;
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
@@ -1697,7 +2417,18 @@ void SPU::Execute(TickCount ticks)
       UpdateNoise();
 
       // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = g_cdrom.GetAudioFrame();
+      s16 cd_audio_left, cd_audio_right;
+      if (cd_audio_frames)
+      {
+        const u32 cd_audio_frame = *(cd_audio_frames++);
+        cd_audio_left = static_cast<s16>(cd_audio_frame);
+        cd_audio_right = static_cast<s16>(cd_audio_frame >> 16);
+      }
+      else
+      {
+        std::tie(cd_audio_left, cd_audio_right) = g_cdrom.GetAudioFrame();
+      }
+
       if (m_SPUCNT.cd_audio_enable)
       {
         const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), m_cd_audio_volume_left);
@@ -1736,10 +2467,14 @@ void SPU::Execute(TickCount ticks)
       IncrementCaptureBufferPosition();
     }
 
-    if (m_dump_writer)
-      m_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+    if (!muted)
+    {
+      if (m_dump_writer)
+        m_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+
+      output_stream->EndWrite(frames_in_this_batch);
+    }
 
-    output_stream->EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
   }
 }
@@ -1751,14 +2486,31 @@ void SPU::UpdateEventInterval()
   // the SPU state.
   const u32 max_slice_frames = g_host_interface->GetAudioStream()->GetBufferSize();
 
-  // TODO: Make this predict how long until the interrupt will be hit instead...
-  const u32 interval = (m_SPUCNT.enable && m_SPUCNT.irq9_enable) ? 1 : max_slice_frames;
-  const TickCount interval_ticks = static_cast<TickCount>(interval) * m_cpu_ticks_per_spu_tick;
+  if (m_SPUCNT.enable && m_SPUCNT.irq9_enable)
+  {
+    // Catching up predicts the next IRQ from the current voice positions.
+    if (m_tick_event->IsActive())
+      m_tick_event->InvokeEarly(true);
+    else
+      ScheduleTickEvent(GetFramesUntilRAMIRQ());
+
+    return;
+  }
+
+  // Feed the thread in smaller slices, so it isn't left idle while the CPU runs ahead.
+  const u32 slice_frames = IsMixingOnThread() ? std::min(max_slice_frames, THREAD_SLICE_FRAMES) : max_slice_frames;
+  const TickCount interval_ticks = static_cast<TickCount>(slice_frames) * m_cpu_ticks_per_spu_tick;
   if (m_tick_event->IsActive() && m_tick_event->GetInterval() == interval_ticks)
     return;
 
   // Ensure all pending ticks have been executed, since we won't get them back after rescheduling.
   m_tick_event->InvokeEarly(true);
+  ScheduleTickEvent(slice_frames);
+}
+
+void SPU::ScheduleTickEvent(u32 frames)
+{
+  const TickCount interval_ticks = static_cast<TickCount>(frames) * m_cpu_ticks_per_spu_tick;
   m_tick_event->SetInterval(interval_ticks);
 
   TickCount downcount = interval_ticks;
@@ -1768,6 +2520,79 @@ void SPU::UpdateEventInterval()
   m_tick_event->Schedule(downcount);
 }
 
+u32 SPU::GetFramesUntilRAMIRQ() const
+{
+  // Key on resets the voice position after the next frame is sampled, so check again after that.
+  if (m_key_on_register != 0)
+    return 1;
+
+  const u16 irq_address = m_irq_address;
+  u32 frames = std::min(g_host_interface->GetAudioStream()->GetBufferSize(), MAX_RAM_IRQ_PREDICTION_FRAMES);
+
+  // The capture buffers are written every frame, at the same position in each of the four channels.
+  const u32 irq_ram_address = ZeroExtend32(irq_address) * 8;
+  if (irq_ram_address < (CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4))
+  {
+    const u32 distance = (irq_ram_address - ZeroExtend32(m_capture_buffer_position)) % CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+    frames = std::min<u32>(frames, distance / sizeof(s16) + 1);
+  }
+
+  // Voices are sampled even when off while the IRQ is enabled. Walk the blocks each voice will fetch, following the
+  // loop flags, and find the first frame where one of them covers the IRQ address.
+  static constexpr u32 BLOCK_END_POSITION = NUM_SAMPLES_PER_ADPCM_BLOCK << 12;
+  const u32 reverb_work_area_start = m_SPUCNT.reverb_master_enable ? (m_reverb_base_address * 2) : RAM_SIZE;
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    const Voice& voice = m_voices[i];
+
+    // Pitch modulation depends on the previous voice's output, so assume the fastest step to stay conservative.
+    const u32 step = IsPitchModulationEnabled(i) ? 0x3FFFu : std::min<u32>(voice.regs.adpcm_sample_rate, 0x3FFFu);
+
+    u16 address = voice.current_address;
+    u16 repeat_address = voice.regs.adpcm_repeat_address;
+    ADPCMFlags flags = voice.current_block_flags;
+    u32 position = voice.counter.bits;
+    bool fetch_pending = !voice.has_samples;
+    u32 frame = 1;
+    while (frame < frames)
+    {
+      if (fetch_pending)
+      {
+        // Fetching a block checks both halves of it against the IRQ address.
+        if (address == irq_address || static_cast<u16>(address + 1) == irq_address)
+        {
+          frames = frame;
+          break;
+        }
+
+        // The capture buffers and reverb can overwrite the block before it's fetched, so the flags aren't known yet.
+        const u32 flags_address = (ZeroExtend32(address) * 8 + 1) & RAM_MASK;
+        if (frame > 1 &&
+            (flags_address < (CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4) || flags_address >= reverb_work_area_start))
+        {
+          frames = frame;
+          break;
+        }
+
+        flags.bits = m_ram[flags_address];
+        if (flags.loop_start && !voice.ignore_loop_address)
+          repeat_address = address;
+      }
+
+      if (step == 0)
+        break;
+
+      const u32 frames_in_block = (BLOCK_END_POSITION - position + step - 1) / step;
+      position = position + frames_in_block * step - BLOCK_END_POSITION;
+      frame += frames_in_block;
+      address = flags.loop_end ? (repeat_address & ~u16(1)) : static_cast<u16>(address + 2);
+      fetch_pending = true;
+    }
+  }
+
+  return frames;
+}
+
 void SPU::DrawDebugStateWindow()
 {
 #ifdef WITH_IMGUI
@@ -1782,6 +2607,8 @@ void SPU::DrawDebugStateWindow()
     return;
   }
 
+  Sync();
+
   // status
   if (ImGui::CollapsingHeader("Status", ImGuiTreeNodeFlags_DefaultOpen))
   {
@@ -1814,7 +2641,9 @@ void SPU::DrawDebugStateWindow()
     ImGui::SameLine(offsets[4]);
     ImGui::TextColored(m_SPUSTAT.transfer_busy ? active_color : inactive_color, "Transfer Busy");
     ImGui::SameLine(offsets[5]);
-    ImGui::TextColored(m_SPUSTAT.second_half_capture_buffer ? active_color : inactive_color, "Second Capture Buffer");
+    ImGui::TextColored((m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2)) ? active_color :
+                                                                                             inactive_color,
+                       "Second Capture Buffer");
 
     ImGui::Text("Interrupt: ");
     ImGui::SameLine(offsets[0]);
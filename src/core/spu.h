@@ -1,10 +1,15 @@
 #pragma once
 #include "common/bitfield.h"
+#include "common/event.h"
 #include "common/fifo_queue.h"
 #include "system.h"
 #include "types.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 class StateWrapper;
 
@@ -14,6 +19,11 @@ class WAVWriter;
 
 class TimingEvent;
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // warning C4324: 'SPU': structure was padded due to alignment specifier
+#endif
+
 class SPU
 {
 public:
@@ -47,6 +57,27 @@ public:
   /// Stops dumping audio to file, if started.
   bool StopDumpingAudio();
 
+  /// Discards generated samples instead of sending them to the host, used for hidden runahead frames.
+  ALWAYS_INLINE bool IsAudioOutputMuted() const { return m_audio_output_muted; }
+  ALWAYS_INLINE void SetAudioOutputMuted(bool muted) { m_audio_output_muted = muted; }
+
+  /// Switches between the vectorized and scalar ADPCM decoding and interpolation paths, for testing.
+  static void SetSIMDEnabled(bool enabled);
+
+  /// Switches between the optimized and reference reverb implementations, for testing.
+  static void SetOptimizedReverbEnabled(bool enabled);
+
+  /// Moves voice mixing to a separate thread. Register writes are queued behind the frames generated before them,
+  /// and anything which reads SPU state waits for the thread to catch up first.
+  void SetUseThread(bool enabled);
+
+  /// Waits for the mixing thread to process everything queued so far.
+  ALWAYS_INLINE void Sync()
+  {
+    if (m_use_thread && m_thread_queue_read_ptr.load() != m_thread_queue_write_ptr.load())
+      SyncThread();
+  }
+
 private:
   static constexpr u32 RAM_SIZE = 512 * 1024;
   static constexpr u32 RAM_MASK = RAM_SIZE - 1;
@@ -65,6 +96,41 @@ private:
   static constexpr u32 NUM_REVERB_REGS = 32;
   static constexpr u32 FIFO_SIZE_IN_HALFWORDS = 32;
   static constexpr TickCount TRANSFER_TICKS_PER_HALFWORD = 32;
+  static constexpr u32 MUTED_OUTPUT_BUFFER_FRAMES = 512;
+  static constexpr u32 MAX_RAM_IRQ_PREDICTION_FRAMES = 256; // bounds the block walk when predicting IRQs
+  static constexpr u32 THREAD_QUEUE_SIZE = 4096;             // in words, bounds how far the thread can fall behind
+  static constexpr u32 THREAD_MAX_FRAMES_PER_COMMAND = THREAD_QUEUE_SIZE / 4;
+  static constexpr u32 THREAD_SLICE_FRAMES = 128;
+  static constexpr u32 REVERB_ACCESSES_PER_CHANNEL = 16; // padded from 14 so each channel fills whole vectors
+
+  enum class ThreadCommand : u8
+  {
+    Wraparound = 0,
+    GenerateFrames = 1,
+    WriteRegister = 2,
+    Sync = 3,
+    WriteRAM = 4
+  };
+
+  /// Work area accesses made by each channel per reverb sample pair, indexing the address tables.
+  enum class ReverbAccess : u8
+  {
+    IIRSourceA,
+    IIRSourceB,
+    IIRDestAPrevious,
+    IIRDestBPrevious,
+    IIRDestA,
+    IIRDestB,
+    AccumulatorSourceA,
+    AccumulatorSourceB,
+    AccumulatorSourceC,
+    AccumulatorSourceD,
+    FeedbackSourceA,
+    FeedbackSourceB,
+    MixDestA,
+    MixDestB,
+    Count
+  };
 
   enum class RAMTransferMode : u8
   {
@@ -331,8 +397,25 @@ private:
   }
   ALWAYS_INLINE s16 GetVoiceNoiseLevel() const { return static_cast<s16>(static_cast<u16>(m_noise_level)); }
 
+  ALWAYS_INLINE bool IsMixingOnThread() const { return m_use_thread && !m_SPUCNT.irq9_enable; }
+
+  /// Generates any frames which are pending on the CPU side, and waits for the thread to mix them.
+  void CatchUpVoices();
+
+  /// Waits for the thread only while register writes are still queued. Enough for reading registers which mixing
+  /// doesn't change itself.
+  ALWAYS_INLINE void SyncRegisterWrites()
+  {
+    if (m_use_thread && m_thread_register_writes_applied.load() != m_thread_register_writes_queued)
+      SyncThread();
+  }
+
+  /// Applies a write to a register which affects mixing, without syncing the voices first.
+  void ApplyRegisterWrite(u32 offset, u16 value);
+
   u16 ReadVoiceRegister(u32 offset);
   void WriteVoiceRegister(u32 offset, u16 value);
+  void ApplyVoiceRegisterWrite(u32 offset, u16 value);
 
   void CheckRAMIRQ(u32 address);
   void WriteToCaptureBuffer(u32 index, s16 value);
@@ -347,21 +430,50 @@ private:
   s16 ReverbRead(u32 address, s32 offset = 0);
   void ReverbWrite(u32 address, s16 data);
   void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
+  void ProcessReverbReference(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
+
+  /// Recomputes the work area offsets of each reverb access, after the reverb registers change.
+  void UpdateReverbAccessOffsets();
+
+  /// Same as the reference implementation, but with the work area addresses computed up front, and vectorized
+  /// resampling filters.
+  void ProcessReverbOptimized(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
   void Execute(TickCount ticks);
+
+  /// Mixes frames, sending them to the host. The CD audio frames are pulled from the CD-ROM if not provided.
+  void GenerateFrames(u32 frames, const u32* cd_audio_frames, bool muted);
   void UpdateEventInterval();
+  void ScheduleTickEvent(u32 frames);
+
+  /// Returns the number of frames which can be generated before a RAM IRQ could be raised. Never too late, but can be
+  /// early, in which case the prediction is repeated.
+  u32 GetFramesUntilRAMIRQ() const;
 
   void ExecuteTransfer(TickCount ticks);
   void ManualTransferWrite(u16 value);
   void UpdateTransferEvent();
   void UpdateDMARequest();
 
+  void StartThread();
+  void StopThread();
+  void WakeThread();
+  void SyncThread();
+  void RunThreadLoop();
+  u32* AllocateThreadCommand(u32 size);
+  void PushThreadCommand(u32 size);
+  void QueueRegisterWrite(u32 offset, u16 value);
+  void QueueRAMWrite(u32 address, const u16* values, u32 count);
+  void WriteRAM(u32 address, const u16* values, u32 count);
+  void QueueFrames(u32 frames);
+
   std::unique_ptr<TimingEvent> m_tick_event;
   std::unique_ptr<TimingEvent> m_transfer_event;
   std::unique_ptr<Common::WAVWriter> m_dump_writer;
   TickCount m_ticks_carry = 0;
   TickCount m_cpu_ticks_per_spu_tick = 0;
   TickCount m_cpu_tick_divider = 0;
+  bool m_audio_output_muted = false;
 
   SPUCNT m_SPUCNT = {};
   SPUSTAT m_SPUSTAT = {};
@@ -400,12 +512,33 @@ private:
   std::array<std::array<s16, 128>, 2> m_reverb_downsample_buffer;
   std::array<std::array<s16, 64>, 2> m_reverb_upsample_buffer;
   s32 m_reverb_resample_buffer_position = 0;
+  alignas(16) std::array<u32, REVERB_ACCESSES_PER_CHANNEL * 2> m_reverb_access_offsets{};
 
   std::array<Voice, NUM_VOICES> m_voices{};
 
   InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> m_transfer_fifo;
 
+  std::array<s16, MUTED_OUTPUT_BUFFER_FRAMES * 2> m_muted_output_buffer;
+
   std::array<u8, RAM_SIZE> m_ram{};
+
+  // Commands are a header word, followed by the CD audio frames for generate commands.
+  std::array<u32, THREAD_QUEUE_SIZE> m_thread_queue;
+  alignas(64) std::atomic<u32> m_thread_queue_read_ptr{0};
+  alignas(64) std::atomic<u32> m_thread_queue_write_ptr{0};
+  std::atomic_bool m_thread_sleeping{false};
+  std::atomic_bool m_thread_done{false};
+  std::atomic<u32> m_thread_register_writes_applied{0};
+  u32 m_thread_register_writes_queued = 0;
+  std::thread m_thread;
+  std::mutex m_thread_mutex;
+  std::condition_variable m_wake_thread_cv;
+  Common::Event m_thread_sync_event;
+  bool m_use_thread = false;
 };
 
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
 extern SPU g_spu;
\ No newline at end of file
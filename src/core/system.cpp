@@ -12,8 +12,10 @@
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
+#include "dirty_page_tracker.h"
 #include "dma.h"
 #include "gpu.h"
+#include "gpu_dump.h"
 #include "gte.h"
 #include "host_display.h"
 #include "host_interface.h"
@@ -27,10 +29,21 @@
 #include "sio.h"
 #include "spu.h"
 #include "timers.h"
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cinttypes>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
 Log_SetChannel(System);
 
 #ifdef WIN32
@@ -47,6 +60,286 @@ SystemBootParameters::SystemBootParameters(std::string filename_) : filename(std
 
 SystemBootParameters::~SystemBootParameters() = default;
 
+SaveStateBuffer::SaveStateBuffer() = default;
+
+SaveStateBuffer::SaveStateBuffer(SaveStateBuffer&& other) = default;
+
+SaveStateBuffer::~SaveStateBuffer() = default;
+
+SaveStateBuffer& SaveStateBuffer::operator=(SaveStateBuffer&& other) = default;
+
+namespace {
+
+/// Runs the chunks of a save state (de)compression job across persistent worker threads, so saving and loading don't
+/// create and join a set of threads each time. One job runs at a time, as saves can come from both the emulation thread
+/// and the background save thread.
+class StateChunkWorkers
+{
+public:
+  StateChunkWorkers()
+  {
+    const u32 thread_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    for (u32 i = 0; i < thread_count; i++)
+      m_threads.emplace_back(&StateChunkWorkers::WorkerThread, this);
+  }
+
+  ~StateChunkWorkers()
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_shutdown = true;
+      m_work_cv.notify_all();
+    }
+
+    for (std::thread& thread : m_threads)
+      thread.join();
+  }
+
+  void ForEachChunk(u32 chunk_count, const std::function<void(u32)>& func)
+  {
+    std::unique_lock<std::mutex> job_lock(m_job_mutex);
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_func = &func;
+      m_chunk_count = chunk_count;
+      m_next_chunk.store(0);
+      m_job_id++;
+      m_work_cv.notify_all();
+    }
+
+    RunChunks();
+
+    // Once we run out of chunks they've all been claimed, so we only need to wait for the ones in progress.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [this]() { return m_active_workers == 0; });
+    m_func = nullptr;
+  }
+
+private:
+  void WorkerThread()
+  {
+    u64 last_job_id = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+      m_work_cv.wait(lock, [this, &last_job_id]() { return m_shutdown || m_job_id != last_job_id; });
+      if (m_shutdown)
+        return;
+
+      // Skip jobs which were already finished by the time we woke up.
+      last_job_id = m_job_id;
+      if (m_next_chunk.load() >= m_chunk_count)
+        continue;
+
+      m_active_workers++;
+      lock.unlock();
+      RunChunks();
+      lock.lock();
+      if (--m_active_workers == 0)
+        m_done_cv.notify_one();
+    }
+  }
+
+  void RunChunks()
+  {
+    for (u32 chunk = m_next_chunk++; chunk < m_chunk_count; chunk = m_next_chunk++)
+      (*m_func)(chunk);
+  }
+
+  std::mutex m_job_mutex;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::vector<std::thread> m_threads;
+  const std::function<void(u32)>* m_func = nullptr;
+  u32 m_chunk_count = 0;
+  std::atomic<u32> m_next_chunk{0};
+  u32 m_active_workers = 0;
+  u64 m_job_id = 0;
+  bool m_shutdown = false;
+};
+
+/// Reads compressed save state data from a file, inflating each chunk directly into the buffers the state is being read
+/// into. The compressed data is read through a small buffer. States which are already in memory are decompressed in
+/// parallel by DecompressStateData() instead.
+class StateDataDecompressStream final : public ByteStream
+{
+public:
+  StateDataDecompressStream(ByteStream* source, u32 uncompressed_size)
+    : m_source(source), m_size(uncompressed_size),
+      m_chunk_count((uncompressed_size + SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE - 1) /
+                    SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE)
+  {
+  }
+
+  ~StateDataDecompressStream() override
+  {
+    if (m_zstream_initialized)
+      inflateEnd(&m_zstream);
+  }
+
+  /// Reads the chunk table, and prepares to read the first chunk.
+  bool Open(u32 compressed_size)
+  {
+    u32 chunk_count;
+    if (compressed_size < sizeof(chunk_count) || !m_source->Read2(&chunk_count, sizeof(chunk_count)) ||
+        chunk_count != m_chunk_count || (sizeof(u32) * (chunk_count + 1)) > compressed_size)
+    {
+      return false;
+    }
+
+    m_chunk_sizes.resize(chunk_count);
+    if (chunk_count > 0 && !m_source->Read2(m_chunk_sizes.data(), sizeof(u32) * chunk_count))
+      return false;
+
+    u32 chunk_data_remaining = compressed_size - sizeof(u32) * (chunk_count + 1);
+    for (const u32 chunk_size : m_chunk_sizes)
+    {
+      if (chunk_size > chunk_data_remaining)
+        return false;
+
+      chunk_data_remaining -= chunk_size;
+    }
+
+    m_input_buffer.resize(INPUT_BUFFER_SIZE);
+
+    m_zstream = {};
+    if (inflateInit(&m_zstream) != Z_OK)
+      return false;
+
+    m_zstream_initialized = true;
+    return true;
+  }
+
+  bool ReadByte(u8* pDestByte) override { return Read2(pDestByte, sizeof(u8)); }
+
+  u32 Read(void* pDestination, u32 ByteCount) override
+  {
+    u8* destination = static_cast<u8*>(pDestination);
+    u32 remaining = ByteCount;
+    while (remaining > 0 && !m_errorState)
+    {
+      if ((m_chunk_output_remaining == 0 && !StartNextChunk()) || (m_zstream.avail_in == 0 && !RefillInput()))
+      {
+        SetErrorState();
+        break;
+      }
+
+      const u32 size = std::min(remaining, m_chunk_output_remaining);
+      m_zstream.next_out = destination;
+      m_zstream.avail_out = size;
+      const int err = inflate(&m_zstream, Z_NO_FLUSH);
+      const u32 bytes_inflated = size - m_zstream.avail_out;
+      destination += bytes_inflated;
+      remaining -= bytes_inflated;
+      m_position += bytes_inflated;
+      m_chunk_output_remaining -= bytes_inflated;
+
+      if (err == Z_STREAM_END)
+      {
+        // Chunks have to end exactly where the table says they do.
+        if (m_chunk_output_remaining > 0 || !IsChunkInputConsumed())
+          SetErrorState();
+      }
+      else if (err != Z_OK || (m_chunk_output_remaining == 0 && !FinishChunk()))
+      {
+        SetErrorState();
+      }
+    }
+
+    return ByteCount - remaining;
+  }
+
+  bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead = nullptr) override
+  {
+    const u32 bytes_read = Read(pDestination, ByteCount);
+    if (pNumberOfBytesRead)
+      *pNumberOfBytesRead = bytes_read;
+
+    return (bytes_read == ByteCount);
+  }
+
+  bool WriteByte(u8 SourceByte) override { return false; }
+  u32 Write(const void* pSource, u32 ByteCount) override { return 0; }
+  bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten = nullptr) override { return false; }
+  bool SeekAbsolute(u64 Offset) override { return false; }
+  bool SeekRelative(s64 Offset) override { return false; }
+  bool SeekToEnd() override { return false; }
+  u64 GetPosition() const override { return m_position; }
+  u64 GetSize() const override { return m_size; }
+  bool Flush() override { return true; }
+  bool Discard() override { return true; }
+  bool Commit() override { return true; }
+
+private:
+  static constexpr u32 INPUT_BUFFER_SIZE = 64 * 1024;
+
+  bool StartNextChunk()
+  {
+    if (m_current_chunk == m_chunk_count || inflateReset(&m_zstream) != Z_OK)
+      return false;
+
+    const u32 chunk_size = m_chunk_sizes[m_current_chunk];
+    m_chunk_output_remaining = std::min(m_size - (m_current_chunk * SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE),
+                                        static_cast<u32>(SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE));
+    m_current_chunk++;
+
+    m_zstream.avail_in = 0;
+    m_chunk_input_remaining = chunk_size;
+    return true;
+  }
+
+  bool RefillInput()
+  {
+    const u32 size = std::min(m_chunk_input_remaining, INPUT_BUFFER_SIZE);
+    if (size == 0 || !m_source->Read2(m_input_buffer.data(), size))
+      return false;
+
+    m_zstream.next_in = m_input_buffer.data();
+    m_zstream.avail_in = size;
+    m_chunk_input_remaining -= size;
+    return true;
+  }
+
+  bool IsChunkInputConsumed() const { return (m_zstream.avail_in == 0 && m_chunk_input_remaining == 0); }
+
+  /// All of the chunk's data has been read, consumes the rest of the deflate stream so the checksum is verified.
+  bool FinishChunk()
+  {
+    for (;;)
+    {
+      if (m_zstream.avail_in == 0 && !RefillInput())
+        return false;
+
+      u8 extra_byte;
+      m_zstream.next_out = &extra_byte;
+      m_zstream.avail_out = sizeof(extra_byte);
+      const int err = inflate(&m_zstream, Z_NO_FLUSH);
+      if (m_zstream.avail_out == 0 || (err != Z_OK && err != Z_STREAM_END))
+        return false;
+      else if (err == Z_STREAM_END)
+        return IsChunkInputConsumed();
+    }
+  }
+
+  ByteStream* m_source;
+  u32 m_size;
+  u32 m_chunk_count;
+  u32 m_position = 0;
+
+  std::vector<u32> m_chunk_sizes;
+  u32 m_current_chunk = 0;
+  u32 m_chunk_output_remaining = 0;
+  u32 m_chunk_input_remaining = 0;
+
+  std::vector<u8> m_input_buffer;
+
+  z_stream m_zstream = {};
+  bool m_zstream_initialized = false;
+};
+
+} // namespace
+
 namespace System {
 
 static bool LoadEXE(const char* filename);
@@ -58,13 +351,24 @@ static bool SetExpansionROM(const char* filename);
 static std::unique_ptr<CDImage> OpenCDImage(const char* path, bool force_preload);
 
 static bool DoLoadState(ByteStream* stream, bool force_software_renderer, bool update_display);
-static bool DoState(StateWrapper& sw, bool update_display);
+static void ForEachStateChunk(u32 chunk_count, const std::function<void(u32)>& func);
+static bool CompressStateData(const u8* data, u32 size, ByteStream* stream);
+static bool DecompressStateData(const u8* compressed_data, u32 compressed_size, u8* data, u32 size);
+static bool DoState(StateWrapper& sw, bool update_display, bool is_memory_state);
 static bool CreateGPU(GPURenderer renderer);
 
 static bool Initialize(bool force_software_renderer);
+static bool BootGPUDump(const char* filename);
 
 static void UpdateRunningGame(const char* path, CDImage* image);
 
+static bool SaveMemoryState(GrowableMemoryByteStream* stream, DirtyPageTracker* page_tracker = nullptr);
+static bool LoadMemoryState(ByteStream* stream, bool update_display, DirtyPageTracker* page_tracker = nullptr);
+static void SaveRewindState();
+static void DoRewind();
+static void DoRunFrame();
+static void DoRunahead();
+
 static State s_state = State::Shutdown;
 
 static ConsoleRegion s_region = ConsoleRegion::NTSC_U;
@@ -75,6 +379,7 @@ static u32 s_internal_frame_number = 1;
 
 static std::string s_running_game_path;
 static std::string s_running_game_code;
+static std::string s_block_profile_path;
 static std::string s_running_game_title;
 
 static float s_throttle_frequency = 60.0f;
@@ -104,6 +409,38 @@ static std::string s_media_playlist_filename;
 
 static std::unique_ptr<CheatList> s_cheat_list;
 
+// Replaces the CPU when playing back a GPU dump.
+static std::unique_ptr<GPUDump::Player> s_gpu_dump_player;
+
+// Rewind ring. Each entry is run-length encoded. Deltas are incremental states which only contain the memory pages
+// that differ from their keyframe, XORed against it, and can only be loaded while that keyframe is the page tracker's
+// base.
+struct RewindState
+{
+  std::vector<u8> data;
+  u32 uncompressed_size;
+  u32 keyframe_id;
+  bool keyframe;
+};
+static constexpr u32 REWIND_KEYFRAME_INTERVAL = 16;
+static constexpr s32 REWIND_PLAYBACK_SPEED = 4;
+static std::deque<RewindState> s_rewind_states;
+static std::unique_ptr<GrowableMemoryByteStream> s_rewind_stream;
+static DirtyPageTracker s_rewind_page_tracker;
+static u32 s_rewind_page_tracker_keyframe_id = 0;
+static u32 s_rewind_next_keyframe_id = 1;
+static u64 s_rewind_memory_usage = 0;
+static u32 s_rewind_states_since_keyframe = 0;
+static s32 s_rewind_save_frequency = -1;
+static s32 s_rewind_save_counter = -1;
+static s32 s_rewind_load_frequency = -1;
+static s32 s_rewind_load_counter = -1;
+static bool s_rewinding = false;
+
+static std::unique_ptr<GrowableMemoryByteStream> s_runahead_stream;
+
+static std::unique_ptr<StateChunkWorkers> s_state_chunk_workers;
+
 State GetState()
 {
   return s_state;
@@ -236,6 +573,12 @@ bool IsPsfFileName(const char* path)
   return (extension && StringUtil::Strcasecmp(extension, ".psf") == 0);
 }
 
+bool IsGPUDumpFileName(const char* path)
+{
+  const char* extension = std::strrchr(path, '.');
+  return (extension && StringUtil::Strcasecmp(extension, GPUDump::FILE_EXTENSION) == 0);
+}
+
 bool IsM3UFileName(const char* path)
 {
   const char* extension = std::strrchr(path, '.');
@@ -561,6 +904,9 @@ bool Boot(const SystemBootParameters& params)
     return true;
   }
 
+  if (!params.filename.empty() && IsGPUDumpFileName(params.filename.c_str()))
+    return BootGPUDump(params.filename.c_str());
+
   // Load CD image up and detect region.
   std::unique_ptr<CDImage> media;
   bool exe_boot = false;
@@ -696,11 +1042,57 @@ bool Boot(const SystemBootParameters& params)
     BIOS::PatchBIOSFastBoot(Bus::g_bios, Bus::BIOS_SIZE, bios_hash);
   }
 
+  // Blocks compiled last time this game was run can be compiled ahead of time while we're idle.
+  if (!s_running_game_code.empty())
+  {
+    s_block_profile_path = g_host_interface->GetUserDirectoryRelativePath(
+      "cache" FS_OSPATH_SEPARATOR_STR "blocks_%s_%s.bin", s_running_game_code.c_str(), bios_hash.ToString().c_str());
+    CPU::CodeCache::LoadBlockProfile(s_block_profile_path.c_str());
+  }
+
   // Good to go.
   s_state = State::Running;
   return true;
 }
 
+bool BootGPUDump(const char* filename)
+{
+  std::unique_ptr<GPUDump::Player> player = GPUDump::Player::Open(filename);
+  if (!player)
+  {
+    g_host_interface->ReportFormattedError("Failed to load GPU dump '%s'", filename);
+    Shutdown();
+    return false;
+  }
+
+  // The CPU never runs, so there's no need for a BIOS.
+  s_region = player->GetRegion();
+  UpdateRunningGame(filename, nullptr);
+  if (!Initialize(false))
+  {
+    Shutdown();
+    return false;
+  }
+
+  UpdateControllers();
+  UpdateMemoryCards();
+  Reset();
+
+  g_gpu->RestoreGraphicsAPIState();
+  const bool state_loaded = player->LoadInitialState();
+  g_gpu->ResetGraphicsAPIState();
+  if (!state_loaded)
+  {
+    g_host_interface->ReportFormattedError("Failed to load GPU dump '%s'", filename);
+    Shutdown();
+    return false;
+  }
+
+  s_gpu_dump_player = std::move(player);
+  s_state = State::Running;
+  return true;
+}
+
 bool Initialize(bool force_software_renderer)
 {
   g_ticks_per_second = ScaleTicksToOverclock(MASTER_CLOCK);
@@ -761,6 +1153,7 @@ bool Initialize(bool force_software_renderer)
   }
 
   UpdateThrottlePeriod();
+  UpdateRewindSettings();
   return true;
 }
 
@@ -778,6 +1171,11 @@ void Shutdown()
   g_gpu.reset();
   g_interrupt_controller.Shutdown();
   g_dma.Shutdown();
+  if (!s_block_profile_path.empty())
+  {
+    CPU::CodeCache::SaveBlockProfile(s_block_profile_path.c_str());
+    s_block_profile_path.clear();
+  }
   CPU::CodeCache::Shutdown();
   Bus::Shutdown();
   CPU::Shutdown();
@@ -788,6 +1186,11 @@ void Shutdown()
   s_media_playlist.clear();
   s_media_playlist_filename.clear();
   s_cheat_list.reset();
+  s_gpu_dump_player.reset();
+  s_rewinding = false;
+  ClearRewindStates();
+  s_rewind_stream.reset();
+  s_runahead_stream.reset();
   s_state = State::Shutdown;
 }
 
@@ -829,7 +1232,25 @@ bool CreateGPU(GPURenderer renderer)
   return true;
 }
 
-bool DoState(StateWrapper& sw, bool update_display)
+/// Serializes one component behind its marker, logging the number of bytes and time it took.
+template<typename T>
+static bool DoComponentState(StateWrapper& sw, const char* name, const T& callback)
+{
+  // Rewind and runahead save states every frame, so don't time them unless it's going to be logged.
+  if (Log::GetFilterLevel() < LOGLEVEL_PROFILE)
+    return (sw.DoMarker(name) && callback());
+
+  Common::Timer timer;
+  const u64 start_position = sw.GetStream()->GetPosition();
+  if (!sw.DoMarker(name) || !callback())
+    return false;
+
+  Log_ProfilePrintf("%s %s: %" PRIu64 " bytes in %.3f ms", sw.IsReading() ? "Loaded" : "Saved", name,
+                    sw.GetStream()->GetPosition() - start_position, timer.GetTimeMilliseconds());
+  return true;
+}
+
+bool DoState(StateWrapper& sw, bool update_display, bool is_memory_state)
 {
   if (!sw.DoMarker("System"))
     return false;
@@ -838,46 +1259,53 @@ bool DoState(StateWrapper& sw, bool update_display)
   sw.Do(&s_frame_number);
   sw.Do(&s_internal_frame_number);
 
-  if (!sw.DoMarker("CPU") || !CPU::DoState(sw))
+  if (!DoComponentState(sw, "CPU", [&sw]() { return CPU::DoState(sw); }))
     return false;
 
   if (sw.IsReading())
-    CPU::CodeCache::Flush();
+  {
+    // Memory states are loaded frequently, so revalidate existing blocks instead of throwing them away.
+    if (is_memory_state)
+      CPU::CodeCache::InvalidateAll();
+    else
+      CPU::CodeCache::Flush();
+  }
 
-  if (!sw.DoMarker("Bus") || !Bus::DoState(sw))
+  if (!DoComponentState(sw, "Bus", [&sw]() { return Bus::DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("DMA") || !g_dma.DoState(sw))
+  if (!DoComponentState(sw, "DMA", [&sw]() { return g_dma.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("InterruptController") || !g_interrupt_controller.DoState(sw))
+  if (!DoComponentState(sw, "InterruptController", [&sw]() { return g_interrupt_controller.DoState(sw); }))
     return false;
 
   g_gpu->RestoreGraphicsAPIState();
-  const bool gpu_result = sw.DoMarker("GPU") && g_gpu->DoState(sw, update_display);
+  const bool gpu_result =
+    DoComponentState(sw, "GPU", [&sw, update_display]() { return g_gpu->DoState(sw, update_display); });
   g_gpu->ResetGraphicsAPIState();
   if (!gpu_result)
     return false;
 
-  if (!sw.DoMarker("CDROM") || !g_cdrom.DoState(sw))
+  if (!DoComponentState(sw, "CDROM", [&sw]() { return g_cdrom.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("Pad") || !g_pad.DoState(sw))
+  if (!DoComponentState(sw, "Pad", [&sw]() { return g_pad.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("Timers") || !g_timers.DoState(sw))
+  if (!DoComponentState(sw, "Timers", [&sw]() { return g_timers.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("SPU") || !g_spu.DoState(sw))
+  if (!DoComponentState(sw, "SPU", [&sw]() { return g_spu.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("MDEC") || !g_mdec.DoState(sw))
+  if (!DoComponentState(sw, "MDEC", [&sw]() { return g_mdec.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("SIO") || !g_sio.DoState(sw))
+  if (!DoComponentState(sw, "SIO", [&sw]() { return g_sio.DoState(sw); }))
     return false;
 
-  if (!sw.DoMarker("Events") || !TimingEvents::DoState(sw))
+  if (!DoComponentState(sw, "Events", [&sw]() { return TimingEvents::DoState(sw); }))
     return false;
 
   if (!sw.DoMarker("Overclock"))
@@ -931,6 +1359,7 @@ void Reset()
   s_internal_frame_number = 0;
   TimingEvents::Reset();
   ResetPerformanceCounters();
+  ClearRewindStates();
 
   g_gpu->ResetGraphicsAPIState();
 }
@@ -940,6 +1369,12 @@ bool LoadState(ByteStream* state, bool update_display)
   if (IsShutdown())
     return false;
 
+  if (s_gpu_dump_player)
+  {
+    Log_ErrorPrintf("Save states can't be used while playing back a GPU dump");
+    return false;
+  }
+
   return DoLoadState(state, false, update_display);
 }
 
@@ -1064,7 +1499,8 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
       UpdateMemoryCards();
   }
 
-  if (header.data_compression_type != 0)
+  if (header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE &&
+      header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_DEFLATE)
   {
     g_host_interface->ReportFormattedError("Unknown save state compression type %u", header.data_compression_type);
     return false;
@@ -1073,9 +1509,52 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
   if (!state->SeekAbsolute(header.offset_to_data))
     return false;
 
-  StateWrapper sw(state, StateWrapper::Mode::Read, header.version);
-  if (!DoState(sw, update_display))
-    return false;
+  if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_DEFLATE)
+  {
+    if (const void* compressed_data = state->ReadDirect(header.data_compressed_size); compressed_data)
+    {
+      // The whole state is in memory, so the chunks can be inflated in parallel.
+      std::unique_ptr<u8[]> data(new u8[header.data_uncompressed_size]);
+      if (!DecompressStateData(static_cast<const u8*>(compressed_data), header.data_compressed_size, data.get(),
+                               header.data_uncompressed_size))
+      {
+        g_host_interface->ReportFormattedError("Failed to decompress save state data");
+        return false;
+      }
+
+      std::unique_ptr<ByteStream> data_stream =
+        ByteStream_CreateReadOnlyMemoryStream(data.get(), header.data_uncompressed_size);
+      StateWrapper sw(data_stream.get(), StateWrapper::Mode::Read, header.version);
+      if (!DoState(sw, update_display, false))
+        return false;
+    }
+    else
+    {
+      StateDataDecompressStream data_stream(state, header.data_uncompressed_size);
+      if (!data_stream.Open(header.data_compressed_size))
+      {
+        g_host_interface->ReportFormattedError("Failed to decompress save state data");
+        return false;
+      }
+
+      StateWrapper sw(&data_stream, StateWrapper::Mode::Read, header.version);
+      if (!DoState(sw, update_display, false))
+      {
+        if (data_stream.InErrorState())
+          g_host_interface->ReportFormattedError("Failed to decompress save state data");
+
+        return false;
+      }
+    }
+  }
+  else
+  {
+    StateWrapper sw(state, StateWrapper::Mode::Read, header.version);
+    if (!DoState(sw, update_display, false))
+      return false;
+  }
+
+  ClearRewindStates();
 
   if (s_state == State::Starting)
     s_state = State::Running;
@@ -1083,11 +1562,61 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
   return true;
 }
 
-bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
+bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */, bool compress /* = false */)
+{
+  SaveStateBuffer buffer;
+  return SaveStateToBuffer(&buffer, screenshot_size) && WriteSaveStateBuffer(state, buffer, compress);
+}
+
+bool SaveStateToBuffer(SaveStateBuffer* buffer, u32 screenshot_size /* = 128 */)
 {
   if (IsShutdown())
     return false;
 
+  if (s_gpu_dump_player)
+  {
+    Log_ErrorPrintf("Save states can't be used while playing back a GPU dump");
+    return false;
+  }
+
+  buffer->title = s_running_game_title;
+  buffer->game_code = s_running_game_code;
+  buffer->media_filename = g_cdrom.HasMedia() ? g_cdrom.GetMediaFileName() : std::string();
+  buffer->playlist_filename = s_media_playlist_filename;
+
+  // save screenshot
+  buffer->screenshot_data.clear();
+  buffer->screenshot_width = 0;
+  buffer->screenshot_height = 0;
+  if (screenshot_size > 0 &&
+      g_host_interface->GetDisplay()->WriteDisplayTextureToBuffer(&buffer->screenshot_data, screenshot_size,
+                                                                  screenshot_size) &&
+      !buffer->screenshot_data.empty())
+  {
+    buffer->screenshot_width = screenshot_size;
+    buffer->screenshot_height = screenshot_size;
+  }
+
+  if (!buffer->state_stream)
+    buffer->state_stream = ByteStream_CreateGrowableMemoryStream(nullptr, MAX_SAVE_STATE_SIZE);
+  else
+    buffer->state_stream->SeekAbsolute(0);
+
+  g_gpu->RestoreGraphicsAPIState();
+
+  StateWrapper sw(buffer->state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  const bool result = DoState(sw, false, false);
+
+  g_gpu->ResetGraphicsAPIState();
+
+  return result;
+}
+
+bool WriteSaveStateBuffer(ByteStream* state, const SaveStateBuffer& buffer, bool compress)
+{
+  if (!buffer.state_stream)
+    return false;
+
   SAVE_STATE_HEADER header = {};
 
   const u64 header_position = state->GetPosition();
@@ -1097,59 +1626,51 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
   // fill in header
   header.magic = SAVE_STATE_MAGIC;
   header.version = SAVE_STATE_VERSION;
-  StringUtil::Strlcpy(header.title, s_running_game_title.c_str(), sizeof(header.title));
-  StringUtil::Strlcpy(header.game_code, s_running_game_code.c_str(), sizeof(header.game_code));
+  StringUtil::Strlcpy(header.title, buffer.title.c_str(), sizeof(header.title));
+  StringUtil::Strlcpy(header.game_code, buffer.game_code.c_str(), sizeof(header.game_code));
 
-  if (g_cdrom.HasMedia())
+  if (!buffer.media_filename.empty())
   {
-    const std::string& media_filename = g_cdrom.GetMediaFileName();
     header.offset_to_media_filename = static_cast<u32>(state->GetPosition());
-    header.media_filename_length = static_cast<u32>(media_filename.length());
-    if (!media_filename.empty() && !state->Write2(media_filename.data(), header.media_filename_length))
+    header.media_filename_length = static_cast<u32>(buffer.media_filename.length());
+    if (!state->Write2(buffer.media_filename.data(), header.media_filename_length))
       return false;
   }
 
-  if (!s_media_playlist_filename.empty())
+  if (!buffer.playlist_filename.empty())
   {
     header.offset_to_playlist_filename = static_cast<u32>(state->GetPosition());
-    header.playlist_filename_length = static_cast<u32>(s_media_playlist_filename.length());
-    if (!state->Write2(s_media_playlist_filename.data(), header.playlist_filename_length))
+    header.playlist_filename_length = static_cast<u32>(buffer.playlist_filename.length());
+    if (!state->Write2(buffer.playlist_filename.data(), header.playlist_filename_length))
       return false;
   }
 
-  // save screenshot
-  if (screenshot_size > 0)
+  if (!buffer.screenshot_data.empty())
   {
-    std::vector<u32> screenshot_buffer;
-    if (g_host_interface->GetDisplay()->WriteDisplayTextureToBuffer(&screenshot_buffer, screenshot_size,
-                                                                    screenshot_size) &&
-        !screenshot_buffer.empty())
-    {
-      header.offset_to_screenshot = static_cast<u32>(state->GetPosition());
-      header.screenshot_width = screenshot_size;
-      header.screenshot_height = screenshot_size;
-      header.screenshot_size = static_cast<u32>(screenshot_buffer.size() * sizeof(u32));
-      if (!state->Write2(screenshot_buffer.data(), header.screenshot_size))
-        return false;
-    }
+    header.offset_to_screenshot = static_cast<u32>(state->GetPosition());
+    header.screenshot_width = buffer.screenshot_width;
+    header.screenshot_height = buffer.screenshot_height;
+    header.screenshot_size = static_cast<u32>(buffer.screenshot_data.size() * sizeof(u32));
+    if (!state->Write2(buffer.screenshot_data.data(), header.screenshot_size))
+      return false;
   }
 
   // write data
+  header.offset_to_data = static_cast<u32>(state->GetPosition());
+  header.data_uncompressed_size = static_cast<u32>(buffer.state_stream->GetPosition());
+  if (compress)
   {
-    header.offset_to_data = static_cast<u32>(state->GetPosition());
-
-    g_gpu->RestoreGraphicsAPIState();
-
-    StateWrapper sw(state, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
-    const bool result = DoState(sw, false);
-
-    g_gpu->ResetGraphicsAPIState();
-
-    if (!result)
+    header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_DEFLATE;
+    if (!CompressStateData(buffer.state_stream->GetMemoryPointer(), header.data_uncompressed_size, state))
       return false;
 
-    header.data_compression_type = 0;
-    header.data_uncompressed_size = static_cast<u32>(state->GetPosition() - header.offset_to_data);
+    header.data_compressed_size = static_cast<u32>(state->GetPosition() - header.offset_to_data);
+  }
+  else
+  {
+    header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
+    if (!state->Write2(buffer.state_stream->GetMemoryPointer(), header.data_uncompressed_size))
+      return false;
   }
 
   // re-write header
@@ -1163,12 +1684,171 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
   return true;
 }
 
+void StartStateChunkWorkers()
+{
+  if (!s_state_chunk_workers)
+    s_state_chunk_workers = std::make_unique<StateChunkWorkers>();
+}
+
+void StopStateChunkWorkers()
+{
+  s_state_chunk_workers.reset();
+}
+
+void ForEachStateChunk(u32 chunk_count, const std::function<void(u32)>& func)
+{
+  if (s_state_chunk_workers)
+  {
+    s_state_chunk_workers->ForEachChunk(chunk_count, func);
+    return;
+  }
+
+  for (u32 chunk = 0; chunk < chunk_count; chunk++)
+    func(chunk);
+}
+
+bool CompressStateData(const u8* data, u32 size, ByteStream* stream)
+{
+  Common::Timer timer;
+
+  const u32 chunk_count =
+    (size + SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE - 1) / SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE;
+  std::vector<std::vector<u8>> chunks(chunk_count);
+  std::atomic_bool result{true};
+  ForEachStateChunk(chunk_count, [data, size, &chunks, &result](u32 chunk) {
+    const u32 offset = chunk * SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE;
+    const u32 chunk_size = std::min(size - offset, static_cast<u32>(SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE));
+
+    uLongf compressed_size = compressBound(chunk_size);
+    chunks[chunk].resize(compressed_size);
+    if (compress2(chunks[chunk].data(), &compressed_size, data + offset, chunk_size, Z_BEST_SPEED) != Z_OK)
+      result = false;
+    chunks[chunk].resize(compressed_size);
+  });
+
+  if (!result || !stream->Write2(&chunk_count, sizeof(chunk_count)))
+    return false;
+
+  for (const std::vector<u8>& chunk : chunks)
+  {
+    const u32 chunk_size = static_cast<u32>(chunk.size());
+    if (!stream->Write2(&chunk_size, sizeof(chunk_size)))
+      return false;
+  }
+
+  for (const std::vector<u8>& chunk : chunks)
+  {
+    if (!stream->Write2(chunk.data(), static_cast<u32>(chunk.size())))
+      return false;
+  }
+
+  Log_DevPrintf("Compressed %u bytes of state data in %u chunks in %.2f ms", size, chunk_count,
+                timer.GetTimeMilliseconds());
+  return true;
+}
+
+bool DecompressStateData(const u8* compressed_data, u32 compressed_size, u8* data, u32 size)
+{
+  Common::Timer timer;
+
+  const u32 chunk_count =
+    (size + SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE - 1) / SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE;
+  u32 stored_chunk_count;
+  if (compressed_size < sizeof(stored_chunk_count))
+    return false;
+
+  std::memcpy(&stored_chunk_count, compressed_data, sizeof(stored_chunk_count));
+  if (stored_chunk_count != chunk_count || (sizeof(u32) * (chunk_count + 1)) > compressed_size)
+    return false;
+
+  // Work out where each chunk starts up front, so they can be inflated independently.
+  std::vector<u32> chunk_sizes(chunk_count);
+  std::vector<u32> chunk_offsets(chunk_count);
+  std::memcpy(chunk_sizes.data(), compressed_data + sizeof(u32), sizeof(u32) * chunk_count);
+  u32 chunk_offset = sizeof(u32) * (chunk_count + 1);
+  for (u32 chunk = 0; chunk < chunk_count; chunk++)
+  {
+    if (chunk_sizes[chunk] > (compressed_size - chunk_offset))
+      return false;
+
+    chunk_offsets[chunk] = chunk_offset;
+    chunk_offset += chunk_sizes[chunk];
+  }
+
+  std::atomic_bool result{true};
+  ForEachStateChunk(chunk_count, [&](u32 chunk) {
+    const u32 offset = chunk * SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE;
+    const u32 chunk_size = std::min(size - offset, static_cast<u32>(SAVE_STATE_HEADER::COMPRESSION_CHUNK_SIZE));
+
+    // Chunks have to end exactly where the table says they do.
+    uLongf inflated_size = chunk_size;
+    uLong consumed_size = chunk_sizes[chunk];
+    if (uncompress2(data + offset, &inflated_size, compressed_data + chunk_offsets[chunk], &consumed_size) != Z_OK ||
+        inflated_size != chunk_size || consumed_size != chunk_sizes[chunk])
+    {
+      result = false;
+    }
+  });
+
+  Log_DevPrintf("Decompressed %u bytes of state data in %u chunks in %.2f ms", size, chunk_count,
+                timer.GetTimeMilliseconds());
+  return result;
+}
+
 void RunFrame()
 {
+  // The player's position isn't part of the save state, so dumps are played back without rewind or runahead.
+  if (s_gpu_dump_player)
+  {
+    s_frame_timer.Reset();
+    DoRunFrame();
+    return;
+  }
+
+  if (s_rewinding)
+  {
+    DoRewind();
+    return;
+  }
+
   s_frame_timer.Reset();
 
+  DoRunFrame();
+
+  if (s_rewind_save_counter >= 0)
+  {
+    if (s_rewind_save_counter == 0)
+    {
+      SaveRewindState();
+      s_rewind_save_counter = s_rewind_save_frequency;
+    }
+    else
+    {
+      s_rewind_save_counter--;
+    }
+  }
+
+  if (g_settings.runahead_frames > 0)
+    DoRunahead();
+}
+
+void DoRunFrame()
+{
   g_gpu->RestoreGraphicsAPIState();
 
+  if (s_gpu_dump_player)
+  {
+    if (!s_gpu_dump_player->Execute())
+    {
+      // Keep the last frame on screen, there's nothing sensible to run instead.
+      g_host_interface->ReportError("Failed to restart GPU dump playback, pausing.");
+      s_state = State::Paused;
+    }
+
+    g_gpu->ResetGraphicsAPIState();
+    return;
+  }
+
   switch (g_settings.cpu_execution_mode)
   {
     case CPUExecutionMode::Recompiler:
@@ -1198,6 +1878,335 @@ void RunFrame()
   g_gpu->ResetGraphicsAPIState();
 }
 
+void DoRunahead()
+{
+  // The hidden frames would be recorded before the state load stopped the dump.
+  if (g_gpu->IsDumping())
+  {
+    Log_WarningPrintf("Stopping GPU dump due to runahead");
+    g_gpu->StopDumping();
+  }
+
+  // Snapshot the real frame, run ahead with the current input, and leave the last hidden frame on the display.
+  if (!s_runahead_stream)
+    s_runahead_stream = ByteStream_CreateGrowableMemoryStream(nullptr, MAX_SAVE_STATE_SIZE);
+
+  if (!SaveMemoryState(s_runahead_stream.get()))
+  {
+    Log_ErrorPrintf("Failed to save runahead state.");
+    return;
+  }
+
+  g_spu.SetAudioOutputMuted(true);
+
+  for (u32 i = 0; i < g_settings.runahead_frames; i++)
+    DoRunFrame();
+
+  g_spu.SetAudioOutputMuted(false);
+
+  if (!s_runahead_stream->SeekAbsolute(0) || !LoadMemoryState(s_runahead_stream.get(), false))
+  {
+    // Carry on from the hidden frames rather than losing the session, but don't try again.
+    Log_ErrorPrintf("Failed to restore runahead state, disabling runahead.");
+    g_host_interface->AddOSDMessage(
+      g_host_interface->TranslateStdString("OSDMessage", "Failed to restore runahead state, runahead disabled."),
+      10.0f);
+    g_settings.runahead_frames = 0;
+  }
+}
+
+bool SaveMemoryState(GrowableMemoryByteStream* stream, DirtyPageTracker* page_tracker /* = nullptr */)
+{
+  stream->SeekAbsolute(0);
+
+  StateWrapper sw(stream, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  sw.SetPagedRegionHandler(page_tracker);
+  return DoState(sw, false, true);
+}
+
+bool LoadMemoryState(ByteStream* stream, bool update_display, DirtyPageTracker* page_tracker /* = nullptr */)
+{
+  StateWrapper sw(stream, StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  sw.SetPagedRegionHandler(page_tracker);
+  return DoState(sw, update_display, true);
+}
+
+static void EncodeRewindState(const u8* data, u32 size, std::vector<u8>* out)
+{
+  // Stream of (zero run length, literal length, literal bytes) tuples. Literal runs are only terminated by at least
+  // 8 zero bytes, so that the tuple overhead doesn't exceed the saving.
+  auto append_u32 = [out](u32 value) {
+    const size_t pos = out->size();
+    out->resize(pos + sizeof(value));
+    std::memcpy(out->data() + pos, &value, sizeof(value));
+  };
+
+  out->clear();
+
+  u32 pos = 0;
+  while (pos < size)
+  {
+    const u32 zero_start = pos;
+    for (; (pos + sizeof(u64)) <= size; pos += sizeof(u64))
+    {
+      u64 data_word;
+      std::memcpy(&data_word, data + pos, sizeof(data_word));
+      if (data_word != 0)
+        break;
+    }
+    while (pos < size && data[pos] == 0)
+      pos++;
+
+    const u32 literal_start = pos;
+    u32 zero_count = 0;
+    while (pos < size)
+    {
+      if (data[pos] != 0)
+      {
+        zero_count = 0;
+      }
+      else if (++zero_count == sizeof(u64))
+      {
+        pos -= (sizeof(u64) - 1);
+        break;
+      }
+
+      pos++;
+    }
+
+    const u32 literal_end = pos;
+    append_u32(literal_start - zero_start);
+    append_u32(literal_end - literal_start);
+
+    const size_t out_pos = out->size();
+    out->resize(out_pos + (literal_end - literal_start));
+    std::memcpy(out->data() + out_pos, data + literal_start, literal_end - literal_start);
+  }
+}
+
+static bool DecodeRewindState(const std::vector<u8>& in, u32 size, std::vector<u8>* out)
+{
+  out->resize(size);
+
+  u32 in_pos = 0;
+  u32 pos = 0;
+  while (pos < size)
+  {
+    u32 zero_count, literal_count;
+    if ((in_pos + sizeof(zero_count) + sizeof(literal_count)) > in.size())
+      return false;
+
+    std::memcpy(&zero_count, in.data() + in_pos, sizeof(zero_count));
+    std::memcpy(&literal_count, in.data() + in_pos + sizeof(zero_count), sizeof(literal_count));
+    in_pos += sizeof(zero_count) + sizeof(literal_count);
+    if ((pos + zero_count + literal_count) > size || (in_pos + literal_count) > in.size())
+      return false;
+
+    std::memset(out->data() + pos, 0, zero_count);
+    pos += zero_count;
+
+    std::memcpy(out->data() + pos, in.data() + in_pos, literal_count);
+    pos += literal_count;
+    in_pos += literal_count;
+  }
+
+  return true;
+}
+
+static bool LoadRewindState(const RewindState& rs, bool update_display)
+{
+  std::vector<u8> state_data;
+  if (!DecodeRewindState(rs.data, rs.uncompressed_size, &state_data))
+  {
+    Log_ErrorPrintf("Failed to decode rewind state.");
+    return false;
+  }
+
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream =
+    ByteStream_CreateReadOnlyMemoryStream(state_data.data(), static_cast<u32>(state_data.size()));
+  s_rewind_page_tracker.SetIncremental(!rs.keyframe);
+  if (!LoadMemoryState(stream.get(), update_display, &s_rewind_page_tracker))
+  {
+    Log_ErrorPrintf("Failed to load rewind state.");
+    s_rewind_page_tracker.Reset();
+    s_rewind_page_tracker_keyframe_id = 0;
+    return false;
+  }
+
+  if (rs.keyframe)
+    s_rewind_page_tracker_keyframe_id = rs.keyframe_id;
+
+  return true;
+}
+
+void SaveRewindState()
+{
+  Common::Timer save_timer;
+
+  if (!s_rewind_stream)
+    s_rewind_stream = ByteStream_CreateGrowableMemoryStream(nullptr, MAX_SAVE_STATE_SIZE);
+
+  // Deltas have to be relative to the newest group's keyframe, which won't be the tracker's base after rewinding
+  // past a keyframe.
+  const bool keyframe = (s_rewind_states.empty() || !s_rewind_page_tracker.HasBase() ||
+                         s_rewind_states.back().keyframe_id != s_rewind_page_tracker_keyframe_id ||
+                         s_rewind_states_since_keyframe >= REWIND_KEYFRAME_INTERVAL);
+  s_rewind_page_tracker.SetIncremental(!keyframe);
+  if (!SaveMemoryState(s_rewind_stream.get(), &s_rewind_page_tracker))
+  {
+    Log_ErrorPrintf("Failed to create rewind state.");
+    s_rewind_page_tracker.Reset();
+    s_rewind_page_tracker_keyframe_id = 0;
+    return;
+  }
+
+  const u8* data = s_rewind_stream->GetMemoryPointer();
+  const u32 size = static_cast<u32>(s_rewind_stream->GetPosition());
+
+  RewindState rs;
+  rs.uncompressed_size = size;
+  rs.keyframe = keyframe;
+  if (keyframe)
+  {
+    s_rewind_page_tracker_keyframe_id = s_rewind_next_keyframe_id++;
+    s_rewind_states_since_keyframe = 0;
+  }
+  else
+  {
+    s_rewind_states_since_keyframe++;
+  }
+  rs.keyframe_id = s_rewind_page_tracker_keyframe_id;
+
+  EncodeRewindState(data, size, &rs.data);
+  rs.data.shrink_to_fit();
+  s_rewind_memory_usage += rs.data.size();
+  s_rewind_states.push_back(std::move(rs));
+
+  // Drop whole keyframe groups from the front until we're under budget, the newest group always has to stay.
+  const u64 max_memory = static_cast<u64>(g_settings.rewind_max_memory) * 1048576u;
+  while (GetRewindMemoryUsage() > max_memory && s_rewind_states.size() > 1)
+  {
+    auto next_keyframe = std::find_if(s_rewind_states.begin() + 1, s_rewind_states.end(),
+                                      [](const RewindState& it) { return it.keyframe; });
+    if (next_keyframe == s_rewind_states.end())
+      break;
+
+    for (auto it = s_rewind_states.begin(); it != next_keyframe; ++it)
+      s_rewind_memory_usage -= it->data.size();
+    s_rewind_states.erase(s_rewind_states.begin(), next_keyframe);
+  }
+
+  Log_DevPrintf("Saved rewind state (%u bytes, %s, %u/%u pages, %zu bytes encoded) in %.2f ms, %zu states using "
+                "%" PRIu64 " bytes",
+                size, keyframe ? "keyframe" : "delta", s_rewind_page_tracker.GetDirtyPageCount(),
+                s_rewind_page_tracker.GetTotalPageCount(), s_rewind_states.back().data.size(),
+                save_timer.GetTimeMilliseconds(), s_rewind_states.size(), GetRewindMemoryUsage());
+}
+
+void DoRewind()
+{
+  s_frame_timer.Reset();
+
+  if (s_rewind_load_counter > 0)
+  {
+    s_rewind_load_counter--;
+    return;
+  }
+
+  s_rewind_load_counter = s_rewind_load_frequency;
+  if (s_rewind_states.empty())
+    return;
+
+  // Deltas need their keyframe as the page tracker's base, which means loading it first when we've crossed groups.
+  const RewindState& rs = s_rewind_states.back();
+  if (!rs.keyframe && rs.keyframe_id != s_rewind_page_tracker_keyframe_id)
+  {
+    auto keyframe = std::find_if(s_rewind_states.rbegin(), s_rewind_states.rend(),
+                                 [](const RewindState& it) { return it.keyframe; });
+    if (keyframe == s_rewind_states.rend() || keyframe->keyframe_id != rs.keyframe_id ||
+        !LoadRewindState(*keyframe, false))
+    {
+      Log_ErrorPrintf("Failed to load rewind keyframe, discarding rewind states.");
+      ClearRewindStates();
+      return;
+    }
+  }
+
+  if (!LoadRewindState(rs, true))
+  {
+    ClearRewindStates();
+    return;
+  }
+
+  // Keep the oldest state around, so that holding rewind stays at the beginning of the buffer.
+  if (s_rewind_states.size() > 1)
+  {
+    s_rewind_memory_usage -= rs.data.size();
+    s_rewind_states.pop_back();
+
+    s_rewind_states_since_keyframe = 0;
+    for (auto it = s_rewind_states.rbegin(); it != s_rewind_states.rend() && !it->keyframe; ++it)
+      s_rewind_states_since_keyframe++;
+  }
+
+  ResetPerformanceCounters();
+}
+
+void SetRewinding(bool enabled)
+{
+  if (enabled == s_rewinding || (enabled && s_rewind_save_frequency < 0))
+    return;
+
+  s_rewinding = enabled;
+  s_rewind_load_counter = 0;
+  s_rewind_save_counter = s_rewind_save_frequency;
+  ResetPerformanceCounters();
+}
+
+bool IsRewinding()
+{
+  return s_rewinding;
+}
+
+void UpdateRewindSettings()
+{
+  if (!g_settings.rewind_enable)
+  {
+    s_rewinding = false;
+    s_rewind_save_frequency = -1;
+    s_rewind_save_counter = -1;
+    s_rewind_load_frequency = -1;
+    ClearRewindStates();
+    s_rewind_stream.reset();
+    return;
+  }
+
+  const float frames = std::ceil(g_settings.rewind_save_frequency * s_throttle_frequency);
+  s_rewind_save_frequency = std::max(static_cast<s32>(frames), 1) - 1;
+  s_rewind_load_frequency = s_rewind_save_frequency / REWIND_PLAYBACK_SPEED;
+  if (s_rewind_save_counter < 0 || s_rewind_save_counter > s_rewind_save_frequency)
+    s_rewind_save_counter = s_rewind_save_frequency;
+}
+
+void ClearRewindStates()
+{
+  s_rewind_states.clear();
+  s_rewind_page_tracker.Reset();
+  s_rewind_page_tracker_keyframe_id = 0;
+  s_rewind_memory_usage = 0;
+  s_rewind_states_since_keyframe = 0;
+}
+
+u32 GetRewindStateCount()
+{
+  return static_cast<u32>(s_rewind_states.size());
+}
+
+u64 GetRewindMemoryUsage()
+{
+  return s_rewind_memory_usage + s_rewind_page_tracker.GetBaseMemoryUsage();
+}
+
 void SetTargetSpeed(float speed)
 {
   s_target_speed = speed;
@@ -1208,6 +2217,7 @@ void SetThrottleFrequency(float frequency)
 {
   s_throttle_frequency = frequency;
   UpdateThrottlePeriod();
+  UpdateRewindSettings();
 }
 
 void UpdateThrottlePeriod()
@@ -1258,12 +2268,24 @@ void Throttle()
   }
   else if (sleep_time >= MINIMUM_SLEEP_TIME)
   {
+    // Spend up to half of the idle time compiling blocks from the last session.
+    s64 remaining_sleep_time = sleep_time;
+    if (CPU::CodeCache::HasPendingProfiledBlocks())
+    {
+      CPU::CodeCache::CompileProfiledBlocks(static_cast<u64>(sleep_time / 2));
+      remaining_sleep_time =
+        static_cast<s64>(s_last_throttle_time - static_cast<u64>(s_throttle_timer.GetTimeNanoseconds()));
+    }
+
+    if (remaining_sleep_time >= MINIMUM_SLEEP_TIME)
+    {
 #ifdef WIN32
-    Sleep(static_cast<u32>(sleep_time / 1000000));
+      Sleep(static_cast<u32>(remaining_sleep_time / 1000000));
 #else
-    const struct timespec ts = {0, static_cast<long>(sleep_time)};
-    nanosleep(&ts, nullptr);
+      const struct timespec ts = {0, static_cast<long>(remaining_sleep_time)};
+      nanosleep(&ts, nullptr);
 #endif
+    }
   }
 
   s_last_throttle_time += s_throttle_period;
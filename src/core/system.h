@@ -7,8 +7,10 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class ByteStream;
+class GrowableMemoryByteStream;
 class CDImage;
 class StateWrapper;
 
@@ -33,6 +35,25 @@ struct SystemBootParameters
   bool force_software_renderer = false;
 };
 
+/// Save state captured in memory, so it can be written out later without touching the emulator.
+struct SaveStateBuffer
+{
+  SaveStateBuffer();
+  SaveStateBuffer(SaveStateBuffer&& other);
+  ~SaveStateBuffer();
+
+  SaveStateBuffer& operator=(SaveStateBuffer&& other);
+
+  std::string title;
+  std::string game_code;
+  std::string media_filename;
+  std::string playlist_filename;
+  u32 screenshot_width = 0;
+  u32 screenshot_height = 0;
+  std::vector<u32> screenshot_data;
+  std::unique_ptr<GrowableMemoryByteStream> state_stream;
+};
+
 namespace System {
 
 enum : u32
@@ -62,6 +83,9 @@ bool IsExeFileName(const char* path);
 /// Returns true if the filename is a Portable Sound Format file we can uncompress/load.
 bool IsPsfFileName(const char* path);
 
+/// Returns true if the filename is a recording of GPU commands which can be played back.
+bool IsGPUDumpFileName(const char* path);
+
 /// Returns true if the filename is a M3U Playlist we can handle.
 bool IsM3UFileName(const char* path);
 
@@ -139,13 +163,36 @@ void Reset();
 void Shutdown();
 
 bool LoadState(ByteStream* state, bool update_display = true);
-bool SaveState(ByteStream* state, u32 screenshot_size = 128);
+bool SaveState(ByteStream* state, u32 screenshot_size = 128, bool compress = false);
+
+/// Captures the current state and a screenshot into memory. Must be called on the emulation thread.
+bool SaveStateToBuffer(SaveStateBuffer* buffer, u32 screenshot_size = 128);
+
+/// Writes a captured state to a stream, optionally compressing it. Safe to call from any thread.
+bool WriteSaveStateBuffer(ByteStream* state, const SaveStateBuffer& buffer, bool compress);
+
+/// Starts/stops the threads which (de)compress save state chunks in parallel. They're owned by the host interface
+/// rather than the system, as states can still be written in the background after the system shuts down.
+void StartStateChunkWorkers();
+void StopStateChunkWorkers();
 
 /// Recreates the GPU component, saving/loading the state so it is preserved. Call when the GPU renderer changes.
 bool RecreateGPU(GPURenderer renderer, bool update_display = true);
 
 void RunFrame();
 
+/// Starts/stops rewinding, while active RunFrame() steps backwards through the rewind buffer.
+void SetRewinding(bool enabled);
+bool IsRewinding();
+
+/// Updates the rewind save interval, call when rewind settings or the refresh rate changes.
+void UpdateRewindSettings();
+
+/// Discards all states in the rewind buffer.
+void ClearRewindStates();
+u32 GetRewindStateCount();
+u64 GetRewindMemoryUsage();
+
 /// Sets target emulation speed.
 void SetTargetSpeed(float speed);
 
@@ -18,7 +18,9 @@ Timers::~Timers() = default;
 void Timers::Initialize()
 {
   m_sysclk_event = TimingEvents::CreateTimingEvent(
-    "Timer SysClk Interrupt", 1, 1, std::bind(&Timers::AddSysClkTicks, this, std::placeholders::_1), false);
+    "Timer SysClk Interrupt", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<Timers*>(param)->AddSysClkTicks(ticks); }, this,
+    false);
   Reset();
 }
 
@@ -110,7 +112,7 @@ void Timers::SetGate(u32 timer, bool state)
 TickCount Timers::GetTicksUntilIRQ(u32 timer) const
 {
   const CounterState& cs = m_states[timer];
-  if (!cs.counting_enabled)
+  if (!cs.counting_enabled || !CanRaiseIRQ(cs))
     return std::numeric_limits<TickCount>::max();
 
   TickCount ticks_until_irq = std::numeric_limits<TickCount>::max();
@@ -351,11 +353,8 @@ TickCount Timers::GetTicksUntilNextInterrupt() const
   for (u32 i = 0; i < NUM_TIMERS; i++)
   {
     const CounterState& cs = m_states[i];
-    if (!cs.counting_enabled || (i < 2 && cs.external_counting_enabled) ||
-        (!cs.mode.irq_at_target && !cs.mode.irq_on_overflow))
-    {
+    if (!cs.counting_enabled || (i < 2 && cs.external_counting_enabled) || !CanRaiseIRQ(cs))
       continue;
-    }
 
     TickCount min_ticks_for_this_timer = std::numeric_limits<TickCount>::max();
     if (cs.mode.irq_at_target && cs.counter < cs.target)
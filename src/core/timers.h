@@ -84,6 +84,12 @@ private:
     bool irq_done;
   };
 
+  /// Returns false if the counter can't raise any more interrupts until it is reconfigured.
+  static bool CanRaiseIRQ(const CounterState& cs)
+  {
+    return ((cs.mode.irq_at_target || cs.mode.irq_on_overflow) && (cs.mode.irq_repeat || !cs.irq_done));
+  }
+
   void UpdateCountingEnabled(CounterState& cs);
   void UpdateIRQ(u32 index);
 
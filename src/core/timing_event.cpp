@@ -5,12 +5,17 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
+#include <array>
+#include <cstring>
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
-static TimingEvent* s_active_events_head;
-static TimingEvent* s_active_events_tail;
+// Active events are kept in a binary min-heap ordered by downcount. The array is fixed-size so that the recompiler
+// can load the head event through a stable pointer.
+static constexpr u32 MAX_ACTIVE_EVENTS = 32;
+
+static std::array<TimingEvent*, MAX_ACTIVE_EVENTS> s_active_events;
 static TimingEvent* s_current_event = nullptr;
 static u32 s_active_event_count = 0;
 static u32 s_global_tick_counter = 0;
@@ -35,11 +40,10 @@ void Shutdown()
   Assert(s_active_event_count == 0);
 }
 
-std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
-                                               TimingEventCallback callback, bool activate)
+std::unique_ptr<TimingEvent> CreateTimingEvent(const char* name, TickCount period, TickCount interval,
+                                               TimingEventCallback callback, void* callback_param, bool activate)
 {
-  std::unique_ptr<TimingEvent> event =
-    std::make_unique<TimingEvent>(std::move(name), period, interval, std::move(callback));
+  std::unique_ptr<TimingEvent> event = std::make_unique<TimingEvent>(name, period, interval, callback, callback_param);
   if (activate)
     event->Activate();
 
@@ -51,208 +55,117 @@ void UpdateCPUDowncount()
   if (!CPU::g_state.frame_done &&
       (!CPU::HasPendingInterrupt() || g_settings.cpu_execution_mode == CPUExecutionMode::Interpreter))
   {
-    CPU::g_state.downcount = s_active_events_head->GetDowncount();
+    CPU::g_state.downcount = s_active_events[0]->GetDowncount();
   }
 }
 
 TimingEvent** GetHeadEventPtr()
 {
-  return &s_active_events_head;
+  return s_active_events.data();
 }
 
-static void SortEvent(TimingEvent* event)
+ALWAYS_INLINE static void SetHeapSlot(u32 index, TimingEvent* event)
 {
-  const TickCount event_downcount = event->m_downcount;
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
 
-  if (event->prev && event->prev->m_downcount > event_downcount)
+static u32 SiftUp(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  const TickCount event_downcount = event->m_downcount;
+  while (index > 0)
   {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_downcount > event_downcount)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_active_events_tail = event;
-
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_active_events_head);
-      s_active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_active_events_head;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    const u32 parent = (index - 1) / 2;
+    if (s_active_events[parent]->m_downcount <= event_downcount)
+      break;
+
+    SetHeapSlot(index, s_active_events[parent]);
+    index = parent;
   }
-  else if (event->next && event_downcount > event->next->m_downcount)
-  {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_downcount > current->m_downcount)
-      current = current->next;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
 
-      if (current->prev)
-        current->prev->next = event;
-      else
-        s_active_events_head = event;
+  SetHeapSlot(index, event);
+  return index;
+}
 
-      current->prev = event;
-    }
-    else
+static u32 SiftDown(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  const TickCount event_downcount = event->m_downcount;
+  for (;;)
+  {
+    u32 child = index * 2 + 1;
+    if (child >= s_active_event_count)
+      break;
+    if ((child + 1) < s_active_event_count &&
+        s_active_events[child + 1]->m_downcount < s_active_events[child]->m_downcount)
     {
-      // insert at back
-      DebugAssert(s_active_events_tail);
-      s_active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_active_events_tail;
-      s_active_events_tail = event;
+      child++;
     }
+    if (event_downcount <= s_active_events[child]->m_downcount)
+      break;
+
+    SetHeapSlot(index, s_active_events[child]);
+    index = child;
   }
+
+  SetHeapSlot(index, event);
+  return index;
 }
 
-static void AddActiveEvent(TimingEvent* event)
+static void SortEvent(TimingEvent* event)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_active_event_count++;
-
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_active_events_head;
-  while (next && event->m_downcount > next->m_downcount)
-  {
-    current = next;
-    next = next->next;
-  }
+  const u32 old_index = event->m_heap_index;
+  u32 new_index = SiftUp(old_index);
+  if (new_index == old_index)
+    new_index = SiftDown(old_index);
 
-  if (!next)
-  {
-    // new tail
-    event->prev = s_active_events_tail;
-    if (s_active_events_tail)
-    {
-      s_active_events_tail->next = event;
-      s_active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_active_events_tail = event;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
-  {
-    // new head
-    event->next = s_active_events_head;
-    s_active_events_head->prev = event;
-    s_active_events_head = event;
+  // The head's downcount changes if this event was or has become the head.
+  if (old_index == 0 || new_index == 0)
     UpdateCPUDowncount();
-  }
-  else
-  {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
-  }
 }
 
-static void RemoveActiveEvent(TimingEvent* event)
+static void AddActiveEvent(TimingEvent* event)
 {
-  DebugAssert(s_active_event_count > 0);
+  Assert(s_active_event_count < MAX_ACTIVE_EVENTS);
 
-  if (event->next)
-  {
-    event->next->prev = event->prev;
-  }
-  else
-  {
-    s_active_events_tail = event->prev;
-  }
+  const u32 index = s_active_event_count++;
+  SetHeapSlot(index, event);
+  if (SiftUp(index) == 0)
+    UpdateCPUDowncount();
+}
 
-  if (event->prev)
-  {
-    event->prev->next = event->next;
-  }
-  else
-  {
-    s_active_events_head = event->next;
-    if (s_active_events_head)
-      UpdateCPUDowncount();
-  }
+static void RemoveActiveEvent(TimingEvent* event)
+{
+  DebugAssert(s_active_event_count > 0 && s_active_events[event->m_heap_index] == event);
 
-  event->prev = nullptr;
-  event->next = nullptr;
+  const u32 index = event->m_heap_index;
+  const u32 last_index = --s_active_event_count;
+  TimingEvent* last_event = s_active_events[last_index];
+  s_active_events[last_index] = nullptr;
+  if (index == last_index)
+    return;
 
-  s_active_event_count--;
+  // move the last event into the hole, and restore the heap property
+  SetHeapSlot(index, last_event);
+  SortEvent(last_event);
 }
 
 static void SortEvents()
 {
-  std::vector<TimingEvent*> events;
-  events.reserve(s_active_event_count);
-
-  TimingEvent* next = s_active_events_head;
-  while (next)
-  {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
-  }
+  for (u32 i = s_active_event_count / 2; i > 0; i--)
+    SiftDown(i - 1);
 
-  s_active_events_head = nullptr;
-  s_active_events_tail = nullptr;
-  s_active_event_count = 0;
-
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+  if (s_active_event_count > 0)
+    UpdateCPUDowncount();
 }
 
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  for (TimingEvent* event = s_active_events_head; event; event = event->next)
+  for (u32 i = 0; i < s_active_event_count; i++)
   {
-    if (event->GetName().compare(name) == 0)
-      return event;
+    if (std::strcmp(s_active_events[i]->GetName(), name) == 0)
+      return s_active_events[i];
   }
 
   return nullptr;
@@ -266,23 +179,23 @@ void RunEvents()
   CPU::ResetPendingTicks();
   while (pending_ticks > 0)
   {
-    const TickCount time = std::min(pending_ticks, s_active_events_head->GetDowncount());
+    const TickCount time = std::min(pending_ticks, s_active_events[0]->GetDowncount());
     s_global_tick_counter += static_cast<u32>(time);
     pending_ticks -= time;
 
-    // Apply downcount to all events.
+    // Apply downcount to all events. Subtracting the same amount from every event preserves the heap order.
     // This will result in a negative downcount for those events which are late.
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (u32 i = 0; i < s_active_event_count; i++)
     {
+      TimingEvent* event = s_active_events[i];
       event->m_downcount -= time;
       event->m_time_since_last_run += time;
     }
 
     // Now we can actually run the callbacks.
-    while (s_active_events_head->m_downcount <= 0)
+    while (s_active_events[0]->m_downcount <= 0)
     {
-      // move it to the end, since that'll likely be its new position
-      TimingEvent* event = s_active_events_head;
+      TimingEvent* event = s_active_events[0];
       s_current_event = event;
 
       // Factor late time into the time for the next invocation.
@@ -291,10 +204,11 @@ void RunEvents()
       event->m_downcount += event->m_interval;
       event->m_time_since_last_run = 0;
 
+      // Move the event to its new position before running the callback, so the heap is valid if it is rescheduled.
+      SortEvent(event);
+
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
-      event->m_callback(ticks_to_execute, ticks_late);
-      if (event->m_active)
-        SortEvent(event);
+      event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
     }
   }
 
@@ -353,9 +267,11 @@ bool DoState(StateWrapper& sw)
 
     sw.Do(&s_active_event_count);
 
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (u32 i = 0; i < s_active_event_count; i++)
     {
-      sw.Do(&event->m_name);
+      TimingEvent* event = s_active_events[i];
+      std::string event_name(event->m_name);
+      sw.Do(&event_name);
       sw.Do(&event->m_downcount);
       sw.Do(&event->m_time_since_last_run);
       sw.Do(&event->m_period);
@@ -370,9 +286,10 @@ bool DoState(StateWrapper& sw)
 
 } // namespace TimingEvents
 
-TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback)
-  : m_downcount(interval), m_time_since_last_run(0), m_period(period), m_interval(interval),
-    m_callback(std::move(callback)), m_name(std::move(name)), m_active(false)
+TimingEvent::TimingEvent(const char* name, TickCount period, TickCount interval, TimingEventCallback callback,
+                         void* callback_param)
+  : m_downcount(interval), m_time_since_last_run(0), m_period(period), m_interval(interval), m_callback(callback),
+    m_callback_param(callback_param), m_name(name), m_heap_index(0), m_active(false)
 {
 }
 
@@ -408,8 +325,7 @@ void TimingEvent::Schedule(TickCount ticks)
   {
     // Event is already active, so we leave the time since last run alone, and just modify the downcount.
     // If this is a call from an IO handler for example, re-sort the event queue.
-    if (TimingEvents::s_current_event != this)
-      TimingEvents::SortEvent(this);
+    TimingEvents::SortEvent(this);
   }
 }
 
@@ -433,8 +349,7 @@ void TimingEvent::Reset()
 
   m_downcount = m_interval;
   m_time_since_last_run = 0;
-  if (TimingEvents::s_current_event != this)
-    TimingEvents::SortEvent(this);
+  TimingEvents::SortEvent(this);
 }
 
 void TimingEvent::InvokeEarly(bool force /* = false */)
@@ -449,7 +364,7 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
 
   m_downcount = pending_ticks + m_interval;
   m_time_since_last_run -= ticks_to_execute;
-  m_callback(ticks_to_execute, 0);
+  m_callback(m_callback_param, ticks_to_execute, 0);
 
   // Since we've changed the downcount, we need to re-sort the events.
   DebugAssert(TimingEvents::s_current_event != this);
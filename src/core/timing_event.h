@@ -1,23 +1,21 @@
 #pragma once
-#include <functional>
 #include <memory>
-#include <string>
-#include <vector>
 
 #include "types.h"
 
 class StateWrapper;
 
-// Event callback type. Second parameter is the number of cycles the event was executed "late".
-using TimingEventCallback = std::function<void(TickCount ticks, TickCount ticks_late)>;
+// Event callback type. Third parameter is the number of cycles the event was executed "late".
+using TimingEventCallback = void (*)(void* param, TickCount ticks, TickCount ticks_late);
 
 class TimingEvent
 {
 public:
-  TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback);
+  TimingEvent(const char* name, TickCount period, TickCount interval, TimingEventCallback callback,
+              void* callback_param);
   ~TimingEvent();
 
-  const std::string& GetName() const { return m_name; }
+  const char* GetName() const { return m_name; }
   bool IsActive() const { return m_active; }
 
   // Returns the number of ticks between each event.
@@ -56,16 +54,15 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
-
   TickCount m_downcount;
   TickCount m_time_since_last_run;
   TickCount m_period;
   TickCount m_interval;
 
   TimingEventCallback m_callback;
-  std::string m_name;
+  void* m_callback_param;
+  const char* m_name;
+  u32 m_heap_index;
   bool m_active;
 };
 
@@ -77,9 +74,9 @@ void Initialize();
 void Reset();
 void Shutdown();
 
-/// Creates a new event.
-std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
-                                               TimingEventCallback callback, bool activate);
+/// Creates a new event. The name must outlive the event, and is used to match events in save states.
+std::unique_ptr<TimingEvent> CreateTimingEvent(const char* name, TickCount period, TickCount interval,
+                                               TimingEventCallback callback, void* callback_param, bool activate);
 
 /// Serialization.
 bool DoState(StateWrapper& sw);
@@ -88,8 +85,8 @@ void RunEvents();
 
 void UpdateCPUDowncount();
 
+/// Returns a pointer to the slot holding the event with the lowest downcount, for use by the recompiler.
 TimingEvent** GetHeadEventPtr();
 
 
-
 } // namespace TimingEventManager
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "benchmark_host_display.h"
+#include "common/align.h"
+
+BenchmarkHostDisplay::BenchmarkHostDisplay() = default;
+
+BenchmarkHostDisplay::~BenchmarkHostDisplay() = default;
+
+HostDisplay::RenderAPI BenchmarkHostDisplay::GetRenderAPI() const
+{
+  return RenderAPI::None;
+}
+
+void* BenchmarkHostDisplay::GetRenderDevice() const
+{
+  return nullptr;
+}
+
+void* BenchmarkHostDisplay::GetRenderContext() const
+{
+  return nullptr;
+}
+
+bool BenchmarkHostDisplay::HasRenderDevice() const
+{
+  return true;
+}
+
+bool BenchmarkHostDisplay::HasRenderSurface() const
+{
+  return true;
+}
+
+bool BenchmarkHostDisplay::CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device)
+{
+  m_window_info = wi;
+  return true;
+}
+
+bool BenchmarkHostDisplay::InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device)
+{
+  return true;
+}
+
+bool BenchmarkHostDisplay::MakeRenderContextCurrent()
+{
+  return true;
+}
+
+bool BenchmarkHostDisplay::DoneRenderContextCurrent()
+{
+  return true;
+}
+
+void BenchmarkHostDisplay::DestroyRenderDevice() {}
+
+void BenchmarkHostDisplay::DestroyRenderSurface() {}
+
+bool BenchmarkHostDisplay::CreateResources()
+{
+  return true;
+}
+
+void BenchmarkHostDisplay::DestroyResources() {}
+
+bool BenchmarkHostDisplay::ChangeRenderWindow(const WindowInfo& wi)
+{
+  m_window_info = wi;
+  return true;
+}
+
+void BenchmarkHostDisplay::ResizeRenderWindow(s32 new_window_width, s32 new_window_height)
+{
+  m_window_info.surface_width = new_window_width;
+  m_window_info.surface_height = new_window_height;
+}
+
+bool BenchmarkHostDisplay::SupportsFullscreen() const
+{
+  return false;
+}
+
+bool BenchmarkHostDisplay::IsFullscreen()
+{
+  return false;
+}
+
+bool BenchmarkHostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, float refresh_rate)
+{
+  return false;
+}
+
+bool BenchmarkHostDisplay::SetPostProcessingChain(const std::string_view& config)
+{
+  return false;
+}
+
+std::unique_ptr<HostDisplayTexture> BenchmarkHostDisplay::CreateTexture(u32 width, u32 height, const void* data,
+                                                                        u32 data_stride, bool dynamic)
+{
+  return nullptr;
+}
+
+void BenchmarkHostDisplay::UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height,
+                                         const void* data, u32 data_stride)
+{
+}
+
+bool BenchmarkHostDisplay::DownloadTexture(const void* texture_handle, u32 x, u32 y, u32 width, u32 height,
+                                           void* out_data, u32 out_data_stride)
+{
+  return false;
+}
+
+bool BenchmarkHostDisplay::SupportsDisplayPixelFormat(HostDisplayPixelFormat format) const
+{
+  return (format != HostDisplayPixelFormat::Unknown);
+}
+
+bool BenchmarkHostDisplay::BeginSetDisplayPixels(HostDisplayPixelFormat format, u32 width, u32 height,
+                                                 void** out_buffer, u32* out_pitch)
+{
+  const u32 pitch = Common::AlignUpPow2(width * GetDisplayPixelFormatSize(format), 4);
+  const u32 required_size = height * pitch;
+  if (m_frame_buffer.size() < (required_size / 4))
+    m_frame_buffer.resize(required_size / 4);
+
+  SetDisplayTexture(m_frame_buffer.data(), format, width, height, 0, 0, width, height);
+  *out_buffer = m_frame_buffer.data();
+  *out_pitch = pitch;
+  return true;
+}
+
+void BenchmarkHostDisplay::EndSetDisplayPixels()
+{
+  // noop
+}
+
+void BenchmarkHostDisplay::SetVSync(bool enabled)
+{
+  // never throttled
+}
+
+bool BenchmarkHostDisplay::Render()
+{
+  return true;
+}
@@ -0,0 +1,414 @@
+#include "benchmark_host_interface.h"
+#include "benchmark_host_display.h"
+#include "common/audio_stream.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/md5_digest.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "core/controller.h"
+#include "core/frame_profiler.h"
+#include "core/gpu.h"
+#include "core/settings.h"
+#include "core/system.h"
+#include "scmversion/scmversion.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+Log_SetChannel(BenchmarkHostInterface);
+
+static constexpr ControllerType INPUT_CONTROLLER_TYPE = ControllerType::DigitalController;
+
+BenchmarkHostInterface::BenchmarkHostInterface() = default;
+
+BenchmarkHostInterface::~BenchmarkHostInterface() = default;
+
+bool BenchmarkHostInterface::Initialize()
+{
+  if (!HostInterface::Initialize())
+    return false;
+
+  SetUserDirectoryToProgramDirectory();
+  LoadSettings();
+  FixIncompatibleSettings(false);
+  return LoadInputScript();
+}
+
+void BenchmarkHostInterface::Shutdown()
+{
+  DestroySystem();
+  HostInterface::Shutdown();
+}
+
+void BenchmarkHostInterface::ReportError(const char* message)
+{
+  std::fprintf(stderr, "Error: %s\n", message);
+}
+
+void BenchmarkHostInterface::ReportMessage(const char* message)
+{
+  std::fprintf(stderr, "%s\n", message);
+}
+
+bool BenchmarkHostInterface::ConfirmMessage(const char* message)
+{
+  std::fprintf(stderr, "%s\n", message);
+  return true;
+}
+
+std::string BenchmarkHostInterface::GetStringSettingValue(const char* section, const char* key,
+                                                          const char* default_value /*= ""*/)
+{
+  if (!m_bios_directory.empty() && std::strcmp(section, "BIOS") == 0 && std::strcmp(key, "SearchDirectory") == 0)
+    return m_bios_directory;
+
+  return default_value;
+}
+
+std::unique_ptr<ByteStream> BenchmarkHostInterface::OpenPackageFile(const char* path, u32 flags)
+{
+  Log_ErrorPrintf("Ignoring request for package file '%s'", path);
+  return {};
+}
+
+bool BenchmarkHostInterface::AcquireHostDisplay()
+{
+  m_display = std::make_unique<BenchmarkHostDisplay>();
+  return true;
+}
+
+void BenchmarkHostInterface::ReleaseHostDisplay()
+{
+  m_display->DestroyRenderDevice();
+  m_display.reset();
+}
+
+std::unique_ptr<AudioStream> BenchmarkHostInterface::CreateAudioStream(AudioBackend backend)
+{
+  return AudioStream::CreateNullAudioStream();
+}
+
+void BenchmarkHostInterface::LoadSettings()
+{
+  // Everything runs on the emulation thread, so the time can be attributed to the component which used it.
+  g_settings = Settings();
+  g_settings.cpu_execution_mode = m_cpu_execution_mode.value_or(Settings::DEFAULT_CPU_EXECUTION_MODE);
+  g_settings.gpu_renderer = GPURenderer::Software;
+  g_settings.gpu_use_thread = false;
+  g_settings.gpu_sw_render_threads = m_render_threads;
+  g_settings.cdrom_read_thread = false;
+  g_settings.audio_backend = AudioBackend::Null;
+  g_settings.audio_use_thread = false;
+  g_settings.audio_sync_enabled = false;
+  g_settings.video_sync_enabled = false;
+  g_settings.increase_timer_resolution = false;
+  g_settings.rewind_enable = false;
+  g_settings.runahead_frames = 0;
+  g_settings.controller_types[0] = INPUT_CONTROLLER_TYPE;
+  g_settings.controller_types[1] = INPUT_CONTROLLER_TYPE;
+  g_settings.memory_card_types.fill(MemoryCardType::None);
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+  std::fprintf(stderr, "DuckStation Benchmark Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "Usage: %s [parameters] [--] [boot filename]\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -frames <count>: Number of frames to run (default 3600).\n");
+  std::fprintf(stderr, "  -bios <directory>: Directory to search for BIOS images.\n");
+  std::fprintf(stderr, "  -fastboot: Skips the BIOS intro.\n");
+  std::fprintf(stderr, "  -cpu <mode>: CPU execution mode (Interpreter, CachedInterpreter, Recompiler).\n");
+  std::fprintf(stderr, "  -renderthreads <count>: Software renderer worker threads (default 0).\n");
+  std::fprintf(stderr, "  -input <filename>: Input script, with one \"<frame> <port> <button> <down|up>\"\n"
+                       "    event per line. Lines starting with # are ignored.\n");
+  std::fprintf(stderr, "  -csv <filename>: Writes per-frame timings to the specified file.\n");
+  std::fprintf(stderr, "  -hash <md5>: Fails if the final VRAM hash does not match.\n");
+  std::fprintf(stderr, "  -dumpgpu <filename>: Records the GPU commands to the specified file. Pass\n"
+                       "    the file as the boot filename to benchmark the renderer on its own.\n");
+  std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
+                       "    parameters make up the filename. Use when the filename contains\n"
+                       "    spaces or starts with a dash.\n");
+  std::fprintf(stderr, "\n");
+}
+
+bool BenchmarkHostInterface::ParseCommandLineParameters(int argc, char* argv[])
+{
+  bool no_more_args = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!no_more_args)
+    {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+      if (CHECK_ARG("-help"))
+      {
+        PrintCommandLineHelp(argv[0]);
+        return false;
+      }
+      else if (CHECK_ARG_PARAM("-frames"))
+      {
+        const std::optional<u32> frames = StringUtil::FromChars<u32>(argv[++i]);
+        if (!frames.has_value() || frames.value() == 0)
+        {
+          Log_ErrorPrintf("Invalid frame count: '%s'", argv[i]);
+          return false;
+        }
+
+        m_frame_count = frames.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-bios"))
+      {
+        m_bios_directory = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG("-fastboot"))
+      {
+        m_fast_boot = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-cpu"))
+      {
+        m_cpu_execution_mode = Settings::ParseCPUExecutionMode(argv[++i]);
+        if (!m_cpu_execution_mode.has_value())
+        {
+          Log_ErrorPrintf("Invalid CPU execution mode: '%s'", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-renderthreads"))
+      {
+        const std::optional<u32> threads = StringUtil::FromChars<u32>(argv[++i]);
+        if (!threads.has_value() || threads.value() > Settings::MAX_GPU_SW_RENDER_THREADS)
+        {
+          Log_ErrorPrintf("Invalid render thread count: '%s'", argv[i]);
+          return false;
+        }
+
+        m_render_threads = threads.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-input"))
+      {
+        m_input_filename = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-csv"))
+      {
+        m_csv_filename = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-hash"))
+      {
+        m_expected_hash = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-dumpgpu"))
+      {
+        m_gpu_dump_filename = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG("--"))
+      {
+        no_more_args = true;
+        continue;
+      }
+      else if (argv[i][0] == '-')
+      {
+        Log_ErrorPrintf("Unknown parameter: '%s'", argv[i]);
+        return false;
+      }
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+    }
+
+    if (!m_boot_filename.empty())
+      m_boot_filename += ' ';
+    m_boot_filename += argv[i];
+  }
+
+  return true;
+}
+
+bool BenchmarkHostInterface::LoadInputScript()
+{
+  if (m_input_filename.empty())
+    return true;
+
+  std::FILE* fp = FileSystem::OpenCFile(m_input_filename.c_str(), "r");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open input script '%s'", m_input_filename.c_str());
+    return false;
+  }
+
+  char line[256];
+  u32 line_number = 0;
+  bool result = true;
+  while (std::fgets(line, sizeof(line), fp))
+  {
+    line_number++;
+
+    const char first_char = line[std::strspn(line, " \t\r\n")];
+    if (first_char == '\0' || first_char == '#')
+      continue;
+
+    u32 frame, port;
+    char button_name[64], state[16];
+    std::optional<s32> button_code;
+    if (std::sscanf(line, "%u %u %63s %15s", &frame, &port, button_name, state) == 4 &&
+        port < NUM_CONTROLLER_AND_CARD_PORTS)
+      button_code = Controller::GetButtonCodeByName(INPUT_CONTROLLER_TYPE, button_name);
+
+    const bool pressed = (std::strcmp(state, "down") == 0);
+    if (!button_code.has_value() || (!pressed && std::strcmp(state, "up") != 0))
+    {
+      Log_ErrorPrintf("Invalid input event on line %u of '%s'", line_number, m_input_filename.c_str());
+      result = false;
+      break;
+    }
+
+    m_input_events.push_back(InputEvent{frame, port, button_code.value(), pressed});
+  }
+
+  std::fclose(fp);
+
+  std::stable_sort(m_input_events.begin(), m_input_events.end(),
+                   [](const InputEvent& lhs, const InputEvent& rhs) { return lhs.frame < rhs.frame; });
+  return result;
+}
+
+void BenchmarkHostInterface::ApplyInputEvents(u32 frame)
+{
+  for (; m_next_input_event < m_input_events.size() && m_input_events[m_next_input_event].frame <= frame;
+       m_next_input_event++)
+  {
+    const InputEvent& event = m_input_events[m_next_input_event];
+    Controller* controller = System::GetController(event.port);
+    if (controller)
+      controller->SetButtonState(event.button_code, event.pressed);
+  }
+}
+
+std::string BenchmarkHostInterface::GetVRAMHash() const
+{
+  u8 digest[16];
+  MD5Digest md5;
+  md5.Update(g_gpu->GetVRAM(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+  md5.Final(digest);
+
+  std::string hash;
+  for (u8 byte : digest)
+    hash += StringUtil::StdStringFromFormat("%02x", byte);
+
+  return hash;
+}
+
+void BenchmarkHostInterface::PrintSummary(const std::vector<FrameTimes>& times) const
+{
+  FrameTimes sum = {};
+  size_t worst_frame = 0;
+  for (size_t i = 0; i < times.size(); i++)
+  {
+    sum.total_ms += times[i].total_ms;
+    sum.cpu_ms += times[i].cpu_ms;
+    sum.gpu_ms += times[i].gpu_ms;
+    sum.spu_ms += times[i].spu_ms;
+    sum.cdrom_ms += times[i].cdrom_ms;
+    if (times[i].total_ms > times[worst_frame].total_ms)
+      worst_frame = i;
+  }
+
+  const double count = static_cast<double>(times.size());
+  std::printf("Frames:        %zu\n", times.size());
+  std::printf("Average FPS:   %.2f\n", (sum.total_ms > 0.0) ? (count * 1000.0 / sum.total_ms) : 0.0);
+  std::printf("Average frame: %.3f ms\n", sum.total_ms / count);
+  std::printf("  CPU:         %.3f ms\n", sum.cpu_ms / count);
+  std::printf("  GPU:         %.3f ms\n", sum.gpu_ms / count);
+  std::printf("  SPU:         %.3f ms\n", sum.spu_ms / count);
+  std::printf("  CDROM:       %.3f ms\n", sum.cdrom_ms / count);
+  std::printf("Worst frame:   %.3f ms (frame %zu)\n", times[worst_frame].total_ms, worst_frame);
+}
+
+bool BenchmarkHostInterface::Run()
+{
+  SystemBootParameters boot_params(m_boot_filename);
+  boot_params.override_fast_boot = m_fast_boot;
+  if (!BootSystem(boot_params))
+    return false;
+
+  if (!m_gpu_dump_filename.empty() && !g_gpu->StartDumping(m_gpu_dump_filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to start dumping GPU commands to '%s'", m_gpu_dump_filename.c_str());
+    return false;
+  }
+
+  std::FILE* csv_fp = nullptr;
+  if (!m_csv_filename.empty())
+  {
+    csv_fp = FileSystem::OpenCFile(m_csv_filename.c_str(), "w");
+    if (!csv_fp)
+    {
+      Log_ErrorPrintf("Failed to open '%s' for writing", m_csv_filename.c_str());
+      return false;
+    }
+
+    std::fprintf(csv_fp, "frame,total_ms,cpu_ms,gpu_ms,spu_ms,cdrom_ms\n");
+  }
+
+  std::vector<FrameTimes> times;
+  times.reserve(m_frame_count);
+  FrameProfiler::SetEnabled(true);
+
+  for (u32 frame = 0; frame < m_frame_count && System::IsValid(); frame++)
+  {
+    ApplyInputEvents(frame);
+
+    FrameProfiler::Reset();
+    Common::Timer timer;
+    System::RunFrame();
+
+    FrameTimes ft;
+    ft.total_ms = timer.GetTimeMilliseconds();
+    ft.cpu_ms = FrameProfiler::GetTimeMilliseconds(FrameProfiler::Component::CPU);
+    ft.gpu_ms = FrameProfiler::GetTimeMilliseconds(FrameProfiler::Component::GPU);
+    ft.spu_ms = FrameProfiler::GetTimeMilliseconds(FrameProfiler::Component::SPU);
+    ft.cdrom_ms = FrameProfiler::GetTimeMilliseconds(FrameProfiler::Component::CDROM);
+    times.push_back(ft);
+
+    if (csv_fp)
+    {
+      std::fprintf(csv_fp, "%u,%.4f,%.4f,%.4f,%.4f,%.4f\n", frame, ft.total_ms, ft.cpu_ms, ft.gpu_ms, ft.spu_ms,
+                   ft.cdrom_ms);
+    }
+  }
+
+  FrameProfiler::SetEnabled(false);
+  g_gpu->StopDumping();
+  if (csv_fp)
+    std::fclose(csv_fp);
+
+  if (times.size() != m_frame_count)
+  {
+    Log_ErrorPrintf("System stopped after %zu of %u frames", times.size(), m_frame_count);
+    return false;
+  }
+
+  PrintSummary(times);
+
+  const std::string hash = GetVRAMHash();
+  std::printf("VRAM hash:     %s\n", hash.c_str());
+  if (!m_expected_hash.empty() && StringUtil::Strcasecmp(hash.c_str(), m_expected_hash.c_str()) != 0)
+  {
+    Log_ErrorPrintf("VRAM hash mismatch, expected %s", m_expected_hash.c_str());
+    return false;
+  }
+
+  return true;
+}
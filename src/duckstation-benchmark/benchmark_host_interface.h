@@ -0,0 +1,74 @@
+#pragma once
+#include "core/host_interface.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Runs a game for a fixed number of frames with no window, audio or throttling, and reports where the time went.
+class BenchmarkHostInterface final : public HostInterface
+{
+public:
+  BenchmarkHostInterface();
+  ~BenchmarkHostInterface();
+
+  bool Initialize() override;
+  void Shutdown() override;
+
+  void ReportError(const char* message) override;
+  void ReportMessage(const char* message) override;
+  bool ConfirmMessage(const char* message) override;
+
+  std::string GetStringSettingValue(const char* section, const char* key, const char* default_value = "") override;
+
+  std::unique_ptr<ByteStream> OpenPackageFile(const char* path, u32 flags) override;
+
+  /// Parses the command line. Returns false if the program should exit.
+  bool ParseCommandLineParameters(int argc, char* argv[]);
+
+  /// Boots the system and runs the benchmark. Returns false if it could not complete, or the VRAM hash mismatched.
+  bool Run();
+
+protected:
+  bool AcquireHostDisplay() override;
+  void ReleaseHostDisplay() override;
+  std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend) override;
+
+  void LoadSettings() override;
+
+private:
+  struct InputEvent
+  {
+    u32 frame;
+    u32 port;
+    s32 button_code;
+    bool pressed;
+  };
+
+  struct FrameTimes
+  {
+    double total_ms;
+    double cpu_ms;
+    double gpu_ms;
+    double spu_ms;
+    double cdrom_ms;
+  };
+
+  bool LoadInputScript();
+  void ApplyInputEvents(u32 frame);
+  void PrintSummary(const std::vector<FrameTimes>& times) const;
+  std::string GetVRAMHash() const;
+
+  std::string m_boot_filename;
+  std::string m_bios_directory;
+  std::string m_input_filename;
+  std::string m_csv_filename;
+  std::string m_expected_hash;
+  std::string m_gpu_dump_filename;
+  std::optional<CPUExecutionMode> m_cpu_execution_mode;
+  std::optional<bool> m_fast_boot;
+  u32 m_frame_count = 3600;
+  u32 m_render_threads = 0;
+
+  std::vector<InputEvent> m_input_events;
+  size_t m_next_input_event = 0;
+};
@@ -0,0 +1,17 @@
+#include "benchmark_host_interface.h"
+#include "common/log.h"
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+  // only problems go to the console, the results are printed to stdout
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_WARNING);
+
+  BenchmarkHostInterface host_interface;
+  if (!host_interface.ParseCommandLineParameters(argc, argv) || !host_interface.Initialize())
+    return EXIT_FAILURE;
+
+  const bool result = host_interface.Run();
+  host_interface.Shutdown();
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -160,6 +160,10 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
                        static_cast<u32>(CPUFastmemMode::Count), Settings::DEFAULT_CPU_FASTMEM_MODE);
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable Recompiler ICache"), "CPU",
                         "RecompilerICache", false);
+  addIntRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Recompiler Block Compile Threshold"), "CPU",
+                         "RecompilerCompileThreshold", 0, 1000, 0);
+  addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Enable Recompiler Superblocks"), "CPU",
+                        "RecompilerSuperblocks", false);
 
   addIntRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("DMA Max Slice Ticks"), "Hacks",
                          "DMAMaxSliceTicks", 100, 10000, Settings::DEFAULT_DMA_MAX_SLICE_TICKS);
@@ -175,6 +179,8 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
                          0);
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Increase Timer Resolution"), "Main",
                         "IncreaseTimerResolution", true);
+  addIntRangeTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Software Renderer Threads"), "GPU",
+                         "SWRenderThreads", 0, 16, 0);
 #ifdef WIN32
   addBooleanTweakOption(m_host_interface, m_ui.tweakOptionTable, tr("Use Blit Swap Chain"), "Display",
                         "UseBlitSwapChain", false);
@@ -192,14 +198,17 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   setBooleanTweakOption(m_ui.tweakOptionTable, 4, false);
   setChoiceTweakOption(m_ui.tweakOptionTable, 5, Settings::DEFAULT_CPU_FASTMEM_MODE);
   setBooleanTweakOption(m_ui.tweakOptionTable, 6, false);
-  setIntRangeTweakOption(m_ui.tweakOptionTable, 7, static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS));
-  setIntRangeTweakOption(m_ui.tweakOptionTable, 8, static_cast<int>(Settings::DEFAULT_DMA_HALT_TICKS));
-  setIntRangeTweakOption(m_ui.tweakOptionTable, 9, static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE));
-  setIntRangeTweakOption(m_ui.tweakOptionTable, 10, static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD));
-  setBooleanTweakOption(m_ui.tweakOptionTable, 11, false);
-  setIntRangeTweakOption(m_ui.tweakOptionTable, 12, 0);
-  setBooleanTweakOption(m_ui.tweakOptionTable, 13, true);
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 7, 0);
+  setBooleanTweakOption(m_ui.tweakOptionTable, 8, false);
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 9, static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS));
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 10, static_cast<int>(Settings::DEFAULT_DMA_HALT_TICKS));
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 11, static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE));
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 12, static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD));
+  setBooleanTweakOption(m_ui.tweakOptionTable, 13, false);
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 14, 0);
+  setBooleanTweakOption(m_ui.tweakOptionTable, 15, true);
+  setIntRangeTweakOption(m_ui.tweakOptionTable, 16, 0);
 #ifdef WIN32
-  setBooleanTweakOption(m_ui.tweakOptionTable, 14, false);
+  setBooleanTweakOption(m_ui.tweakOptionTable, 17, false);
 #endif
 }
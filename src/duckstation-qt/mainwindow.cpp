@@ -31,9 +31,9 @@
 
 static constexpr char DISC_IMAGE_FILTER[] = QT_TRANSLATE_NOOP(
   "MainWindow",
-  "All File Types (*.bin *.img *.iso *.cue *.chd *.exe *.psexe *.psf *.m3u);;Single-Track Raw Images (*.bin *.img "
-  "*.iso);;Cue Sheets (*.cue);;MAME CHD Images (*.chd);;PlayStation Executables (*.exe *.psexe);;Portable Sound Format "
-  "Files (*.psf);;Playlists (*.m3u)");
+  "All File Types (*.bin *.img *.iso *.cue *.chd *.exe *.psexe *.psf *.m3u *.psxgpu);;Single-Track Raw Images (*.bin "
+  "*.img *.iso);;Cue Sheets (*.cue);;MAME CHD Images (*.chd);;PlayStation Executables (*.exe *.psexe);;Portable Sound "
+  "Format Files (*.psf);;Playlists (*.m3u);;GPU Dumps (*.psxgpu)");
 
 ALWAYS_INLINE static QString getWindowTitle()
 {
@@ -975,6 +975,8 @@ void MainWindow::connectSignals()
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowMDECState, "Debug",
                                                "ShowMDECState");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowDMAState, "Debug", "ShowDMAState");
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowCodeCacheState, "Debug",
+                                               "ShowCodeCacheState");
 
   addThemeToMenu(tr("Default"), QStringLiteral("default"));
   addThemeToMenu(tr("Fusion"), QStringLiteral("fusion"));
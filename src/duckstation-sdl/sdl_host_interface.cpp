@@ -947,6 +947,22 @@ void SDLHostInterface::DrawQuickSettingsMenu()
 
     settings_changed |= ImGui::MenuItem("GPU on Thread", nullptr, &m_settings_copy.gpu_use_thread);
 
+    if (ImGui::BeginMenu("Software Renderer Threads"))
+    {
+      static constexpr auto thread_counts = make_array(0u, 2u, 3u, 4u, 6u, 8u);
+      for (const u32 count : thread_counts)
+      {
+        const TinyString label = (count == 0) ? TinyString("Disabled") : TinyString::FromFormat("%u Threads", count);
+        if (ImGui::MenuItem(label, nullptr, m_settings_copy.gpu_sw_render_threads == count))
+        {
+          m_settings_copy.gpu_sw_render_threads = count;
+          settings_changed = true;
+        }
+      }
+
+      ImGui::EndMenu();
+    }
+
     ImGui::EndMenu();
   }
 
@@ -1167,6 +1183,7 @@ void SDLHostInterface::DrawDebugMenu()
   settings_changed |= ImGui::MenuItem("Show Timers State", nullptr, &debug_settings.show_timers_state);
   settings_changed |= ImGui::MenuItem("Show MDEC State", nullptr, &debug_settings.show_mdec_state);
   settings_changed |= ImGui::MenuItem("Show DMA State", nullptr, &debug_settings.show_dma_state);
+  settings_changed |= ImGui::MenuItem("Show Code Cache State", nullptr, &debug_settings.show_code_cache_state);
 
   if (settings_changed)
   {
@@ -1181,6 +1198,7 @@ void SDLHostInterface::DrawDebugMenu()
     debug_settings_copy.show_timers_state = debug_settings.show_timers_state;
     debug_settings_copy.show_mdec_state = debug_settings.show_mdec_state;
     debug_settings_copy.show_dma_state = debug_settings.show_dma_state;
+    debug_settings_copy.show_code_cache_state = debug_settings.show_code_cache_state;
     RunLater([this]() { SaveAndUpdateSettings(); });
   }
 }
@@ -1378,6 +1396,7 @@ void SDLHostInterface::DrawSettingsWindow()
         }
 
         settings_changed |= ImGui::Checkbox("Output Sync", &m_settings_copy.audio_sync_enabled);
+        settings_changed |= ImGui::Checkbox("Mix On Thread", &m_settings_copy.audio_use_thread);
         settings_changed |= ImGui::Checkbox("Start Dumping On Boot", &m_settings_copy.audio_dump_on_boot);
         settings_changed |= ImGui::Checkbox("Mute CD Audio", &m_settings_copy.cdrom_mute_cd_audio);
       }
@@ -87,6 +87,8 @@ bool CommonHostInterface::Initialize()
 
 void CommonHostInterface::Shutdown()
 {
+  StopSaveStateThread();
+
   HostInterface::Shutdown();
 
 #ifdef WITH_DISCORD_PRESENCE
@@ -122,6 +124,7 @@ void CommonHostInterface::InitializeUserDirectory()
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("covers").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump/audio").c_str(), false);
+  result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump/gpu").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("inputprofiles").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("savestates").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("screenshots").c_str(), false);
@@ -424,6 +427,8 @@ bool CommonHostInterface::ParseCommandLineParameters(int argc, char* argv[],
 
 void CommonHostInterface::PollAndUpdate()
 {
+  ProcessCompletedSaveStates();
+
 #ifdef WITH_DISCORD_PRESENCE
   PollDiscordPresence();
 #endif
@@ -521,6 +526,13 @@ void CommonHostInterface::UpdateControllerInterface()
   }
 }
 
+bool CommonHostInterface::LoadState(const char* filename)
+{
+  // The state could still be on its way to disk.
+  WaitForPendingSaveStates();
+  return HostInterface::LoadState(filename);
+}
+
 bool CommonHostInterface::LoadState(bool global, s32 slot)
 {
   if (!global && (System::IsShutdown() || System::GetRunningCode().empty()))
@@ -543,14 +555,123 @@ bool CommonHostInterface::SaveState(bool global, s32 slot)
     return false;
   }
 
-  std::string save_path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(code.c_str(), slot);
-  if (!SaveState(save_path.c_str()))
+  PendingSaveState state;
+  state.path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(code.c_str(), slot);
+  state.slot = slot;
+  state.global = global;
+  state.compress = g_settings.save_state_compression;
+  state.result = false;
+  if (!System::SaveStateToBuffer(&state.buffer))
+  {
+    ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), state.path.c_str());
     return false;
+  }
 
-  OnSystemStateSaved(global, slot);
+  QueueSaveState(std::move(state));
   return true;
 }
 
+void CommonHostInterface::QueueSaveState(PendingSaveState state)
+{
+  std::unique_lock<std::mutex> lock(m_save_state_lock);
+  if (!m_save_state_thread.joinable())
+  {
+    m_save_state_thread_shutdown = false;
+    m_save_state_thread = std::thread(&CommonHostInterface::SaveStateThreadEntryPoint, this);
+  }
+
+  m_pending_save_states.push_back(std::move(state));
+  m_save_state_cv.notify_all();
+}
+
+void CommonHostInterface::SaveStateThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_lock);
+  for (;;)
+  {
+    m_save_state_cv.wait(lock, [this]() { return m_save_state_thread_shutdown || !m_pending_save_states.empty(); });
+    if (m_pending_save_states.empty())
+      break;
+
+    PendingSaveState state = std::move(m_pending_save_states.front());
+    m_pending_save_states.pop_front();
+    m_save_state_thread_busy = true;
+    lock.unlock();
+
+    Common::Timer timer;
+    std::unique_ptr<ByteStream> stream =
+      FileSystem::OpenFile(state.path.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                 BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                 BYTESTREAM_OPEN_STREAMED | BYTESTREAM_OPEN_SYNC);
+    if (stream)
+    {
+      state.result = System::WriteSaveStateBuffer(stream.get(), state.buffer, state.compress);
+      if (state.result)
+        state.result = stream->Commit();
+      else
+        stream->Discard();
+      stream.reset();
+    }
+
+    Log_DevPrintf("Wrote save state '%s' in %.2f ms", state.path.c_str(), timer.GetTimeMilliseconds());
+    state.buffer = {};
+
+    lock.lock();
+    m_completed_save_states.push_back(std::move(state));
+    m_save_state_thread_busy = false;
+    m_save_state_cv.notify_all();
+  }
+}
+
+void CommonHostInterface::WaitForPendingSaveStates()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_save_state_lock);
+    m_save_state_cv.wait(lock, [this]() { return m_pending_save_states.empty() && !m_save_state_thread_busy; });
+  }
+
+  ProcessCompletedSaveStates();
+}
+
+void CommonHostInterface::StopSaveStateThread()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_save_state_lock);
+    if (!m_save_state_thread.joinable())
+      return;
+
+    m_save_state_thread_shutdown = true;
+    m_save_state_cv.notify_all();
+  }
+
+  m_save_state_thread.join();
+  ProcessCompletedSaveStates();
+}
+
+void CommonHostInterface::ProcessCompletedSaveStates()
+{
+  std::vector<PendingSaveState> completed;
+  {
+    std::unique_lock<std::mutex> lock(m_save_state_lock);
+    if (m_completed_save_states.empty())
+      return;
+
+    completed.swap(m_completed_save_states);
+  }
+
+  for (const PendingSaveState& state : completed)
+  {
+    if (!state.result)
+    {
+      ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), state.path.c_str());
+      continue;
+    }
+
+    AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "State saved to '%s'."), state.path.c_str());
+    OnSystemStateSaved(state.global, state.slot);
+  }
+}
+
 bool CommonHostInterface::ResumeSystemFromState(const char* filename, bool boot_on_failure)
 {
   SystemBootParameters boot_params;
@@ -955,6 +1076,8 @@ void CommonHostInterface::DrawDebugWindows()
     g_mdec.DrawDebugStateWindow();
   if (g_settings.debugging.show_dma_state)
     g_dma.DrawDebugStateWindow();
+  if (g_settings.debugging.show_code_cache_state)
+    CPU::CodeCache::DrawDebugStateWindow();
 }
 
 void CommonHostInterface::DoFrameStep()
@@ -1519,6 +1642,20 @@ void CommonHostInterface::RegisterGeneralHotkeys()
                    if (pressed)
                      DoFrameStep();
                  });
+
+  RegisterHotkey(StaticString(TRANSLATABLE("Hotkeys", "General")), StaticString("Rewind"),
+                 StaticString(TRANSLATABLE("Hotkeys", "Rewind")), [this](bool pressed) {
+                   if (System::IsShutdown())
+                     return;
+
+                   if (pressed && !g_settings.rewind_enable)
+                   {
+                     AddOSDMessage(TranslateStdString("OSDMessage", "Rewinding is not enabled."), 5.0f);
+                     return;
+                   }
+
+                   System::SetRewinding(pressed);
+                 });
 }
 
 void CommonHostInterface::RegisterGraphicsHotkeys()
@@ -1574,6 +1711,17 @@ void CommonHostInterface::RegisterGraphicsHotkeys()
                    if (pressed)
                      ReloadPostProcessingShaders();
                  });
+
+  RegisterHotkey(StaticString(TRANSLATABLE("Hotkeys", "Graphics")), StaticString("ToggleGPUDump"),
+                 StaticString(TRANSLATABLE("Hotkeys", "Toggle GPU Command Dump")), [this](bool pressed) {
+                   if (pressed && System::IsValid())
+                   {
+                     if (IsDumpingGPU())
+                       StopDumpingGPU();
+                     else
+                       StartDumpingGPU();
+                   }
+                 });
 }
 
 void CommonHostInterface::RegisterSaveStateHotkeys()
@@ -2051,6 +2199,8 @@ CommonHostInterface::GetExtendedSaveStateInfo(const char* game_code, s32 slot)
 
 void CommonHostInterface::DeleteSaveStates(const char* game_code, bool resume)
 {
+  WaitForPendingSaveStates();
+
   const std::vector<SaveStateInfo> states(GetAvailableSaveStates(game_code));
   for (const SaveStateInfo& si : states)
   {
@@ -2348,6 +2498,55 @@ void CommonHostInterface::StopDumpingAudio()
   AddOSDMessage(TranslateStdString("OSDMessage", "Stopped dumping audio."), 5.0f);
 }
 
+bool CommonHostInterface::IsDumpingGPU() const
+{
+  return g_gpu && g_gpu->IsDumping();
+}
+
+bool CommonHostInterface::StartDumpingGPU(const char* filename)
+{
+  if (System::IsShutdown())
+    return false;
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const auto& code = System::GetRunningCode();
+    if (code.empty())
+    {
+      auto_filename =
+        GetUserDirectoryRelativePath("dump/gpu/%s.psxgpu", GetTimestampStringForFileName().GetCharArray());
+    }
+    else
+    {
+      auto_filename = GetUserDirectoryRelativePath("dump/gpu/%s_%s.psxgpu", code.c_str(),
+                                                   GetTimestampStringForFileName().GetCharArray());
+    }
+
+    filename = auto_filename.c_str();
+  }
+
+  if (g_gpu->StartDumping(filename))
+  {
+    AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "Started dumping GPU commands to '%s'."), filename);
+    return true;
+  }
+  else
+  {
+    AddFormattedOSDMessage(10.0f, TranslateString("OSDMessage", "Failed to start dumping GPU commands to '%s'."),
+                           filename);
+    return false;
+  }
+}
+
+void CommonHostInterface::StopDumpingGPU()
+{
+  if (System::IsShutdown() || !g_gpu->StopDumping())
+    return;
+
+  AddOSDMessage(TranslateStdString("OSDMessage", "Stopped dumping GPU commands."), 5.0f);
+}
+
 bool CommonHostInterface::SaveScreenshot(const char* filename /* = nullptr */, bool full_resolution /* = true */,
                                          bool apply_aspect_ratio /* = true */, bool compress_on_thread /* = true */)
 {
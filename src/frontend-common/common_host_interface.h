@@ -2,13 +2,17 @@
 #include "common/string.h"
 #include "core/controller.h"
 #include "core/host_interface.h"
+#include "core/system.h"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -71,7 +75,6 @@ public:
     std::vector<u32> screenshot_data;
   };
 
-  using HostInterface::LoadState;
   using HostInterface::SaveState;
 
   /// Returns the name of the frontend.
@@ -101,12 +104,19 @@ public:
   /// Parses command line parameters for all frontends.
   bool ParseCommandLineParameters(int argc, char* argv[], std::unique_ptr<SystemBootParameters>* out_boot_params);
 
+  /// Loads state from the specified filename, after any pending saves have been written.
+  bool LoadState(const char* filename) override;
+
   /// Loads the current emulation state from file. Specifying a slot of -1 loads the "resume" game state.
   bool LoadState(bool global, s32 slot);
 
   /// Saves the current emulation state to a file. Specifying a slot of -1 saves the "resume" save state.
+  /// The state is captured immediately, but compressed and written to disk in the background.
   bool SaveState(bool global, s32 slot);
 
+  /// Blocks until all queued save states have been written.
+  void WaitForPendingSaveStates();
+
   /// Loads the resume save state for the given game. Optionally boots the game anyway if loading fails.
   bool ResumeSystemFromState(const char* filename, bool boot_on_failure);
 
@@ -150,6 +160,15 @@ public:
   /// Stops dumping audio to file if it has been started.
   void StopDumpingAudio();
 
+  /// Returns true if currently dumping GPU commands.
+  bool IsDumpingGPU() const;
+
+  /// Starts dumping GPU commands to a file. If no file name is provided, one will be generated automatically.
+  bool StartDumpingGPU(const char* filename = nullptr);
+
+  /// Stops dumping GPU commands to file if it has been started.
+  void StopDumpingGPU();
+
   /// Saves a screenshot to the specified file. IF no file name is provided, one will be generated automatically.
   bool SaveScreenshot(const char* filename = nullptr, bool full_resolution = true, bool apply_aspect_ratio = true,
                       bool compress_on_thread = true);
@@ -360,6 +379,21 @@ private:
   void UpdateHotkeyInputMap(SettingsInterface& si);
   void ClearAllControllerBindings(SettingsInterface& si);
 
+  struct PendingSaveState
+  {
+    std::string path;
+    SaveStateBuffer buffer;
+    s32 slot;
+    bool global;
+    bool compress;
+    bool result;
+  };
+
+  void QueueSaveState(PendingSaveState state);
+  void SaveStateThreadEntryPoint();
+  void StopSaveStateThread();
+  void ProcessCompletedSaveStates();
+
 #ifdef WITH_DISCORD_PRESENCE
   void SetDiscordPresenceEnabled(bool enabled);
   void InitializeDiscordPresence();
@@ -372,6 +406,15 @@ private:
 
   std::unique_ptr<FrontendCommon::SaveStateSelectorUI> m_save_state_selector_ui;
 
+  // background save state writer
+  std::thread m_save_state_thread;
+  std::mutex m_save_state_lock;
+  std::condition_variable m_save_state_cv;
+  std::deque<PendingSaveState> m_pending_save_states;
+  std::vector<PendingSaveState> m_completed_save_states;
+  bool m_save_state_thread_busy = false;
+  bool m_save_state_thread_shutdown = false;
+
   // input key maps
   std::map<HostKeyCode, InputButtonHandler> m_keyboard_input_handlers;
   std::map<HostMouseButton, InputButtonHandler> m_mouse_input_handlers;